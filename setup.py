@@ -55,6 +55,34 @@ class TagsCommand(Command):
         return os.system(cmd)
     
 
+class MockOdbcCommand(Command):
+
+    description = "builds the mock ODBC driver used by the mockbench benchmarks"
+
+    user_options = []
+
+    def initialize_options(self):
+        pass
+
+    def finalize_options(self):
+        pass
+
+    def run(self):
+        from distutils.ccompiler import new_compiler
+        from distutils.sysconfig import customize_compiler
+
+        if os.name == 'nt':
+            raise DistutilsPlatformError('The mock ODBC driver is only supported with unixODBC')
+
+        compiler = new_compiler(verbose=self.verbose, dry_run=self.dry_run)
+        customize_compiler(compiler)
+
+        build   = join('build', 'mockodbc')
+        objects = compiler.compile([ join('utils', 'mockodbc', 'mockodbc.cpp') ], output_dir=build,
+                                   extra_postargs=[ '-O2', '-fPIC' ])
+        compiler.link_shared_object(objects, 'libmockodbc.so', output_dir=build, libraries=[ 'pthread' ],
+                                    target_lang='c++')
+
 
 def main():
 
@@ -96,8 +124,9 @@ def main():
 
         'url': 'http://code.google.com/p/pyodbc',
         'download_url': 'http://code.google.com/p/pyodbc/downloads/list',
-        'cmdclass': { 'version' : VersionCommand,
-                     'tags'    : TagsCommand }
+        'cmdclass': { 'version'  : VersionCommand,
+                     'tags'     : TagsCommand,
+                     'mockodbc' : MockOdbcCommand }
         }
     
     if sys.hexversion >= 0x02060000:
@@ -152,6 +181,10 @@ def get_compiler_settings(version_str):
         # What is the proper way to detect iODBC, MyODBC, unixODBC, etc.?
         settings['libraries'].append('odbc')
 
+        # clock_gettime, used by pyodbc.Stats, is in librt before glibc 2.17.
+        if sys.platform.startswith('linux'):
+            settings['libraries'].append('rt')
+
     return settings
 
 
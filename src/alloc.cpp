@@ -0,0 +1,148 @@
+// Allocation accounting for pyodbc_malloc, pyodbc_realloc, and pyodbc_free.
+//
+// Each block is preceded by a small header recording its size and category, so pyodbc_free doesn't need to be told
+// either and doesn't need to look anything up.  The live bytes and blocks of each category are updated with atomic
+// adds since blocks are allocated and freed without the GIL (by prefetch threads and while tracing, for example).
+//
+// This replaces the old PYODBC_LEAK_CHECK build, which recorded every allocation in an array that wasn't thread-safe.
+// Comparing pyodbc.allocations() before and after some work finds the same leaks, and it is cheap enough to leave on
+// in long-running services to watch for growth.
+
+#include "pyodbc.h"
+#include "wrapper.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static const char* ALLOC_CATEGORY_NAMES[ALLOC_CATEGORY_COUNT] =
+{
+    "params",
+    "colinfos",
+    "rows",
+    "freerows",
+    "rowblocks",
+    "sqlwchar",
+    "fetch",
+    "getdata",
+    "numpy",
+    "arrow",
+    "stmtcache",
+    "trace",
+    "arena",
+    "other",
+};
+
+// The header is a union so the block after it is aligned as well as malloc's.
+union AllocHeader
+{
+    struct
+    {
+        size_t size;
+        AllocCategory category;
+    } info;
+    double align_double;
+    INT64 align_int64;
+    void* align_pointer;
+};
+
+static volatile INT64 live_bytes[ALLOC_CATEGORY_COUNT];
+static volatile INT64 live_blocks[ALLOC_CATEGORY_COUNT];
+
+inline void AtomicAdd(volatile INT64* p, INT64 value)
+{
+#ifdef _WIN32
+    InterlockedExchangeAdd64((LONGLONG volatile*)p, value);
+#else
+    __sync_fetch_and_add(p, value);
+#endif
+}
+
+inline INT64 AtomicRead(volatile INT64* p)
+{
+    // A 64-bit read isn't atomic on all 32-bit platforms.
+#ifdef _WIN32
+    return InterlockedCompareExchange64((LONGLONG volatile*)p, 0, 0);
+#else
+    return __sync_fetch_and_add(p, 0);
+#endif
+}
+
+
+void* pyodbc_malloc(AllocCategory category, size_t len)
+{
+    AllocHeader* header = (AllocHeader*)malloc(sizeof(AllocHeader) + len);
+    if (header == 0)
+        return 0;
+
+    header->info.size     = len;
+    header->info.category = category;
+
+    AtomicAdd(&live_bytes[category], (INT64)len);
+    AtomicAdd(&live_blocks[category], 1);
+
+    return header + 1;
+}
+
+
+void* pyodbc_realloc(void* p, size_t len)
+{
+    I(p != 0);
+
+    AllocHeader* header = (AllocHeader*)p - 1;
+    size_t old = header->info.size;
+
+    header = (AllocHeader*)realloc(header, sizeof(AllocHeader) + len);
+    if (header == 0)
+        return 0;
+
+    header->info.size = len;
+    AtomicAdd(&live_bytes[header->info.category], (INT64)len - (INT64)old);
+
+    return header + 1;
+}
+
+
+void pyodbc_free(void* p)
+{
+    if (p == 0)
+        return;
+
+    AllocHeader* header = (AllocHeader*)p - 1;
+
+    AtomicAdd(&live_bytes[header->info.category], -(INT64)header->info.size);
+    AtomicAdd(&live_blocks[header->info.category], -1);
+
+    free(header);
+}
+
+
+void pyodbc_setcategory(void* p, AllocCategory category)
+{
+    AllocHeader* header = (AllocHeader*)p - 1;
+
+    AtomicAdd(&live_bytes[header->info.category], -(INT64)header->info.size);
+    AtomicAdd(&live_blocks[header->info.category], -1);
+
+    header->info.category = category;
+
+    AtomicAdd(&live_bytes[category], (INT64)header->info.size);
+    AtomicAdd(&live_blocks[category], 1);
+}
+
+
+PyObject* Alloc_GetCounts()
+{
+    Object result(PyDict_New());
+    if (!result)
+        return 0;
+
+    for (int i = 0; i < ALLOC_CATEGORY_COUNT; i++)
+    {
+        Object counts(Py_BuildValue("(LL)", AtomicRead(&live_bytes[i]), AtomicRead(&live_blocks[i])));
+        if (!counts || PyDict_SetItemString(result, ALLOC_CATEGORY_NAMES[i], counts) == -1)
+            return 0;
+    }
+
+    return result.Detach();
+}
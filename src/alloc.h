@@ -0,0 +1,54 @@
+#ifndef _ALLOC_H_
+#define _ALLOC_H_
+
+// Memory allocation with accounting.  Every block allocated by pyodbc_malloc is counted against a category so the live
+// bytes and blocks of each can be reported by pyodbc.allocations().  See alloc.cpp.
+//
+// Blocks allocated by pyodbc_malloc must be resized with pyodbc_realloc and freed with pyodbc_free, never realloc or
+// free.  All three are thread-safe and can be called without the GIL.
+
+// Keep ALLOC_CATEGORY_NAMES in alloc.cpp in the same order.
+enum AllocCategory
+{
+    ALLOC_PARAMS,               // Parameter types.
+    ALLOC_COLINFOS,             // Cached ColumnInfos.
+    ALLOC_ROWS,                 // Row objects.
+    ALLOC_FREEROWS,             // Deallocated Row objects kept for reuse.
+    ALLOC_ROWBLOCKS,            // Rowsets kept for lazy rows.
+    ALLOC_SQLWCHAR,             // SQL and other strings converted to SQLWCHAR.
+    ALLOC_FETCH,                // Block fetch buffers and prefetchers.
+    ALLOC_GETDATA,              // Buffers for long values read with SQLGetData.
+    ALLOC_NUMPY,                // Columns being read by fetchnumpy.
+    ALLOC_ARROW,                // Arrays being read or exported by fetcharrow.
+    ALLOC_STMTCACHE,            // Prepared statement caches.
+    ALLOC_TRACE,                // Trace ring buffers.
+    ALLOC_ARENA,                // Cursor arenas, which hold parameter values and infos, result column descriptions,
+                                // and ColumnInfos until the next execute.
+    ALLOC_OTHER,                // Output converters and connection pools.
+    ALLOC_CATEGORY_COUNT
+};
+
+void* pyodbc_malloc(AllocCategory category, size_t len);
+
+/**
+ * Resizes a block allocated by pyodbc_malloc, keeping its category.  Returns zero (leaving the block unchanged) if
+ * there isn't enough memory.
+ */
+void* pyodbc_realloc(void* p, size_t len);
+
+/**
+ * Frees a block allocated by pyodbc_malloc.  Does nothing if `p` is zero.
+ */
+void pyodbc_free(void* p);
+
+/**
+ * Moves a block allocated by pyodbc_malloc to another category.
+ */
+void pyodbc_setcategory(void* p, AllocCategory category);
+
+/**
+ * Returns a new dictionary mapping each category name to a tuple of its live bytes and blocks.
+ */
+PyObject* Alloc_GetCounts();
+
+#endif // _ALLOC_H_
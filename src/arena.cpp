@@ -0,0 +1,119 @@
+// The arena allocator used for each cursor's per-execute memory.
+//
+// Allocating is normally a pointer increment in the base chunk.  When it is full, new chunks are allocated from the
+// heap and kept on a list until the next reset, which frees them and, if they were needed, replaces the base chunk
+// with one large enough for everything allocated since the previous reset.  After the first few executes of similar
+// statements, the base chunk holds everything and a reset doesn't free anything.
+//
+// The base chunk isn't grown past MAX_BASE_SIZE so a single huge executemany doesn't leave every cursor holding on to
+// its memory.
+
+#include "pyodbc.h"
+
+struct ArenaChunk
+{
+    ArenaChunk* next;
+    size_t size;                // The bytes available after the header.
+};
+
+// The size of the header before each chunk's memory, keeping the memory aligned like Arena_Alloc's.
+static const size_t HEADER_SIZE = (sizeof(ArenaChunk) + 7) & ~(size_t)7;
+
+static const size_t MIN_CHUNK_SIZE = 4096;
+static const size_t MAX_BASE_SIZE  = 256 * 1024;
+
+inline char* ChunkData(ArenaChunk* chunk)
+{
+    return (char*)chunk + HEADER_SIZE;
+}
+
+static ArenaChunk* NewChunk(size_t size)
+{
+    ArenaChunk* chunk = (ArenaChunk*)pyodbc_malloc(ALLOC_ARENA, HEADER_SIZE + size);
+    if (chunk)
+    {
+        chunk->next = 0;
+        chunk->size = size;
+    }
+    return chunk;
+}
+
+static void FreeChunks(ArenaChunk* chunk, ArenaChunk* stop)
+{
+    while (chunk != stop)
+    {
+        ArenaChunk* next = chunk->next;
+        pyodbc_free(chunk);
+        chunk = next;
+    }
+}
+
+
+void Arena_Init(Arena& arena)
+{
+    arena.pos    = 0;
+    arena.end    = 0;
+    arena.base   = 0;
+    arena.chunks = 0;
+    arena.used   = 0;
+}
+
+
+void Arena_Free(Arena& arena)
+{
+    FreeChunks(arena.chunks, 0);
+    pyodbc_free(arena.base);
+    Arena_Init(arena);
+}
+
+
+void* Arena_Grow(Arena& arena, size_t cb)
+{
+    // Called by Arena_Alloc when the current chunk doesn't have `cb` (already aligned) bytes free.  Each new chunk is at
+    // least as large as everything allocated so far, so the number of chunks grows logarithmically.
+
+    ArenaChunk* chunk = NewChunk(max(cb, max(MIN_CHUNK_SIZE, arena.used)));
+    if (chunk == 0)
+        return 0;
+
+    chunk->next  = arena.chunks;
+    arena.chunks = chunk;
+
+    char* p = ChunkData(chunk);
+    arena.pos   = p + cb;
+    arena.end   = p + chunk->size;
+    arena.used += cb;
+    return p;
+}
+
+
+void Arena_Reset(Arena& arena)
+{
+    if (arena.chunks)
+    {
+        FreeChunks(arena.chunks, 0);
+        arena.chunks = 0;
+
+        if (arena.used <= MAX_BASE_SIZE && (arena.base == 0 || arena.base->size < arena.used))
+        {
+            // Running out of memory here only means the next execute will allocate chunks again.
+            pyodbc_free(arena.base);
+            arena.base = NewChunk(max(MIN_CHUNK_SIZE, arena.used));
+        }
+    }
+
+    arena.pos  = arena.base ? ChunkData(arena.base) : 0;
+    arena.end  = arena.base ? arena.pos + arena.base->size : 0;
+    arena.used = 0;
+}
+
+
+void Arena_Release(Arena& arena, const ArenaMark& mark)
+{
+    FreeChunks(arena.chunks, mark.chunks);
+
+    arena.chunks = mark.chunks;
+    arena.pos    = mark.pos;
+    arena.end    = mark.end;
+    arena.used   = mark.used;
+}
@@ -0,0 +1,88 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+// A simple bump allocator for memory that is only needed until a known point, such as the parameter and column
+// buffers of each execute.  Blocks are never freed individually: everything allocated since the last reset is
+// released at once.  See arena.cpp.
+
+struct ArenaChunk;
+
+struct Arena
+{
+    // The free space in the current chunk.
+    char* pos;
+    char* end;
+
+    // The chunk kept between resets, sized to hold everything allocated between the previous two resets, and the
+    // chunks allocated since the last reset because it was full, newest first.
+    ArenaChunk* base;
+    ArenaChunk* chunks;
+
+    // The bytes allocated since the last reset.
+    size_t used;
+};
+
+// A position saved by Arena_Mark.
+struct ArenaMark
+{
+    char* pos;
+    char* end;
+    ArenaChunk* chunks;
+    size_t used;
+};
+
+void Arena_Init(Arena& arena);
+
+/**
+ * Frees all of the arena's memory.  Called when the owner is deleted.
+ */
+void Arena_Free(Arena& arena);
+
+/**
+ * Releases everything allocated from the arena.  Once the arena has grown to fit the allocations made between two
+ * resets, this only resets a pointer.
+ */
+void Arena_Reset(Arena& arena);
+
+void* Arena_Grow(Arena& arena, size_t cb);
+
+/**
+ * Returns `cb` bytes aligned for any of the C types bound to ODBC, or zero if there isn't enough memory.  The memory is
+ * valid until the arena is reset or released to an earlier mark.
+ */
+inline void* Arena_Alloc(Arena& arena, size_t cb)
+{
+    cb = (cb + 7) & ~(size_t)7;
+    if ((size_t)(arena.end - arena.pos) < cb)
+        return Arena_Grow(arena, cb);
+    void* p = arena.pos;
+    arena.pos  += cb;
+    arena.used += cb;
+    return p;
+}
+
+inline ArenaMark Arena_Mark(Arena& arena)
+{
+    ArenaMark mark = { arena.pos, arena.end, arena.chunks, arena.used };
+    return mark;
+}
+
+/**
+ * Releases everything allocated since `mark` was saved.
+ */
+void Arena_Release(Arena& arena, const ArenaMark& mark);
+
+class ArenaScope
+{
+    // Releases everything allocated from an arena while the object exists, for scratch memory that is only needed by
+    // one function.
+
+    Arena& arena;
+    ArenaMark mark;
+
+public:
+    ArenaScope(Arena& a) : arena(a), mark(Arena_Mark(a)) { }
+    ~ArenaScope() { Arena_Release(arena, mark); }
+};
+
+#endif // _ARENA_H_
@@ -0,0 +1,1023 @@
+// Cursor.fetcharrow, which reads results into Apache Arrow arrays using the Arrow C Data Interface.
+//
+// Values are copied from the fetch buffer (or read with SQLGetData) directly into Arrow buffers: fixed-size values into
+// a values buffer, text and binary into offset and data buffers, and NULLs into a validity bitmap.  Unicode text is
+// converted to UTF-8 as it is copied.  No Python objects are created for values.
+//
+// The caller allocates the ArrowArray and ArrowSchema structures (pyarrow.cffi can do this) and imports the result, so
+// neither pyarrow nor the Arrow headers are needed to build or use pyodbc.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "arrowfetch.h"
+#include "cursor.h"
+#include "connection.h"
+#include "errors.h"
+#include "getdata.h"
+#include "stats.h"
+#include "dbspecific.h"
+#include "wrapper.h"
+
+// The kind of array each column is read into.  The order matches ARROW_FORMATS.
+enum
+{
+    AR_INT32,
+    AR_UINT32,
+    AR_INT64,
+    AR_UINT64,
+    AR_FLOAT64,
+    AR_BOOL,
+    AR_DATE,
+    AR_TIMESTAMP,
+    AR_TIME,
+    AR_DECIMAL,
+    AR_UTF8,
+    AR_BINARY
+};
+
+// The Arrow format strings.  Decimal formats include the precision and scale, so they are built by GetFormat.
+static const char* ARROW_FORMATS[] = { "i", "I", "l", "L", "g", "b", "tdD", "tsu:", "ttu", 0, "u", "z" };
+
+// The number of characters decimals are read as, which matches GetDataDecimal and the size decimal columns are bound
+// with.
+static const int DECIMAL_CHARS = 100;
+
+// The largest decimal precision that fits in Arrow's 128-bit decimals.  Larger decimals are returned as text.
+static const int MAX_DECIMAL_PRECISION = 38;
+
+// Text and binary arrays use 32-bit offsets, so each column's data for one fetch must be less than 2GB.
+static const Py_ssize_t MAX_DATA_SIZE = 0x7FFFFFFF;
+
+static const Py_ssize_t INITIAL_ROWS      = 1024;
+static const Py_ssize_t INITIAL_DATA_SIZE = 64 * 1024;
+
+struct ArrowColumn
+{
+    int kind;
+
+    // The C type values are read as, which is also the bound type if the column is bound (see GetBindInfo).
+    SQLSMALLINT c_type;
+
+    // The size of each element of `values`, or zero for AR_BOOL, whose values are a bitmap.  For AR_UTF8 and
+    // AR_BINARY, `values` holds 32-bit offsets into `data`, one more than the number of rows.
+    size_t itemsize;
+
+    int precision;              // AR_DECIMAL only
+    int scale;
+
+    unsigned char* validity;    // A bit per row that is 1 if the value is not NULL.
+    char* values;
+    char* data;
+    Py_ssize_t data_size;
+    Py_ssize_t data_capacity;
+
+    Py_ssize_t null_count;
+};
+
+
+static int GetArrowKind(Cursor* cur, Py_ssize_t iCol, ArrowColumn& col)
+{
+    // Returns the kind of array a column is read into, and sets the C type used to read it.  Output converters are not
+    // used, since their results could not be stored in Arrow arrays anyway.
+
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+    int kind = AR_UTF8;
+
+    switch (pinfo->sql_type)
+    {
+    case SQL_TINYINT:
+    case SQL_SMALLINT:
+    case SQL_INTEGER:
+        kind       = pinfo->is_unsigned ? AR_UINT32 : AR_INT32;
+        col.c_type = pinfo->is_unsigned ? SQL_C_ULONG : SQL_C_LONG;
+        break;
+
+    case SQL_BIGINT:
+        kind       = pinfo->is_unsigned ? AR_UINT64 : AR_INT64;
+        col.c_type = pinfo->is_unsigned ? SQL_C_UBIGINT : SQL_C_SBIGINT;
+        break;
+
+    case SQL_REAL:
+    case SQL_FLOAT:
+    case SQL_DOUBLE:
+        kind       = AR_FLOAT64;
+        col.c_type = SQL_C_DOUBLE;
+        break;
+
+    case SQL_BIT:
+        kind       = AR_BOOL;
+        col.c_type = SQL_C_BIT;
+        break;
+
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIMESTAMP:
+    case SQL_TYPE_TIME:
+        kind       = (pinfo->sql_type == SQL_TYPE_DATE) ? AR_DATE : (pinfo->sql_type == SQL_TYPE_TIME) ? AR_TIME : AR_TIMESTAMP;
+        col.c_type = SQL_C_TYPE_TIMESTAMP;
+        break;
+
+    case SQL_SS_TIME2:
+        kind       = AR_TIME;
+        col.c_type = SQL_C_BINARY;
+        break;
+
+    case SQL_DECIMAL:
+    case SQL_NUMERIC:
+    {
+        PyObject* desc = PyTuple_GET_ITEM(cur->description, iCol);
+        col.precision = (int)PyInt_AsLong(PyTuple_GET_ITEM(desc, 4));
+        col.scale     = (int)PyInt_AsLong(PyTuple_GET_ITEM(desc, 5));
+        if (col.precision >= 1 && col.precision <= MAX_DECIMAL_PRECISION && col.scale >= 0 && col.scale <= col.precision)
+            kind = AR_DECIMAL;
+        col.c_type = SQL_C_WCHAR;
+        break;
+    }
+
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+    case SQL_LONGVARBINARY:
+        kind       = AR_BINARY;
+        col.c_type = SQL_C_BINARY;
+        break;
+
+    default:
+        // Read other types as text, the same way fetchone does.  This includes types we don't recognize, which most
+        // drivers will convert.
+        col.c_type = (pinfo->c_type == SQL_C_CHAR) ? SQL_C_CHAR : SQL_C_WCHAR;
+        break;
+    }
+
+    if (kind == AR_UTF8 && pinfo->data != 0)
+        col.c_type = pinfo->c_type;
+
+    // GetBindInfo binds every type above as the C type we read it as.
+    I(pinfo->data == 0 || pinfo->c_type == col.c_type);
+
+    switch (kind)
+    {
+    case AR_INT32:
+    case AR_UINT32:
+    case AR_DATE:
+        col.itemsize = 4;
+        break;
+    case AR_BOOL:
+        col.itemsize = 0;
+        break;
+    case AR_DECIMAL:
+        col.itemsize = 16;
+        break;
+    case AR_UTF8:
+    case AR_BINARY:
+        col.itemsize = sizeof(SQLINTEGER);
+        break;
+    default:
+        col.itemsize = 8;
+        break;
+    }
+
+    return kind;
+}
+
+
+inline bool IsVarLength(const ArrowColumn& col)
+{
+    return col.kind == AR_UTF8 || col.kind == AR_BINARY;
+}
+
+
+inline void SetBit(unsigned char* bits, Py_ssize_t i, bool value)
+{
+    if (value)
+        bits[i >> 3] |= (unsigned char)(1 << (i & 7));
+    else
+        bits[i >> 3] &= (unsigned char)~(1 << (i & 7));
+}
+
+
+static void FreeColumns(ArrowColumn* cols, Py_ssize_t cCols)
+{
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        pyodbc_free(cols[i].validity);
+        pyodbc_free(cols[i].values);
+        pyodbc_free(cols[i].data);
+    }
+    pyodbc_free(cols);
+}
+
+
+static bool Resize(void* pp, size_t cbOld, size_t cbNew)
+{
+    // Replaces the buffer pointed to by `pp` with a larger one holding the same first `cbOld` bytes.
+
+    char* p = (char*)pyodbc_malloc(ALLOC_ARROW, cbNew);
+    if (p == 0)
+    {
+        PyErr_NoMemory();
+        return false;
+    }
+
+    char** pbuffer = (char**)pp;
+    if (*pbuffer)
+    {
+        memcpy(p, *pbuffer, cbOld);
+        pyodbc_free(*pbuffer);
+    }
+    *pbuffer = p;
+    return true;
+}
+
+
+static size_t ValuesSize(const ArrowColumn& col, Py_ssize_t rows)
+{
+    if (col.kind == AR_BOOL)
+        return (size_t)(rows + 7) / 8;
+    if (IsVarLength(col))
+        return col.itemsize * (size_t)(rows + 1);
+    return col.itemsize * (size_t)rows;
+}
+
+
+static bool GrowColumns(ArrowColumn* cols, Py_ssize_t cCols, Py_ssize_t rows, Py_ssize_t capacity)
+{
+    // Grows each column's validity and values buffers from `rows` to `capacity` rows.
+
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        ArrowColumn& col = cols[i];
+        if (!Resize(&col.validity, (size_t)(rows + 7) / 8, (size_t)(capacity + 7) / 8) ||
+            !Resize(&col.values, ValuesSize(col, rows), ValuesSize(col, capacity)))
+        {
+            return false;
+        }
+
+        if (IsVarLength(col) && rows == 0)
+        {
+            ((SQLINTEGER*)col.values)[0] = 0;
+            if (!Resize(&col.data, 0, INITIAL_DATA_SIZE))
+                return false;
+            col.data_capacity = INITIAL_DATA_SIZE;
+        }
+    }
+
+    return true;
+}
+
+
+static bool ReserveData(ArrowColumn& col, Py_ssize_t iCol, Py_ssize_t cb)
+{
+    // Makes sure there is room for `cb` more bytes in the column's data buffer.
+
+    if (col.data_size + cb <= col.data_capacity)
+        return true;
+
+    if (cb > MAX_DATA_SIZE - col.data_size)
+    {
+        RaiseErrorV(0, DataError, "Column %zd has more than 2GB of data.  Fetch fewer rows at a time.", iCol);
+        return false;
+    }
+
+    Py_ssize_t capacity = col.data_capacity;
+    while (capacity < col.data_size + cb)
+        capacity = (capacity > MAX_DATA_SIZE / 2) ? MAX_DATA_SIZE : (capacity * 2);
+
+    if (!Resize(&col.data, (size_t)col.data_size, (size_t)capacity))
+        return false;
+
+    col.data_capacity = capacity;
+    return true;
+}
+
+
+static bool AppendBytes(ArrowColumn& col, Py_ssize_t iCol, const char* pb, Py_ssize_t cb)
+{
+    if (!ReserveData(col, iCol, cb))
+        return false;
+    memcpy(col.data + col.data_size, pb, (size_t)cb);
+    col.data_size += cb;
+    return true;
+}
+
+
+inline bool IsHighSurrogate(unsigned int ch)
+{
+    return ch >= 0xD800 && ch <= 0xDBFF;
+}
+
+
+inline bool IsLowSurrogate(unsigned int ch)
+{
+    return ch >= 0xDC00 && ch <= 0xDFFF;
+}
+
+
+static bool AppendUTF8(ArrowColumn& col, Py_ssize_t iCol, const SQLWCHAR* pch, Py_ssize_t cch)
+{
+    // Converts `cch` characters of UTF-16 text (or UCS-4 if SQLWCHAR is 4 bytes) to UTF-8.  Unpaired surrogates are
+    // replaced with U+FFFD.  No character needs more than 4 bytes.
+
+    if (!ReserveData(col, iCol, cch * 4))
+        return false;
+
+    unsigned char* out = (unsigned char*)col.data + col.data_size;
+
+    for (Py_ssize_t i = 0; i < cch; i++)
+    {
+        unsigned int ch = (unsigned int)pch[i];
+
+        if (ch < 0x80)
+        {
+            *out++ = (unsigned char)ch;
+            continue;
+        }
+
+        if (IsHighSurrogate(ch) && i + 1 < cch && IsLowSurrogate((unsigned int)pch[i + 1]))
+        {
+            ch = 0x10000 + ((ch - 0xD800) << 10) + ((unsigned int)pch[i + 1] - 0xDC00);
+            i++;
+        }
+        else if (IsHighSurrogate(ch) || IsLowSurrogate(ch) || ch > 0x10FFFF)
+        {
+            ch = 0xFFFD;
+        }
+
+        if (ch < 0x800)
+        {
+            *out++ = (unsigned char)(0xC0 | (ch >> 6));
+        }
+        else
+        {
+            if (ch < 0x10000)
+            {
+                *out++ = (unsigned char)(0xE0 | (ch >> 12));
+            }
+            else
+            {
+                *out++ = (unsigned char)(0xF0 | (ch >> 18));
+                *out++ = (unsigned char)(0x80 | ((ch >> 12) & 0x3F));
+            }
+            *out++ = (unsigned char)(0x80 | ((ch >> 6) & 0x3F));
+        }
+        *out++ = (unsigned char)(0x80 | (ch & 0x3F));
+    }
+
+    col.data_size = (Py_ssize_t)((char*)out - col.data);
+    return true;
+}
+
+
+static bool AppendText(ArrowColumn& col, Py_ssize_t iCol, const char* pb, Py_ssize_t cb)
+{
+    // Appends `cb` bytes read as col.c_type.  Only SQL_C_WCHAR text is converted; SQL_C_CHAR text, which is only used
+    // on Python 2 when unicode_results is False, is copied as is.
+
+    if (col.c_type == SQL_C_WCHAR)
+        return AppendUTF8(col, iCol, (const SQLWCHAR*)pb, cb / (Py_ssize_t)sizeof(SQLWCHAR));
+    return AppendBytes(col, iCol, pb, cb);
+}
+
+
+static bool AppendObject(ArrowColumn& col, Py_ssize_t iCol, PyObject* value)
+{
+    // Appends a text or binary value that was too long for its bound buffer, which GetData_ReadOverflow read into a
+    // Python object.
+
+    if (PyUnicode_Check(value))
+    {
+        Object utf8(PyUnicode_AsUTF8String(value));
+        if (!utf8)
+            return false;
+        return AppendBytes(col, iCol, PyBytes_AS_STRING(utf8.Get()), PyBytes_GET_SIZE(utf8.Get()));
+    }
+
+#if PY_VERSION_HEX >= 0x02060000
+    if (PyByteArray_Check(value))
+        return AppendBytes(col, iCol, PyByteArray_AS_STRING(value), PyByteArray_GET_SIZE(value));
+#else
+    if (PyBuffer_Check(value))
+    {
+        const void* pb;
+        Py_ssize_t cb;
+        if (PyObject_AsReadBuffer(value, &pb, &cb) == -1)
+            return false;
+        return AppendBytes(col, iCol, (const char*)pb, cb);
+    }
+#endif
+
+    return AppendBytes(col, iCol, PyBytes_AS_STRING(value), PyBytes_GET_SIZE(value));
+}
+
+
+static bool ReadVarData(Cursor* cur, Py_ssize_t iCol, ArrowColumn& col, bool& fNull)
+{
+    // Appends a text or binary value read with SQLGetData in chunks.
+
+    SQLWCHAR buffer[2048];
+    char* pb = (char*)buffer;
+
+    SQLLEN cbTerminator = (col.c_type == SQL_C_WCHAR) ? sizeof(SQLWCHAR) : (col.c_type == SQL_C_CHAR) ? 1 : 0;
+
+    // When a chunk of Unicode text ends with a high surrogate, it is moved to the front of the buffer so it is
+    // converted with the low surrogate at the beginning of the next chunk.
+    SQLLEN cbCarried = 0;
+
+    fNull = false;
+
+    for (;;)
+    {
+        SQLLEN cbAvailable = (SQLLEN)sizeof(buffer) - cbCarried;
+        SQLLEN cbData = 0;
+        SQLRETURN ret;
+
+        INT64 start = Stats_Start(cur);
+        Py_BEGIN_ALLOW_THREADS
+        ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol + 1), col.c_type, pb + cbCarried, cbAvailable, &cbData);
+        Py_END_ALLOW_THREADS
+        Stats_EndCall(cur, STATS_GETDATA, start);
+        Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+        if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+        {
+            // The connection was closed by another thread in the ALLOW_THREADS block above.
+            RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+            return false;
+        }
+
+        if (ret == SQL_NO_DATA)
+            break;
+
+        if (!SQL_SUCCEEDED(ret))
+        {
+            RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+            return false;
+        }
+
+        if (cbData == SQL_NULL_DATA)
+        {
+            fNull = true;
+            return true;
+        }
+
+        bool fMore = (cbData == SQL_NO_TOTAL || cbData > cbAvailable - cbTerminator);
+        Py_ssize_t cb = cbCarried + (fMore ? (cbAvailable - cbTerminator) : cbData);
+        cbCarried = 0;
+
+        if (col.c_type == SQL_C_WCHAR && fMore && cb >= (Py_ssize_t)sizeof(SQLWCHAR) &&
+            IsHighSurrogate((unsigned int)buffer[cb / sizeof(SQLWCHAR) - 1]))
+        {
+            cb -= sizeof(SQLWCHAR);
+            cbCarried = sizeof(SQLWCHAR);
+        }
+
+        if (!AppendText(col, iCol, pb, cb))
+            return false;
+
+        if (cbCarried)
+            buffer[0] = buffer[cb / sizeof(SQLWCHAR)];
+
+        if (!fMore)
+            break;
+    }
+
+    // A high surrogate at the very end is unpaired, which AppendUTF8 replaces.
+    if (cbCarried && !AppendText(col, iCol, pb, cbCarried))
+        return false;
+
+    return true;
+}
+
+
+static bool ReadBoundVarData(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow, ArrowColumn& col, bool& fNull)
+{
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    SQLLEN cbData = pinfo->lengths[iRow];
+
+    if (cbData == SQL_NULL_DATA || (cbData < 0 && cbData != SQL_NO_TOTAL))
+    {
+        // See the FreeTDS note in GetDataString.
+        fNull = true;
+        return true;
+    }
+
+    SQLLEN cbMax = pinfo->buffer_length;
+    if (pinfo->c_type == SQL_C_WCHAR)
+        cbMax -= sizeof(SQLWCHAR);
+    else if (pinfo->c_type == SQL_C_CHAR)
+        cbMax -= 1;
+
+    if (cbData == SQL_NO_TOTAL || cbData > cbMax)
+    {
+        Object value(GetData_GetOverflow(cur->overflow_values, PyTuple_GET_SIZE(cur->description), iCol, iRow));
+        if (!value)
+        {
+            if (!PyErr_Occurred())
+                RaiseErrorV("01004", DataError, "Data for column %zd was truncated while block fetching.", iCol);
+            return false;
+        }
+
+        fNull = false;
+        return AppendObject(col, iCol, value);
+    }
+
+    fNull = false;
+    return AppendText(col, iCol, pinfo->data + iRow * pinfo->buffer_length, cbData);
+}
+
+
+static void MultiplyAdd(unsigned int* limbs, unsigned int digit)
+{
+    // Multiplies a 128-bit integer, stored as 4 32-bit limbs from least to most significant, by 10 and adds `digit`.
+
+    UINT64 carry = digit;
+    for (int i = 0; i < 4; i++)
+    {
+        UINT64 n = (UINT64)limbs[i] * 10 + carry;
+        limbs[i] = (unsigned int)(n & 0xFFFFFFFF);
+        carry = n >> 32;
+    }
+}
+
+
+static void StoreDecimal(const ArrowColumn& col, char* dst, const SQLWCHAR* pch, Py_ssize_t cch)
+{
+    // Converts the text of a decimal to Arrow's representation: a 128-bit two's complement integer scaled by the
+    // column's scale.  As in DecimalFromSQLWCHAR, characters other than digits, the decimal point, and '-' (such as
+    // group separators and currency symbols) are ignored.  Extra fractional digits are truncated.
+
+    unsigned int limbs[4] = { 0, 0, 0, 0 };
+    bool fNegative = false;
+    int digits = -1; // The number of fractional digits used, or -1 before the decimal point.
+
+    for (Py_ssize_t i = 0; i < cch; i++)
+    {
+        SQLWCHAR ch = pch[i];
+
+        if (ch == (SQLWCHAR)chDecimal && digits == -1)
+            digits = 0;
+        else if (ch == '-')
+            fNegative = true;
+        else if (ch >= '0' && ch <= '9' && digits < col.scale)
+        {
+            MultiplyAdd(limbs, (unsigned int)(ch - '0'));
+            if (digits != -1)
+                digits++;
+        }
+    }
+
+    for (int i = max(digits, 0); i < col.scale; i++)
+        MultiplyAdd(limbs, 0);
+
+    if (fNegative)
+    {
+        UINT64 carry = 1;
+        for (int i = 0; i < 4; i++)
+        {
+            UINT64 n = (UINT64)(unsigned int)~limbs[i] + carry;
+            limbs[i] = (unsigned int)(n & 0xFFFFFFFF);
+            carry = n >> 32;
+        }
+    }
+
+    // Arrow stores the two 64-bit halves least significant first.
+    UINT64 low  = ((UINT64)limbs[1] << 32) | limbs[0];
+    UINT64 high = ((UINT64)limbs[3] << 32) | limbs[2];
+    memcpy(dst, &low, sizeof(low));
+    memcpy(dst + sizeof(low), &high, sizeof(high));
+}
+
+
+static void StoreValue(const ArrowColumn& col, Py_ssize_t iValue, const void* src, SQLLEN cb)
+{
+    // Stores a non-NULL value read as col.c_type.  `cb` is the length/indicator, which is only needed for decimals.
+
+    char* dst = col.values + col.itemsize * iValue;
+
+    switch (col.kind)
+    {
+    case AR_BOOL:
+        SetBit((unsigned char*)col.values, iValue, *(const SQLCHAR*)src == SQL_TRUE);
+        break;
+
+    case AR_DATE:
+    {
+        const TIMESTAMP_STRUCT* ts = (const TIMESTAMP_STRUCT*)src;
+        SQLINTEGER days = (SQLINTEGER)DaysFromCivil(ts->year, ts->month, ts->day);
+        memcpy(dst, &days, sizeof(days));
+        break;
+    }
+
+    case AR_TIMESTAMP:
+    {
+        const TIMESTAMP_STRUCT* ts = (const TIMESTAMP_STRUCT*)src;
+        INT64 value = DaysFromCivil(ts->year, ts->month, ts->day);
+        value = ((value * 24 + ts->hour) * 60 + ts->minute) * 60 + ts->second;
+        value = value * 1000000 + ts->fraction / 1000;
+        memcpy(dst, &value, sizeof(value));
+        break;
+    }
+
+    case AR_TIME:
+    {
+        INT64 value;
+        if (col.c_type == SQL_C_BINARY)
+        {
+            const SQL_SS_TIME2_STRUCT* t = (const SQL_SS_TIME2_STRUCT*)src;
+            value = ((INT64)t->hour * 60 + t->minute) * 60 + t->second;
+            value = value * 1000000 + t->fraction / 1000;
+        }
+        else
+        {
+            const TIMESTAMP_STRUCT* ts = (const TIMESTAMP_STRUCT*)src;
+            value = ((INT64)ts->hour * 60 + ts->minute) * 60 + ts->second;
+            value = value * 1000000 + ts->fraction / 1000;
+        }
+        memcpy(dst, &value, sizeof(value));
+        break;
+    }
+
+    case AR_DECIMAL:
+        StoreDecimal(col, dst, (const SQLWCHAR*)src, (Py_ssize_t)(cb / sizeof(SQLWCHAR)));
+        break;
+
+    default:
+        memcpy(dst, src, col.itemsize);
+        break;
+    }
+}
+
+
+static bool ReadValue(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow, ArrowColumn& col, Py_ssize_t iValue)
+{
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+    bool fNull;
+
+    if (IsVarLength(col))
+    {
+        if (pinfo->data != 0 ? !ReadBoundVarData(cur, iCol, iRow, col, fNull) : !ReadVarData(cur, iCol, col, fNull))
+            return false;
+        ((SQLINTEGER*)col.values)[iValue + 1] = (SQLINTEGER)col.data_size;
+    }
+    else if (pinfo->data != 0)
+    {
+        SQLLEN ind = pinfo->lengths[iRow];
+        fNull = (ind == SQL_NULL_DATA);
+
+        if (!fNull && col.kind == AR_DECIMAL && (ind == SQL_NO_TOTAL || ind >= DECIMAL_CHARS * (SQLLEN)sizeof(SQLWCHAR)))
+        {
+            RaiseErrorV("01004", DataError, "Data for column %zd was truncated while block fetching.", iCol);
+            return false;
+        }
+
+        if (!fNull)
+            StoreValue(col, iValue, pinfo->data + iRow * pinfo->buffer_length, ind);
+    }
+    else
+    {
+        union
+        {
+            SQLINTEGER l;
+            SQLBIGINT ll;
+            double d;
+            SQLCHAR bit;
+            TIMESTAMP_STRUCT ts;
+            SQL_SS_TIME2_STRUCT t2;
+            SQLWCHAR text[DECIMAL_CHARS];
+        } value;
+
+        SQLLEN ind;
+        SQLRETURN ret;
+        INT64 start = Stats_Start(cur);
+        Py_BEGIN_ALLOW_THREADS
+        ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol + 1), col.c_type, &value, sizeof(value), &ind);
+        Py_END_ALLOW_THREADS
+        Stats_EndCall(cur, STATS_GETDATA, start);
+        Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+        if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+        {
+            // The connection was closed by another thread in the ALLOW_THREADS block above.
+            RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+            return false;
+        }
+
+        if (!SQL_SUCCEEDED(ret))
+        {
+            RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+            return false;
+        }
+
+        fNull = (ind == SQL_NULL_DATA);
+        if (!fNull)
+        {
+            if (col.kind == AR_DECIMAL && (ind == SQL_NO_TOTAL || ind >= (SQLLEN)sizeof(value.text)))
+                ind = sizeof(value.text) - sizeof(SQLWCHAR);
+            StoreValue(col, iValue, &value, ind);
+        }
+    }
+
+    if (fNull)
+    {
+        // Zero the value so NULLs don't expose uninitialized memory.
+        if (col.kind == AR_BOOL)
+            SetBit((unsigned char*)col.values, iValue, false);
+        else if (!IsVarLength(col))
+            memset(col.values + col.itemsize * iValue, 0, col.itemsize);
+        col.null_count++;
+    }
+
+    SetBit(col.validity, iValue, !fNull);
+    return true;
+}
+
+
+static char* CopyString(const char* sz, size_t len)
+{
+    char* copy = (char*)pyodbc_malloc(ALLOC_ARROW, len + 1);
+    if (copy)
+    {
+        memcpy(copy, sz, len);
+        copy[len] = 0;
+    }
+    return copy;
+}
+
+
+static char* GetFormat(const ArrowColumn& col)
+{
+    if (col.kind != AR_DECIMAL)
+        return CopyString(ARROW_FORMATS[col.kind], strlen(ARROW_FORMATS[col.kind]));
+
+    char sz[32];
+    sprintf(sz, "d:%d,%d", col.precision, col.scale);
+    return CopyString(sz, strlen(sz));
+}
+
+
+static char* GetName(Cursor* cur, Py_ssize_t iCol)
+{
+    // Returns a copy of the column's name from the description, encoded as UTF-8 as Arrow requires.
+
+    PyObject* name = PyTuple_GET_ITEM(PyTuple_GET_ITEM(cur->description, iCol), 0);
+
+    if (PyUnicode_Check(name))
+    {
+        Object utf8(PyUnicode_AsUTF8String(name));
+        if (!utf8)
+            return 0;
+        return CopyString(PyBytes_AS_STRING(utf8.Get()), (size_t)PyBytes_GET_SIZE(utf8.Get()));
+    }
+
+    return CopyString(PyBytes_AS_STRING(name), (size_t)PyBytes_GET_SIZE(name));
+}
+
+
+//
+// Export
+//
+// Every buffer, format, name, and child of an exported array or schema is allocated separately and freed by its
+// release callback.  Following the spec, the callbacks don't free the structure they are given, but the parent's
+// callback frees its children's structures.
+//
+
+static void ReleaseArray(ArrowArray* array)
+{
+    for (INT64 i = 0; i < array->n_children; i++)
+    {
+        ArrowArray* child = array->children[i];
+        if (child)
+        {
+            if (child->release)
+                child->release(child);
+            pyodbc_free(child);
+        }
+    }
+    pyodbc_free(array->children);
+
+    for (INT64 i = 0; i < array->n_buffers; i++)
+        pyodbc_free((void*)array->buffers[i]);
+    pyodbc_free(array->buffers);
+
+    array->release = 0;
+}
+
+
+static void ReleaseSchema(ArrowSchema* schema)
+{
+    for (INT64 i = 0; i < schema->n_children; i++)
+    {
+        ArrowSchema* child = schema->children[i];
+        if (child)
+        {
+            if (child->release)
+                child->release(child);
+            pyodbc_free(child);
+        }
+    }
+    pyodbc_free(schema->children);
+
+    pyodbc_free((void*)schema->format);
+    pyodbc_free((void*)schema->name);
+
+    schema->release = 0;
+}
+
+
+static bool InitArray(ArrowArray* array, INT64 length, INT64 n_buffers, INT64 n_children)
+{
+    // Initializes an array, allocating its (zeroed) buffer and child pointers.  If false is returned, the array can
+    // still be released.
+
+    memset(array, 0, sizeof(ArrowArray));
+    array->length  = length;
+    array->release = ReleaseArray;
+
+    array->buffers = (const void**)pyodbc_malloc(ALLOC_ARROW, sizeof(void*) * (size_t)n_buffers);
+    if (!array->buffers)
+        return false;
+    memset(array->buffers, 0, sizeof(void*) * (size_t)n_buffers);
+    array->n_buffers = n_buffers;
+
+    if (n_children)
+    {
+        array->children = (ArrowArray**)pyodbc_malloc(ALLOC_ARROW, sizeof(ArrowArray*) * (size_t)n_children);
+        if (!array->children)
+            return false;
+        memset(array->children, 0, sizeof(ArrowArray*) * (size_t)n_children);
+        array->n_children = n_children;
+    }
+
+    return true;
+}
+
+
+static bool InitSchema(ArrowSchema* schema, char* format, char* name, INT64 n_children)
+{
+    // Initializes a schema, taking ownership of `format` and `name`.  If false is returned, the schema can still be
+    // released.
+
+    memset(schema, 0, sizeof(ArrowSchema));
+    schema->format  = format;
+    schema->name    = name;
+    schema->flags   = ARROW_FLAG_NULLABLE;
+    schema->release = ReleaseSchema;
+
+    if (!format || !name)
+        return false;
+
+    if (n_children)
+    {
+        schema->children = (ArrowSchema**)pyodbc_malloc(ALLOC_ARROW, sizeof(ArrowSchema*) * (size_t)n_children);
+        if (!schema->children)
+            return false;
+        memset(schema->children, 0, sizeof(ArrowSchema*) * (size_t)n_children);
+        schema->n_children = n_children;
+    }
+
+    return true;
+}
+
+
+static bool ExportColumn(Cursor* cur, Py_ssize_t iCol, ArrowColumn& col, Py_ssize_t count, ArrowArray* parray, ArrowSchema* pschema)
+{
+    ArrowArray* array = (ArrowArray*)pyodbc_malloc(ALLOC_ARROW, sizeof(ArrowArray));
+    if (!array)
+        return false;
+    parray->children[iCol] = array;
+
+    ArrowSchema* schema = (ArrowSchema*)pyodbc_malloc(ALLOC_ARROW, sizeof(ArrowSchema));
+    if (!schema)
+    {
+        // The parent releases any children it has, so make sure this one can be released.
+        memset(array, 0, sizeof(ArrowArray));
+        return false;
+    }
+    pschema->children[iCol] = schema;
+
+    bool fArray  = InitArray(array, count, IsVarLength(col) ? 3 : 2, 0);
+    bool fSchema = InitSchema(schema, GetFormat(col), GetName(cur, iCol), 0);
+    if (!fArray || !fSchema)
+        return false;
+
+    // The buffers now belong to the array.
+
+    array->null_count = col.null_count;
+    array->buffers[0] = col.validity;
+    array->buffers[1] = col.values;
+    col.validity = 0;
+    col.values   = 0;
+
+    if (IsVarLength(col))
+    {
+        array->buffers[2] = col.data;
+        col.data = 0;
+    }
+
+    return true;
+}
+
+
+static bool Export(Cursor* cur, ArrowColumn* cols, Py_ssize_t cCols, Py_ssize_t count, ArrowArray* parray, ArrowSchema* pschema)
+{
+    // A record batch is exported as a non-nullable struct array with a child for each column.
+
+    bool fArray  = InitArray(parray, count, 1, cCols);
+    bool fSchema = InitSchema(pschema, CopyString("+s", 2), CopyString("", 0), cCols);
+    pschema->flags = 0;
+
+    if (fArray && fSchema)
+    {
+        Py_ssize_t i = 0;
+        while (i < cCols && ExportColumn(cur, i, cols[i], count, parray, pschema))
+            i++;
+        if (i == cCols)
+            return true;
+    }
+
+    if (!PyErr_Occurred())
+        PyErr_NoMemory();
+
+    parray->release(parray);
+    pschema->release(pschema);
+    return false;
+}
+
+
+Py_ssize_t FetchArrow(Cursor* cur, Py_ssize_t max, ArrowArray* array, ArrowSchema* schema)
+{
+    Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+
+    ArrowColumn* cols = (ArrowColumn*)pyodbc_malloc(ALLOC_ARROW, sizeof(ArrowColumn) * cCols);
+    if (cols == 0)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    memset(cols, 0, sizeof(ArrowColumn) * cCols);
+
+    for (Py_ssize_t i = 0; i < cCols; i++)
+        cols[i].kind = GetArrowKind(cur, i, cols[i]);
+
+    Py_ssize_t count = 0;
+    Py_ssize_t capacity = INITIAL_ROWS;
+
+    if (!GrowColumns(cols, cCols, 0, capacity))
+    {
+        FreeColumns(cols, cCols);
+        return -1;
+    }
+
+    while (max == -1 || count < max)
+    {
+        SQLULEN iRow;
+        if (!Cursor_FetchRow(cur, &iRow))
+        {
+            if (PyErr_Occurred())
+            {
+                FreeColumns(cols, cCols);
+                return -1;
+            }
+            break;
+        }
+
+        INT64 start = Stats_Start(cur);
+        INT64 odbc_ns = cur->odbc_ns;
+
+        if (count == capacity)
+        {
+            if (!GrowColumns(cols, cCols, count, capacity * 2))
+            {
+                FreeColumns(cols, cCols);
+                return -1;
+            }
+            capacity *= 2;
+        }
+
+        for (Py_ssize_t i = 0; i < cCols; i++)
+        {
+            if (!ReadValue(cur, i, iRow, cols[i], count))
+            {
+                FreeColumns(cols, cCols);
+                return -1;
+            }
+        }
+
+        Stats_EndRows(cur, start, odbc_ns);
+        count++;
+    }
+
+    ArrowArray  newarray;
+    ArrowSchema newschema;
+    bool success = Export(cur, cols, cCols, count, &newarray, &newschema);
+
+    FreeColumns(cols, cCols);
+
+    if (!success)
+        return -1;
+
+    *array  = newarray;
+    *schema = newschema;
+
+    return count;
+}
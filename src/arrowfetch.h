@@ -0,0 +1,60 @@
+#ifndef _ARROWFETCH_H_
+#define _ARROWFETCH_H_
+
+struct Cursor;
+
+// The structures of the Apache Arrow C Data Interface, which are meant to be copied into projects that produce or
+// consume Arrow data so they do not depend on Arrow itself.  See
+// https://arrow.apache.org/docs/format/CDataInterface.html
+//
+// The spec uses int64_t, which INT64 is the same as.
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+    const char* format;
+    const char* name;
+    const char* metadata;
+    INT64 flags;
+    INT64 n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray
+{
+    INT64 length;
+    INT64 null_count;
+    INT64 offset;
+    INT64 n_buffers;
+    INT64 n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+/**
+ * Implements Cursor.fetcharrow: fetches up to `max` rows (all of them if -1) into a struct array with a child array
+ * for each column, which is how the C Data Interface represents a record batch, and moves it into the caller's `array`
+ * and `schema`.
+ *
+ * Returns the number of rows fetched, or -1 if an exception was raised, in which case `array` and `schema` are not
+ * modified.
+ */
+Py_ssize_t FetchArrow(Cursor* cur, Py_ssize_t max, ArrowArray* array, ArrowSchema* schema);
+
+#endif // _ARROWFETCH_H_
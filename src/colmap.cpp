@@ -0,0 +1,119 @@
+// The map from column name to index shared by the rows of a result set.
+//
+// `row.colname` is the most common way to read a value by name, and the name Python passes to Row_getattro is then
+// the interned string from the code object.  The map interns the column names when it is built, so these lookups
+// compare pointers in a small open-addressing table (hashed by address, kept at most half full) and read the index
+// stored in the slot, without hashing the string, calling into the dictionary, or unboxing an integer.
+//
+// Names that aren't interned, such as those passed to getattr, miss the table and are looked up in the dictionary.
+// The map is never modified after the cursor builds it.
+
+#include "pyodbc.h"
+#include "colmap.h"
+
+static const Py_ssize_t MIN_SLOTS = 8;
+
+PyObject* ColumnMap_New(Py_ssize_t cNames)
+{
+    Py_ssize_t cSlots = MIN_SLOTS;
+    while (cSlots < cNames * 2)
+        cSlots *= 2;
+
+    ColumnMap* map = PyObject_NewVar(ColumnMap, &ColumnMapType, cSlots);
+    if (map == 0)
+        return 0;
+
+    memset(map->slots, 0, sizeof(ColumnMapSlot) * (size_t)cSlots);
+
+    map->dict = PyDict_New();
+    if (map->dict == 0)
+    {
+        Py_DECREF(map);
+        return 0;
+    }
+
+    return (PyObject*)map;
+}
+
+
+bool ColumnMap_Add(PyObject* o, const char* name, Py_ssize_t index)
+{
+    ColumnMap* map = (ColumnMap*)o;
+
+    I(PyDict_Size(map->dict) * 2 < Py_SIZE(map));
+
+    PyObject* key = PyString_InternFromString(name);
+    if (!key)
+        return false;
+
+    PyObject* value = PyInt_FromLong((long)index);
+    if (!value || PyDict_SetItem(map->dict, key, value) == -1)
+    {
+        Py_XDECREF(value);
+        Py_DECREF(key);
+        return false;
+    }
+    Py_DECREF(value);
+
+    // Duplicate names get the last index, like the dictionary.  The slot keeps the reference to the key.
+
+    size_t mask = (size_t)Py_SIZE(map) - 1;
+    size_t i = ColumnMap_Hash(key) & mask;
+    while (map->slots[i].name != 0 && map->slots[i].name != key)
+        i = (i + 1) & mask;
+
+    if (map->slots[i].name == key)
+        Py_DECREF(key);
+    map->slots[i].name  = key;
+    map->slots[i].index = index;
+
+    return true;
+}
+
+
+Py_ssize_t ColumnMap_LookupSlow(ColumnMap* map, PyObject* name)
+{
+    // PyDict_GetItem doesn't set an exception if the name can't be hashed.
+    PyObject* index = PyDict_GetItem(map->dict, name);
+    if (index == 0)
+        return -1;
+    return (Py_ssize_t)PyInt_AS_LONG(index);
+}
+
+
+static void ColumnMap_dealloc(PyObject* o)
+{
+    ColumnMap* map = (ColumnMap*)o;
+
+    for (Py_ssize_t i = 0; i < Py_SIZE(map); i++)
+        Py_XDECREF(map->slots[i].name);
+    Py_XDECREF(map->dict);
+
+    PyObject_Del(o);
+}
+
+
+PyTypeObject ColumnMapType =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pyodbc.ColumnMap",                                     // tp_name
+    sizeof(ColumnMap) - sizeof(ColumnMapSlot),              // tp_basicsize
+    sizeof(ColumnMapSlot),                                  // tp_itemsize
+    ColumnMap_dealloc,                                      // tp_dealloc
+    0,                                                      // tp_print
+    0,                                                      // tp_getattr
+    0,                                                      // tp_setattr
+    0,                                                      // tp_compare
+    0,                                                      // tp_repr
+    0,                                                      // tp_as_number
+    0,                                                      // tp_as_sequence
+    0,                                                      // tp_as_mapping
+    0,                                                      // tp_hash
+    0,                                                      // tp_call
+    0,                                                      // tp_str
+    0,                                                      // tp_getattro
+    0,                                                      // tp_setattro
+    0,                                                      // tp_as_buffer
+    Py_TPFLAGS_DEFAULT,                                     // tp_flags
+    0,                                                      // tp_doc
+};
@@ -0,0 +1,66 @@
+#ifndef _COLMAP_H_
+#define _COLMAP_H_
+
+// The map from column name to index shared by a cursor's rows, used to implement `row.colname`.  See colmap.cpp.
+
+struct ColumnMapSlot
+{
+    // An interned column name (the table holds a reference) or zero if the slot is empty.
+    PyObject* name;
+    Py_ssize_t index;
+};
+
+struct ColumnMap
+{
+    // ob_size is the number of slots, always a power of two.
+    PyObject_VAR_HEAD
+
+    // A dictionary mapping each name to its index (PyInteger), used for names that aren't the interned objects in the
+    // table, such as names built at runtime and passed to getattr.
+    PyObject* dict;
+
+    ColumnMapSlot slots[1];
+};
+
+extern PyTypeObject ColumnMapType;
+
+/**
+ * Returns a new, empty map with room for `cNames` names, or zero with an exception set.
+ */
+PyObject* ColumnMap_New(Py_ssize_t cNames);
+
+/**
+ * Adds a column name.  If the name was already added, the new index replaces it.  Returns false with an exception set
+ * if there isn't enough memory.
+ */
+bool ColumnMap_Add(PyObject* map, const char* name, Py_ssize_t index);
+
+Py_ssize_t ColumnMap_LookupSlow(ColumnMap* map, PyObject* name);
+
+inline size_t ColumnMap_Hash(PyObject* name)
+{
+    // Objects are at least 8-byte aligned, so the low bits are dropped before mixing.
+    return ((size_t)name >> 3) * 2654435761u;
+}
+
+/**
+ * Returns the index of the column `name`, or -1 if there is no such column.  Never sets an exception.
+ *
+ * Attribute names in Python source are interned, so `row.colname` normally finds the name in the first slot probed by
+ * comparing pointers.
+ */
+inline Py_ssize_t ColumnMap_Lookup(PyObject* o, PyObject* name)
+{
+    ColumnMap* map = (ColumnMap*)o;
+    size_t mask = (size_t)Py_SIZE(map) - 1;
+
+    for (size_t i = ColumnMap_Hash(name) & mask; map->slots[i].name != 0; i = (i + 1) & mask)
+    {
+        if (map->slots[i].name == name)
+            return map->slots[i].index;
+    }
+
+    return ColumnMap_LookupSlow(map, name);
+}
+
+#endif // _COLMAP_H_
@@ -17,6 +17,10 @@
 #include "wrapper.h"
 #include "cnxninfo.h"
 #include "sqlwchar.h"
+#include "stmtcache.h"
+#include "pool.h"
+#include "prefetch.h"
+#include "stats.h"
 
 static char connection_doc[] =
     "Connection objects manage connections to the database.\n"
@@ -81,9 +85,11 @@ static bool Connect(PyObject* pConnectString, HDBC hdbc, bool fAnsi, long timeou
     if (!fAnsi)
     {
         SQLWChar connectString(pConnectString);
+        INT64 start = Trace_Start();
         Py_BEGIN_ALLOW_THREADS
         ret = SQLDriverConnectW(hdbc, 0, connectString, (SQLSMALLINT)connectString.size(), 0, 0, 0, SQL_DRIVER_NOPROMPT);
         Py_END_ALLOW_THREADS
+        Trace_Call(TRACE_SQLDRIVERCONNECT, hdbc, ret, start);
         if (SQL_SUCCEEDED(ret))
             return true;
 
@@ -128,9 +134,11 @@ static bool Connect(PyObject* pConnectString, HDBC hdbc, bool fAnsi, long timeou
 #endif
     }
 
+    INT64 start = Trace_Start();
     Py_BEGIN_ALLOW_THREADS
     ret = SQLDriverConnect(hdbc, 0, szConnect, SQL_NTS, 0, 0, 0, SQL_DRIVER_NOPROMPT);
     Py_END_ALLOW_THREADS
+    Trace_Call(TRACE_SQLDRIVERCONNECT, hdbc, ret, start);
     if (SQL_SUCCEEDED(ret))
         return true;
 
@@ -140,6 +148,61 @@ static bool Connect(PyObject* pConnectString, HDBC hdbc, bool fAnsi, long timeou
 }
 
 
+static Connection* AllocConnection(HDBC hdbc, bool fAutoCommit, bool fUnicodeResults)
+{
+    // Allocates a Connection object for a connected HDBC.  Returns zero if out of memory, in which case the caller
+    // still owns the HDBC.
+
+    // Set all variables to something valid, so we don't crash in dealloc if the caller fails.
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4365)
+#endif
+    Connection* cnxn = PyObject_NEW(Connection, &ConnectionType);
+#ifdef _MSC_VER
+#pragma warning(default : 4365)
+#endif
+
+    if (cnxn == 0)
+        return 0;
+
+    cnxn->hdbc            = hdbc;
+    cnxn->nAutoCommit     = fAutoCommit ? SQL_AUTOCOMMIT_ON : SQL_AUTOCOMMIT_OFF;
+    cnxn->searchescape    = 0;
+    cnxn->timeout         = 0;
+    cnxn->unicode_results = fUnicodeResults;
+    cnxn->conv_count      = 0;
+    cnxn->conv_types      = 0;
+    cnxn->conv_funcs      = 0;
+    cnxn->conv_generation = 0;
+    cnxn->pool            = 0;
+    cnxn->cursor_count    = 0;
+    cnxn->prefetchers     = 0;
+
+    cnxn->stmtcache_capacity = 0;
+    cnxn->stmtcache_count    = 0;
+    cnxn->stmtcache          = 0;
+    cnxn->stmtcache_hits     = 0;
+    cnxn->stmtcache_misses   = 0;
+
+    cnxn->stats = 0;
+
+    return cnxn;
+}
+
+
+static void CopyConnectionInfo(Connection* cnxn, CnxnInfo* p)
+{
+    cnxn->odbc_major             = p->odbc_major;
+    cnxn->odbc_minor             = p->odbc_minor;
+    cnxn->supports_describeparam = p->supports_describeparam;
+    cnxn->datetime_precision     = p->datetime_precision;
+    cnxn->varchar_maxlength      = p->varchar_maxlength;
+    cnxn->wvarchar_maxlength     = p->wvarchar_maxlength;
+    cnxn->binary_maxlength       = p->binary_maxlength;
+}
+
+
 PyObject* Connection_New(PyObject* pConnectString, bool fAutoCommit, bool fAnsi, bool fUnicodeResults, long timeout, bool fReadOnly)
 {
     // pConnectString
@@ -176,16 +239,7 @@ PyObject* Connection_New(PyObject* pConnectString, bool fAutoCommit, bool fAnsi,
     // Connected, so allocate the Connection object. 
     //
 
-    // Set all variables to something valid, so we don't crash in dealloc if this function fails.
-
-#ifdef _MSC_VER
-#pragma warning(disable : 4365)
-#endif
-    Connection* cnxn = PyObject_NEW(Connection, &ConnectionType);
-#ifdef _MSC_VER
-#pragma warning(default : 4365)
-#endif
-
+    Connection* cnxn = AllocConnection(hdbc, fAutoCommit, fUnicodeResults);
     if (cnxn == 0)
     {
         Py_BEGIN_ALLOW_THREADS
@@ -194,15 +248,6 @@ PyObject* Connection_New(PyObject* pConnectString, bool fAutoCommit, bool fAnsi,
         return 0;
     }
 
-    cnxn->hdbc            = hdbc;
-    cnxn->nAutoCommit     = fAutoCommit ? SQL_AUTOCOMMIT_ON : SQL_AUTOCOMMIT_OFF;
-    cnxn->searchescape    = 0;
-    cnxn->timeout         = 0;
-    cnxn->unicode_results = fUnicodeResults;
-    cnxn->conv_count      = 0;
-    cnxn->conv_types      = 0;
-    cnxn->conv_funcs      = 0;
-
     //
     // Initialize autocommit mode.
     //
@@ -255,18 +300,25 @@ PyObject* Connection_New(PyObject* pConnectString, bool fAutoCommit, bool fAnsi,
         return 0;
     }
 
-    CnxnInfo* p = (CnxnInfo*)info.Get();
-    cnxn->odbc_major             = p->odbc_major;
-    cnxn->odbc_minor             = p->odbc_minor;
-    cnxn->supports_describeparam = p->supports_describeparam;
-    cnxn->datetime_precision     = p->datetime_precision;
-    cnxn->varchar_maxlength      = p->varchar_maxlength;
-    cnxn->wvarchar_maxlength     = p->wvarchar_maxlength;
-    cnxn->binary_maxlength       = p->binary_maxlength;
+    CopyConnectionInfo(cnxn, (CnxnInfo*)info.Get());
 
     return reinterpret_cast<PyObject*>(cnxn);
 }
 
+
+Connection* Connection_Attach(HDBC hdbc, bool fAutoCommit, bool fUnicodeResults, CnxnInfo* info)
+{
+    Connection* cnxn = AllocConnection(hdbc, fAutoCommit, fUnicodeResults);
+    if (cnxn == 0)
+        return 0;
+
+    CopyConnectionInfo(cnxn, info);
+
+    TRACE("cnxn.attach cnxn=%p hdbc=%d\n", cnxn, cnxn->hdbc);
+
+    return cnxn;
+}
+
 static void _clear_conv(Connection* cnxn)
 {
     if (cnxn->conv_count != 0)
@@ -280,6 +332,7 @@ static void _clear_conv(Connection* cnxn)
         cnxn->conv_funcs = 0;
 
         cnxn->conv_count = 0;
+        cnxn->conv_generation++;
     }
 }
 
@@ -309,15 +362,32 @@ static int Connection_clear(PyObject* self)
 
         TRACE("cnxn.clear cnxn=%p hdbc=%d\n", cnxn, cnxn->hdbc);
 
-        Py_BEGIN_ALLOW_THREADS
-        if (cnxn->nAutoCommit == SQL_AUTOCOMMIT_OFF)
-            SQLEndTran(SQL_HANDLE_DBC, cnxn->hdbc, SQL_ROLLBACK);
+        Prefetch_StopAll(cnxn);
 
-        SQLDisconnect(cnxn->hdbc);
-        SQLFreeHandle(SQL_HANDLE_DBC, cnxn->hdbc);
-        Py_END_ALLOW_THREADS
-        
-        cnxn->hdbc = SQL_NULL_HANDLE;
+        // Freeing the cached statements never fails since it doesn't allocate anything.
+        StatementCache_Resize(cnxn, 0);
+
+        // Open cursors still have HSTMTs allocated on the HDBC, so the pool can't give it to someone else.
+        Pool* pool = cnxn->pool;
+        cnxn->pool = 0;
+        if (pool && cnxn->cursor_count == 0)
+            Pool_Return(pool, cnxn);
+        else if (pool)
+            pool->active_count--;
+        Py_XDECREF(pool);
+
+        if (cnxn->hdbc != SQL_NULL_HANDLE)
+        {
+            Py_BEGIN_ALLOW_THREADS
+            if (cnxn->nAutoCommit == SQL_AUTOCOMMIT_OFF)
+                SQLEndTran(SQL_HANDLE_DBC, cnxn->hdbc, SQL_ROLLBACK);
+
+            SQLDisconnect(cnxn->hdbc);
+            SQLFreeHandle(SQL_HANDLE_DBC, cnxn->hdbc);
+            Py_END_ALLOW_THREADS
+
+            cnxn->hdbc = SQL_NULL_HANDLE;
+        }
     }
 
     Py_XDECREF(cnxn->searchescape);
@@ -331,6 +401,7 @@ static int Connection_clear(PyObject* self)
 static void Connection_dealloc(PyObject* self)
 {
     Connection_clear(self);
+    Py_XDECREF(((Connection*)self)->stats);
     PyObject_Del(self);
 }
 
@@ -628,9 +699,11 @@ static PyObject* Connection_endtrans(PyObject* self, PyObject* args, SQLSMALLINT
     TRACE("%s: cnxn=%p hdbc=%d\n", (type == SQL_COMMIT) ? "commit" : "rollback", cnxn, cnxn->hdbc);
 
     SQLRETURN ret;
+    INT64 start = Trace_Start();
     Py_BEGIN_ALLOW_THREADS
     ret = SQLEndTran(SQL_HANDLE_DBC, cnxn->hdbc, type);
     Py_END_ALLOW_THREADS
+    Trace_Call(TRACE_SQLENDTRAN, cnxn->hdbc, ret, start);
     if (!SQL_SUCCEEDED(ret))
     {
         RaiseErrorFromHandle("SQLEndTran", cnxn->hdbc, SQL_NULL_HANDLE);
@@ -793,6 +866,79 @@ static int Connection_settimeout(PyObject* self, PyObject* value, void* closure)
     return 0;
 }
 
+static PyObject* Connection_getstmtcachesize(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+
+    Connection* cnxn = Connection_Validate(self);
+    if (!cnxn)
+        return 0;
+
+    return PyInt_FromLong(cnxn->stmtcache_capacity);
+}
+
+static int Connection_setstmtcachesize(PyObject* self, PyObject* value, void* closure)
+{
+    UNUSED(closure);
+
+    Connection* cnxn = Connection_Validate(self);
+    if (!cnxn)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the statement_cache_size attribute.");
+        return -1;
+    }
+    long capacity = PyInt_AsLong(value);
+    if (capacity == -1 && PyErr_Occurred())
+        return -1;
+    if (capacity < 0 || capacity > INT_MAX)
+    {
+        PyErr_SetString(PyExc_ValueError, "statement_cache_size must be between zero and INT_MAX.");
+        return -1;
+    }
+
+    if (!StatementCache_Resize(cnxn, (int)capacity))
+        return -1;
+
+    return 0;
+}
+
+static PyObject* Connection_getstmtcachehits(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+
+    Connection* cnxn = Connection_Validate(self);
+    if (!cnxn)
+        return 0;
+
+    return PyInt_FromLong(cnxn->stmtcache_hits);
+}
+
+static PyObject* Connection_getstmtcachemisses(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+
+    Connection* cnxn = Connection_Validate(self);
+    if (!cnxn)
+        return 0;
+
+    return PyInt_FromLong(cnxn->stmtcache_misses);
+}
+
+static PyObject* Connection_getstats(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+    return Stats_Get(((Connection*)self)->stats);
+}
+
+static int Connection_setstats(PyObject* self, PyObject* value, void* closure)
+{
+    UNUSED(closure);
+    return Stats_Set(((Connection*)self)->stats, value);
+}
+
 static bool _add_converter(PyObject* self, SQLSMALLINT sqltype, PyObject* func)
 {
     Connection* cnxn = (Connection*)self;
@@ -817,8 +963,8 @@ static bool _add_converter(PyObject* self, SQLSMALLINT sqltype, PyObject* func)
     PyObject**   oldfuncs = cnxn->conv_funcs;
 
     int          newcount = oldcount + 1;
-    SQLSMALLINT* newtypes = (SQLSMALLINT*)pyodbc_malloc(sizeof(SQLSMALLINT) * newcount);
-    PyObject**   newfuncs = (PyObject**)pyodbc_malloc(sizeof(PyObject*) * newcount);
+    SQLSMALLINT* newtypes = (SQLSMALLINT*)pyodbc_malloc(ALLOC_OTHER, sizeof(SQLSMALLINT) * newcount);
+    PyObject**   newfuncs = (PyObject**)pyodbc_malloc(ALLOC_OTHER, sizeof(PyObject*) * newcount);
 
     if (newtypes == 0 || newfuncs == 0)
     {
@@ -837,6 +983,7 @@ static bool _add_converter(PyObject* self, SQLSMALLINT sqltype, PyObject* func)
     cnxn->conv_count = newcount;
     cnxn->conv_types = newtypes;
     cnxn->conv_funcs = newfuncs;
+    cnxn->conv_generation++;
 
     if (oldcount != 0)
     {
@@ -928,6 +1075,18 @@ static PyGetSetDef Connection_getseters[] = {
       "Returns True if the connection is in autocommit mode; False otherwise.", 0 },
     { "timeout", Connection_gettimeout, Connection_settimeout,
       "The timeout in seconds, zero means no timeout.", 0 },
+    { "statement_cache_size", Connection_getstmtcachesize, Connection_setstmtcachesize,
+      "The number of prepared statements the connection keeps for reuse by its cursors.\n"
+      "Zero, the default, disables the cache.", 0 },
+    { "statement_cache_hits", Connection_getstmtcachehits, 0,
+      "The number of times a cursor used a statement from the statement cache\n"
+      "instead of preparing it.", 0 },
+    { "statement_cache_misses", Connection_getstmtcachemisses, 0,
+      "The number of times a cursor had to prepare a statement that was not in the\n"
+      "statement cache.", 0 },
+    { "stats", Connection_getstats, Connection_setstats,
+      "A pyodbc.Stats object that the connection's cursors add their statistics to,\n"
+      "or None, the default, to not collect them.", 0 },
     { 0 }
 };
 
@@ -13,6 +13,11 @@
 #define CONNECTION_H
 
 struct Cursor;
+struct CachedStatement;
+struct CnxnInfo;
+struct Pool;
+struct Prefetcher;
+struct Stats;
 
 extern PyTypeObject ConnectionType;
 
@@ -62,6 +67,33 @@ struct Connection
     int conv_count;             // how many items are in conv_types and conv_funcs.
     SQLSMALLINT* conv_types;            // array of SQL_TYPEs to convert
     PyObject** conv_funcs;      // array of Python functions
+
+    // Incremented whenever a conversion is added or removed so cursors can tell that a description they cached
+    // (see Cursor.cached_sql) may have the wrong types.
+    int conv_generation;
+
+    // The pool the HDBC is returned to when the connection is closed, or zero if it was not checked out of a pool.
+    Pool* pool;
+
+    // The number of open cursors.  Their HSTMTs were allocated from hdbc, so it is only returned to the pool when this
+    // is zero.
+    int cursor_count;
+
+    // The prefetchers of cursors whose results are being prefetched (see prefetch.cpp), linked through their `next`
+    // fields.  Their threads must be stopped before hdbc is freed.
+    Prefetcher* prefetchers;
+
+    // Prepared statements kept for reuse by cursors (see stmtcache.cpp).  The cache is disabled when
+    // stmtcache_capacity is zero, in which case stmtcache is also zero.
+
+    int stmtcache_capacity;
+    int stmtcache_count;
+    CachedStatement* stmtcache; // array of stmtcache_capacity items, the most recently used first
+    long stmtcache_hits;
+    long stmtcache_misses;
+
+    // The Stats object assigned to Connection.stats, or zero.  See stats.cpp.
+    Stats* stats;
 };
 
 #define Connection_Check(op) PyObject_TypeCheck(op, &ConnectionType)
@@ -73,4 +105,11 @@ struct Connection
  */
 PyObject* Connection_New(PyObject* pConnectString, bool fAutoCommit, bool fAnsi, bool fUnicodeResults, long timeout, bool fReadOnly);
 
+/*
+ * Used by connection pools to create a new connection object for an HDBC that was connected by an earlier connection.
+ * The HDBC's autocommit mode must already be `fAutoCommit`.  If out of memory, zero is returned and the caller still
+ * owns the HDBC.
+ */
+Connection* Connection_Attach(HDBC hdbc, bool fAutoCommit, bool fUnicodeResults, CnxnInfo* info);
+
 #endif
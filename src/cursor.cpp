@@ -18,12 +18,20 @@
 #include "pyodbcmodule.h"
 #include "connection.h"
 #include "row.h"
+#include "colmap.h"
 #include "buffer.h"
 #include "params.h"
 #include "errors.h"
 #include "getdata.h"
 #include "dbspecific.h"
 #include "sqlwchar.h"
+#include "stmtcache.h"
+#include "npfetch.h"
+#include "arrowfetch.h"
+#include "prefetch.h"
+#include "rowblock.h"
+#include "stats.h"
+#include "wrapper.h"
 #include <datetime.h>
 
 enum
@@ -221,13 +229,25 @@ static PyObject* PythonTypeFromSqlType(Cursor* cur, const SQLCHAR* name, SQLSMAL
 }
 
 
-static bool create_name_map(Cursor* cur, SQLSMALLINT field_count, bool lower)
+struct ColumnDescription
 {
-    // Called after an execute to construct the map shared by rows.
+    // The results of SQLDescribeCol for one result column.  PrepareResults describes each column once and uses it
+    // for both the ColumnInfo and Cursor.description.
+    SQLCHAR     name[300];
+    SQLSMALLINT data_type;
+    SQLULEN     column_size;    // precision
+    SQLSMALLINT decimal_digits; // scale
+    SQLSMALLINT nullable;
+};
+
+
+static bool create_name_map(Cursor* cur, SQLSMALLINT field_count, bool lower, ColumnDescription* descs)
+{
+    // Called after an execute to construct the description and the map shared by rows from the column descriptions
+    // read by PrepareResults.
 
     bool success = false;
-    PyObject *desc = 0, *colmap = 0, *colinfo = 0, *type = 0, *index = 0, *nullable_obj=0;
-    SQLRETURN ret;
+    PyObject *desc = 0, *colmap = 0, *colinfo = 0, *type = 0, *nullable_obj=0;
 
     I(cur->hstmt != SQL_NULL_HANDLE && cur->colinfos != 0);
 
@@ -243,36 +263,17 @@ static bool create_name_map(Cursor* cur, SQLSMALLINT field_count, bool lower)
     }
 
     desc   = PyTuple_New((Py_ssize_t)field_count);
-    colmap = PyDict_New();
+    colmap = ColumnMap_New((Py_ssize_t)field_count);
     if (!desc || !colmap)
         goto done;
 
     for (int i = 0; i < field_count; i++)
     {
-        SQLCHAR name[300];
-        SQLSMALLINT nDataType;
-        SQLULEN nColSize;           // precision
-        SQLSMALLINT cDecimalDigits; // scale
-        SQLSMALLINT nullable;
-
-        Py_BEGIN_ALLOW_THREADS
-        ret = SQLDescribeCol(cur->hstmt, (SQLUSMALLINT)(i + 1), name, _countof(name), 0, &nDataType, &nColSize, &cDecimalDigits, &nullable);
-        Py_END_ALLOW_THREADS
-
-        if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
-        {
-            // The connection was closed by another thread in the ALLOW_THREADS block above.
-            RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
-            goto done;
-        }
-
-        if (!SQL_SUCCEEDED(ret))
-        {
-            RaiseErrorFromHandle("SQLDescribeCol", cur->cnxn->hdbc, cur->hstmt);
-            goto done;
-        }
-
-        TRACE("Col %d: type=%d colsize=%d\n", (i+1), (int)nDataType, (int)nColSize);
+        SQLCHAR*    name           = descs[i].name;
+        SQLSMALLINT nDataType      = descs[i].data_type;
+        SQLULEN     nColSize       = descs[i].column_size;
+        SQLSMALLINT cDecimalDigits = descs[i].decimal_digits;
+        SQLSMALLINT nullable       = descs[i].nullable;
 
         if (lower)
             _strlwr((char*)name);
@@ -330,14 +331,9 @@ static bool create_name_map(Cursor* cur, SQLSMALLINT field_count, bool lower)
 
         nullable_obj = 0;
 
-        index = PyInt_FromLong(i);
-        if (!index)
+        if (!ColumnMap_Add(colmap, (const char*)name, i))
             goto done;
 
-        PyDict_SetItemString(colmap, (const char*)name, index);
-        Py_DECREF(index);       // SetItemString increments
-        index = 0;
-
         PyTuple_SET_ITEM(desc, i, colinfo);
         colinfo = 0;            // reference stolen by SET_ITEM
     }
@@ -354,7 +350,6 @@ static bool create_name_map(Cursor* cur, SQLSMALLINT field_count, bool lower)
     Py_XDECREF(nullable_obj);
     Py_XDECREF(desc);
     Py_XDECREF(colmap);
-    Py_XDECREF(index);
     Py_XDECREF(colinfo);
 
     return success;
@@ -389,10 +384,33 @@ static bool free_results(Cursor* self, int flags)
         self->pPreparedSQL = 0;
     }
 
-    if (self->colinfos)
+    // The prefetch thread uses the HSTMT and the fetch buffer.
+    Prefetch_Stop(self);
+
+    // LobReaders can no longer read the current row.
+    self->row_serial++;
+
+    bool bound = (self->fetch_buffer != 0);
+
+    // Lazy rows may still need the current rowset, in which case they take the fetch buffer.
+    RowBlock_Detach(self, true);
+    Py_XDECREF(self->overflow_values);
+    self->overflow_values = 0;
+
+    // The ColumnInfos are in the arena, so they are released with the parameters.
+    self->colinfos = 0;
+    if (self->paramInfos == 0)
+        Arena_Reset(self->arena);
+
+    if (bound)
     {
-        pyodbc_free(self->colinfos);
-        self->colinfos = 0;
+        pyodbc_free(self->fetch_buffer);
+        self->fetch_buffer = 0;
+        self->rowset_size  = 0;
+        self->rows_fetched = 0;
+        self->rowset_index = 0;
+        self->row_status   = 0;
+        self->rowset_bytes = 0;
     }
 
     if (StatementIsValid(self))
@@ -411,6 +429,18 @@ static bool free_results(Cursor* self, int flags)
             Py_END_ALLOW_THREADS;
         }
 
+        if (bound)
+        {
+            // Column bindings and statement attributes survive SQL_CLOSE, so remove the block fetching bindings (see
+            // BindResults) before the next statement is executed.
+            Py_BEGIN_ALLOW_THREADS
+            SQLFreeStmt(self->hstmt, SQL_UNBIND);
+            SQLSetStmtAttr(self->hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)1, 0);
+            SQLSetStmtAttr(self->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, 0, 0);
+            SQLSetStmtAttr(self->hstmt, SQL_ATTR_ROW_STATUS_PTR, 0, 0);
+            Py_END_ALLOW_THREADS;
+        }
+
         if (self->cnxn->hdbc == SQL_NULL_HANDLE)
         {
             // The connection was closed by another thread in the ALLOW_THREADS block above.
@@ -438,16 +468,38 @@ static bool free_results(Cursor* self, int flags)
 }
 
 
+static void FreeCachedResults(Cursor* cur)
+{
+    Py_XDECREF(cur->cached_sql);
+    Py_XDECREF(cur->cached_description);
+    Py_XDECREF(cur->cached_map_name_to_index);
+    pyodbc_free(cur->cached_colinfos);
+
+    cur->cached_sql               = 0;
+    cur->cached_description       = 0;
+    cur->cached_map_name_to_index = 0;
+    cur->cached_colinfos          = 0;
+    cur->cached_column_count      = 0;
+    cur->cached_bound_types       = 0;
+    cur->cached_bound_types_count = 0;
+}
+
+
 static void closeimpl(Cursor* cur)
 {
     // An internal function for the shared 'closing' code used by Cursor_close and Cursor_dealloc.
     //
     // This method releases the GIL lock while closing, so verify the HDBC still exists if you use it.
 
-    free_results(cur, FREE_STATEMENT | FREE_PREPARED);
+    free_results(cur, FREE_STATEMENT | KEEP_PREPARED);
 
-    FreeParameterInfo(cur);
     FreeParameterData(cur);
+    Arena_Free(cur->arena);
+
+    // If the connection's statement cache is enabled, it takes the prepared statement, leaving the cursor's hstmt zero.
+    StatementCache_Release(cur);
+
+    FreeParameterInfo(cur);
 
     if (StatementIsValid(cur))
     {
@@ -459,9 +511,13 @@ static void closeimpl(Cursor* cur)
     }
 
 
+    FreeCachedResults(cur);
+
     Py_XDECREF(cur->pPreparedSQL);
     Py_XDECREF(cur->description);
     Py_XDECREF(cur->map_name_to_index);
+    if (cur->cnxn)
+        cur->cnxn->cursor_count--;
     Py_XDECREF(cur->cnxn);
 
     cur->pPreparedSQL = 0;
@@ -496,43 +552,41 @@ static void Cursor_dealloc(Cursor* cursor)
         closeimpl(cursor);
     }
 
+    Arena_Free(cursor->arena);
+    pyodbc_free(cursor->bound_types);
+    Py_XDECREF(cursor->overflow_values);
+    Py_XDECREF(cursor->stats);
     PyObject_Del(cursor);
 }
 
 
-bool InitColumnInfo(Cursor* cursor, SQLUSMALLINT iCol, ColumnInfo* pinfo)
+static bool DescribeColumn(Cursor* cursor, SQLUSMALLINT iCol, ColumnDescription* pdesc)
 {
-    // Initializes ColumnInfo from result set metadata.
-
-    SQLRETURN ret;
-
     // REVIEW: This line fails on OS/X with the FileMaker driver : http://www.filemaker.com/support/updaters/xdbc_odbc_mac.html
     //
     // I suspect the problem is that it doesn't allow NULLs in some of the parameters, so I'm going to supply them all
     // to see what happens.
 
-    SQLCHAR     ColumnName[200];
-    SQLSMALLINT BufferLength  = _countof(ColumnName);
-    SQLSMALLINT NameLength    = 0;
-    SQLSMALLINT DataType      = 0;
-    SQLULEN     ColumnSize    = 0;
-    SQLSMALLINT DecimalDigits = 0;
-    SQLSMALLINT Nullable      = 0;
+    SQLRETURN   ret;
+    SQLSMALLINT NameLength = 0;
+
+    pdesc->name[0]        = 0;
+    pdesc->data_type      = 0;
+    pdesc->column_size    = 0;
+    pdesc->decimal_digits = 0;
+    pdesc->nullable       = 0;
 
     Py_BEGIN_ALLOW_THREADS
     ret = SQLDescribeCol(cursor->hstmt, iCol,
-                         ColumnName,
-                         BufferLength,
+                         pdesc->name,
+                         _countof(pdesc->name),
                          &NameLength,
-                         &DataType,
-                         &ColumnSize,
-                         &DecimalDigits,
-                         &Nullable);
+                         &pdesc->data_type,
+                         &pdesc->column_size,
+                         &pdesc->decimal_digits,
+                         &pdesc->nullable);
     Py_END_ALLOW_THREADS
 
-    pinfo->sql_type    = DataType;
-    pinfo->column_size = ColumnSize;
-
     if (cursor->cnxn->hdbc == SQL_NULL_HANDLE)
     {
         // The connection was closed by another thread in the ALLOW_THREADS block above.
@@ -546,6 +600,23 @@ bool InitColumnInfo(Cursor* cursor, SQLUSMALLINT iCol, ColumnInfo* pinfo)
         return false;
     }
 
+    TRACE("Col %d: type=%d colsize=%d\n", (int)iCol, (int)pdesc->data_type, (int)pdesc->column_size);
+
+    return true;
+}
+
+
+static bool InitColumnInfo(Cursor* cursor, SQLUSMALLINT iCol, const ColumnDescription* pdesc, ColumnInfo* pinfo)
+{
+    // Initializes ColumnInfo from result set metadata.
+
+    SQLRETURN ret;
+
+    pinfo->sql_type     = pdesc->data_type;
+    pinfo->column_size  = pdesc->column_size;
+    pinfo->data         = 0;
+    pinfo->bound_reader = 0;
+
     // If it is an integer type, determine if it is signed or unsigned.  The buffer size is the same but we'll need to
     // know when we convert to a Python integer.
 
@@ -585,35 +656,514 @@ bool InitColumnInfo(Cursor* cursor, SQLUSMALLINT iCol, ColumnInfo* pinfo)
 }
 
 
-static bool PrepareResults(Cursor* cur, int cCols)
+// The maximum size of the buffer allocated for block fetching.  If the rows are wide, fewer than arraysize rows are
+// fetched at a time.
+static const size_t MAX_FETCH_BUFFER = 4 * 1024 * 1024;
+
+// The maximum value of Cursor.prefetch.  Since each rowset uses up to MAX_FETCH_BUFFER, this also limits the memory
+// used by a prefetching cursor.
+static const int MAX_PREFETCH = 64;
+
+inline size_t AlignFetchBuffer(size_t cb)
+{
+    return (cb + 7) & ~(size_t)7;
+}
+
+static bool BindResults(Cursor* cur, int cCols)
+{
+    // Called by PrepareResults when arraysize is greater than 1 to bind column-wise buffers for the result columns so
+    // each SQLFetch returns a block of rows instead of requiring a SQLFetch per row and a SQLGetData per value.
+    //
+    // Columns that cannot be bound (such as LOBs and columns without a maximum size) must be read using SQLGetData.
+    // Drivers are only required to support SQLGetData for unbound columns after the last bound column and most don't
+    // support it at all for multi-row rowsets, so if there are any such columns, we bind only the columns before the
+    // first one and fetch a single row at a time.
+
+    int cBound = 0;
+    size_t cbRow = 0;
+
+    for (int i = 0; i < cCols; i++)
+    {
+        if (!GetBindInfo(cur, i))
+            break;
+        cbRow += (size_t)cur->colinfos[i].buffer_length + sizeof(SQLLEN);
+        cBound++;
+    }
+
+    if (cBound == 0)
+        return true;
+
+    SQLULEN cRows = 1;
+    if (cBound == cCols)
+    {
+        cRows = (SQLULEN)max((size_t)1, min((size_t)cur->arraysize, MAX_FETCH_BUFFER / cbRow));
+    }
+
+    // Lay out the buffer: the row status array followed by the lengths and data for each column.  Each section is
+    // 8-byte aligned so the fixed-size C types are aligned.
+    //
+    // When prefetching, the buffer holds prefetch + 1 of these rowsets and the columns are bound to the first.
+    // Prefetching needs every column bound since SQLGetData only works on the cursor's actual position.
+
+    size_t cbBuffer = AlignFetchBuffer(sizeof(SQLUSMALLINT) * cRows);
+    for (int i = 0; i < cBound; i++)
+        cbBuffer += AlignFetchBuffer(sizeof(SQLLEN) * cRows) + AlignFetchBuffer((size_t)cur->colinfos[i].buffer_length * cRows);
+
+    // A rowset can exceed MAX_FETCH_BUFFER when a single row is larger, so don't prefetch if the buffer size would
+    // overflow.
+    bool fPrefetch = (cur->prefetch > 0 && cBound == cCols && cbBuffer <= (size_t)-1 / ((size_t)cur->prefetch + 1));
+
+    char* pb = (char*)pyodbc_malloc(ALLOC_FETCH, cbBuffer * (fPrefetch ? (size_t)cur->prefetch + 1 : 1));
+    if (!pb)
+    {
+        PyErr_NoMemory();
+        return false;
+    }
+
+    cur->fetch_buffer = pb;
+    cur->row_status = (SQLUSMALLINT*)pb;
+    cur->rowset_bytes = cbBuffer;
+    pb += AlignFetchBuffer(sizeof(SQLUSMALLINT) * cRows);
+
+    for (int i = 0; i < cBound; i++)
+    {
+        ColumnInfo* pinfo = &cur->colinfos[i];
+        pinfo->lengths = (SQLLEN*)pb;
+        pb += AlignFetchBuffer(sizeof(SQLLEN) * cRows);
+        pinfo->data = pb;
+        pb += AlignFetchBuffer((size_t)pinfo->buffer_length * cRows);
+    }
+
+    SQLRETURN ret;
+    const char* szFunction = "SQLSetStmtAttr";
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)cRows, 0);
+    if (ret == SQL_SUCCESS_WITH_INFO)
+    {
+        // The driver substituted a smaller value (01S02).
+        ret = SQLGetStmtAttr(cur->hstmt, SQL_ATTR_ROW_ARRAY_SIZE, &cRows, 0, 0);
+    }
+    else if (!SQL_SUCCEEDED(ret))
+    {
+        // The driver doesn't support block cursors, but binding still saves the SQLGetData calls.
+        cRows = 1;
+        ret = SQL_SUCCESS;
+    }
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &cur->rows_fetched, 0);
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_STATUS_PTR, cur->row_status, 0);
+    for (int i = 0; i < cBound && SQL_SUCCEEDED(ret); i++)
+    {
+        ColumnInfo* pinfo = &cur->colinfos[i];
+        szFunction = "SQLBindCol";
+        ret = SQLBindCol(cur->hstmt, (SQLUSMALLINT)(i + 1), pinfo->c_type, pinfo->data, pinfo->buffer_length, pinfo->lengths);
+    }
+    Py_END_ALLOW_THREADS
+
+    // Set these even on failure so free_results can clean up.
+    cur->rowset_size  = cRows;
+    cur->rows_fetched = 0;
+    cur->rowset_index = 0;
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        RaiseErrorFromHandle(szFunction, cur->cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+    if (fPrefetch && !Prefetch_Start(cur, cCols, cbBuffer))
+        return false;
+
+    return true;
+}
+
+
+static bool DescribeResults(Cursor* cur, int cCols, bool lower)
+{
+    // Describes each column once, using the results to initialize the ColumnInfos and to create the description and
+    // name map.  On failure, colinfos is left for the caller to release.
+
+    ColumnDescription* descs = (ColumnDescription*)Arena_Alloc(cur->arena, sizeof(ColumnDescription) * cCols);
+    if (descs == 0)
+    {
+        PyErr_NoMemory();
+        return false;
+    }
+
+    for (int i = 0; i < cCols; i++)
+    {
+        if (!DescribeColumn(cur, (SQLUSMALLINT)(i + 1), &descs[i]) ||
+            !InitColumnInfo(cur, (SQLUSMALLINT)(i + 1), &descs[i], &cur->colinfos[i]))
+            return false;
+    }
+
+    return create_name_map(cur, (SQLSMALLINT)cCols, lower, descs);
+}
+
+
+static void CacheResults(Cursor* cur, int cCols, bool lower)
+{
+    // Saves the just described results of pPreparedSQL for the next time it is executed.  Since this is only an
+    // optimization, running out of memory just means nothing is cached.
+
+    FreeCachedResults(cur);
+
+    size_t cbTypes = sizeof(SQLSMALLINT) * 2 * (size_t)cur->bound_types_count;
+
+    cur->cached_colinfos = (ColumnInfo*)pyodbc_malloc(ALLOC_COLINFOS, sizeof(ColumnInfo) * cCols + cbTypes);
+    if (cur->cached_colinfos == 0)
+        return;
+    memcpy(cur->cached_colinfos, cur->colinfos, sizeof(ColumnInfo) * cCols);
+
+    cur->cached_bound_types       = (SQLSMALLINT*)&cur->cached_colinfos[cCols];
+    cur->cached_bound_types_count = cur->bound_types_count;
+    if (cbTypes)
+        memcpy(cur->cached_bound_types, cur->bound_types, cbTypes);
+
+    cur->cached_sql               = cur->pPreparedSQL;
+    cur->cached_column_count      = cCols;
+    cur->cached_description       = cur->description;
+    cur->cached_map_name_to_index = cur->map_name_to_index;
+    cur->cached_lower             = lower;
+    cur->cached_conv_generation   = cur->cnxn->conv_generation;
+
+    Py_INCREF(cur->cached_sql);
+    Py_INCREF(cur->cached_description);
+    Py_INCREF(cur->cached_map_name_to_index);
+}
+
+
+static bool PrepareResults(Cursor* cur, int cCols, bool lower, bool cache)
 {
     // Called after a SELECT has been executed to perform pre-fetch work.
     //
-    // Allocates the ColumnInfo structures describing the returned data.
+    // Allocates the ColumnInfo structures describing the returned data and creates the description and name map.
+    //
+    // lower
+    //   If true, the column names are converted to lowercase.
+    //
+    // cache
+    //   True if these are the first results of executing pPreparedSQL.  If the previous results of the same statement
+    //   were cached, had the same number of columns, and were executed with parameters of the same types, they are
+    //   reused instead of describing the columns again.  Otherwise the results are cached for the next execution.
 
     int i;
     I(cur->colinfos == 0);
 
-    cur->colinfos = (ColumnInfo*)pyodbc_malloc(sizeof(ColumnInfo) * cCols);
+    cur->colinfos = (ColumnInfo*)Arena_Alloc(cur->arena, sizeof(ColumnInfo) * cCols);
     if (cur->colinfos == 0)
     {
         PyErr_NoMemory();
         return false;
     }
 
-    for (i = 0; i < cCols; i++)
+    if (cache &&
+        cur->cached_sql != 0 &&
+        cur->cached_sql == cur->pPreparedSQL &&
+        cur->cached_column_count == cCols &&
+        cur->cached_bound_types_count == cur->bound_types_count &&
+        memcmp(cur->cached_bound_types, cur->bound_types, sizeof(SQLSMALLINT) * 2 * (size_t)cur->bound_types_count) == 0 &&
+        cur->cached_lower == lower &&
+        cur->cached_conv_generation == cur->cnxn->conv_generation)
     {
-        if (!InitColumnInfo(cur, (SQLUSMALLINT)(i + 1), &cur->colinfos[i]))
+        I(cur->description == Py_None && cur->map_name_to_index == 0);
+
+        memcpy(cur->colinfos, cur->cached_colinfos, sizeof(ColumnInfo) * cCols);
+
+        Py_DECREF(cur->description);
+        cur->description = cur->cached_description;
+        Py_INCREF(cur->description);
+
+        cur->map_name_to_index = cur->cached_map_name_to_index;
+        Py_INCREF(cur->map_name_to_index);
+    }
+    else
+    {
+        if (!DescribeResults(cur, cCols, lower))
         {
-            pyodbc_free(cur->colinfos);
             cur->colinfos = 0;
             return false;
         }
+
+        if (cache)
+            CacheResults(cur, cCols, lower);
+    }
+
+    if (cur->arraysize > 1 && !BindResults(cur, cCols))
+    {
+        free_results(cur, FREE_STATEMENT | KEEP_PREPARED);
+        return false;
+    }
+
+    for (i = 0; i < cCols; i++)
+        cur->colinfos[i].reader = GetColumnReader(cur, i);
+
+    return true;
+}
+
+
+static bool PutData(Cursor* cur, const void* pb, SQLLEN cb)
+{
+    // Sends one chunk of the data-at-execution parameter that SQLParamData asked for.  Returns false with an exception
+    // set if it fails.
+
+    SQLRETURN ret;
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLPutData(cur->hstmt, (SQLPOINTER)pb, cb);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_PUTDATA, start);
+    Trace_Call(TRACE_SQLPUTDATA, cur->hstmt, ret, start);
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        RaiseErrorFromHandle("SQLPutData", cur->cnxn->hdbc, cur->hstmt);
+        return false;
     }
 
     return true;
 }
 
+static bool PutBytes(Cursor* cur, const char* pb, SQLLEN cb, SQLLEN cbChunk)
+{
+    // Sends a value that is already in memory in chunks of up to cbChunk bytes.  An empty value is sent as a single
+    // empty chunk since some drivers treat a parameter with no SQLPutData calls as NULL.
+
+    if (cb == 0)
+        return PutData(cur, pb, 0);
+
+    for (SQLLEN offset = 0; offset < cb; offset += cbChunk)
+    {
+        if (!PutData(cur, &pb[offset], min(cbChunk, cb - offset)))
+            return false;
+    }
+
+    return true;
+}
+
+static bool PutStream(Cursor* cur, PyObject* stream, SQLLEN cbChunk, Object& chunk)
+{
+    // Sends the contents of a file-like object, reading up to cbChunk bytes at a time until it returns no data.
+    //
+    // If the object has a readinto method, the data is read into `chunk`, a bytearray allocated the first time it is
+    // needed and reused for the rest of the execute, so a stream of any length is sent without allocating memory for
+    // each chunk.  Otherwise each call to read returns a new bytes object.
+
+    bool sent = false;
+
+#if PY_VERSION_HEX >= 0x02060000
+    if (PyObject_HasAttrString(stream, "readinto"))
+    {
+        if (!chunk.IsValid() || PyByteArray_GET_SIZE(chunk.Get()) != cbChunk)
+        {
+            chunk = PyByteArray_FromStringAndSize(0, cbChunk);
+            if (!chunk.IsValid())
+                return false;
+        }
+
+        for (;;)
+        {
+            Object result(PyObject_CallMethod(stream, "readinto", "O", chunk.Get()));
+            if (!result.IsValid())
+                return false;
+
+            if (result.Get() == Py_None)
+            {
+                RaiseErrorV(0, ProgrammingError, "A stream parameter's readinto returned None.  Non-blocking streams are not supported.");
+                return false;
+            }
+
+            Py_ssize_t cb = PyNumber_AsSsize_t(result, PyExc_OverflowError);
+            if (cb == -1 && PyErr_Occurred())
+                return false;
+
+            // The bytearray is passed to Python code, which could have resized it.
+            if (cb < 0 || cb > PyByteArray_GET_SIZE(chunk.Get()))
+            {
+                RaiseErrorV(0, PyExc_ValueError, "A stream parameter's readinto returned an invalid length: %zd", cb);
+                return false;
+            }
+
+            if (cb == 0)
+                break;
+
+            if (!PutData(cur, PyByteArray_AS_STRING(chunk.Get()), (SQLLEN)cb))
+                return false;
+            sent = true;
+        }
+    }
+    else
+#endif
+    {
+        for (;;)
+        {
+            Object data(PyObject_CallMethod(stream, "read", "l", (long)cbChunk));
+            if (!data.IsValid())
+                return false;
+
+            if (!PyBytes_Check(data.Get()))
+            {
+                RaiseErrorV(0, PyExc_TypeError, "A stream parameter's read must return bytes, not %s.", Py_TYPE(data.Get())->tp_name);
+                return false;
+            }
+
+            if (PyBytes_GET_SIZE(data.Get()) == 0)
+                break;
+
+            if (!PutBytes(cur, PyBytes_AS_STRING(data.Get()), (SQLLEN)PyBytes_GET_SIZE(data.Get()), cbChunk))
+                return false;
+            sent = true;
+        }
+    }
+
+    return sent || PutData(cur, "", 0);
+}
+
+static bool PutIterator(Cursor* cur, PyObject* iter, SQLLEN cbChunk)
+{
+    // Sends the bytes or bytearray objects returned by an iterator, such as a generator, one after another.
+
+    bool sent = false;
+
+    for (;;)
+    {
+        Object item(PyIter_Next(iter));
+        if (!item.IsValid())
+        {
+            if (PyErr_Occurred())
+                return false;
+            break;
+        }
+
+        const char* pb;
+        Py_ssize_t  cb;
+
+        if (PyBytes_Check(item.Get()))
+        {
+            pb = PyBytes_AS_STRING(item.Get());
+            cb = PyBytes_GET_SIZE(item.Get());
+        }
+#if PY_VERSION_HEX >= 0x02060000
+        else if (PyByteArray_Check(item.Get()))
+        {
+            pb = PyByteArray_AS_STRING(item.Get());
+            cb = PyByteArray_GET_SIZE(item.Get());
+        }
+#endif
+        else
+        {
+            RaiseErrorV(0, PyExc_TypeError, "An iterator parameter must return bytes, not %s.", Py_TYPE(item.Get())->tp_name);
+            return false;
+        }
+
+        if (cb == 0)
+            continue;
+
+        if (!PutBytes(cur, pb, (SQLLEN)cb, cbChunk))
+            return false;
+        sent = true;
+    }
+
+    return sent || PutData(cur, "", 0);
+}
+
+static bool PutParameterData(Cursor* cur, PyObject* pParam, Object& chunk)
+{
+    // Sends the value of a parameter bound with SQL_DATA_AT_EXEC or SQL_LEN_DATA_AT_EXEC by GetParameterInfo, which
+    // bound the parameter object itself as the value pointer.  Returns false with an exception set if the value can't
+    // be read or sent.
+    //
+    // Values are sent in chunks of param_chunk_size bytes.  Streams and iterators are read one chunk at a time, so
+    // they can be larger than the available memory.
+
+    SQLLEN cbChunk = (SQLLEN)cur->param_chunk_size;
+
+    if (PyUnicode_Check(pParam))
+    {
+        SQLWChar wchar(pParam); // Will convert to SQLWCHAR if necessary.
+        if (!wchar)
+            return false;
+
+        // Keep whole characters in each chunk.
+        SQLLEN cbCharChunk = max((SQLLEN)sizeof(SQLWCHAR), cbChunk - cbChunk % (SQLLEN)sizeof(SQLWCHAR));
+        return PutBytes(cur, (const char*)wchar[0], (SQLLEN)(wchar.size() * sizeof(SQLWCHAR)), cbCharChunk);
+    }
+
+    if (PyBytes_Check(pParam))
+        return PutBytes(cur, PyBytes_AS_STRING(pParam), (SQLLEN)PyBytes_GET_SIZE(pParam), cbChunk);
+
+#if PY_VERSION_HEX >= 0x02060000
+    if (PyByteArray_Check(pParam))
+        return PutBytes(cur, PyByteArray_AS_STRING(pParam), (SQLLEN)PyByteArray_GET_SIZE(pParam), cbChunk);
+#endif
+
+#if PY_MAJOR_VERSION < 3
+    if (PyBuffer_Check(pParam))
+    {
+        // Buffers can have multiple segments, so we might need multiple writes.  Looping through buffers isn't
+        // difficult, but we've wrapped it up in an iterator object to keep this loop simple.
+
+        BufferSegmentIterator it(pParam);
+        byte* pb;
+        SQLLEN cb;
+        while (it.Next(pb, cb))
+        {
+            if (!PutBytes(cur, (const char*)pb, cb, cbChunk))
+                return false;
+        }
+        return true;
+    }
+#endif
+
+#if PY_VERSION_HEX >= 0x02060000
+    if (PyObject_CheckBuffer(pParam))
+    {
+        // The parameter's info holds a view, so the memory is still the memory that was described when it was bound.
+        Py_buffer view;
+        if (PyObject_GetBuffer(pParam, &view, PyBUF_SIMPLE) == -1)
+            return false;
+        bool success = PutBytes(cur, (const char*)view.buf, (SQLLEN)view.len, cbChunk);
+        PyBuffer_Release(&view);
+        return success;
+    }
+#endif
+
+    if (PyObject_HasAttrString(pParam, "read"))
+        return PutStream(cur, pParam, cbChunk, chunk);
+
+    return PutIterator(cur, pParam, cbChunk);
+}
+
+static void CancelParameterData(Cursor* cur)
+{
+    // Called when sending a data-at-execution parameter fails.  Cancels the execute so the statement isn't left waiting
+    // for data, then unbinds the parameters.
+
+    if (cur->cnxn->hdbc != SQL_NULL_HANDLE)
+    {
+        Py_BEGIN_ALLOW_THREADS
+        SQLCancel(cur->hstmt);
+        Py_END_ALLOW_THREADS
+    }
+
+    FreeParameterData(cur);
+}
+
 
 static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool skip_first)
 {
@@ -659,9 +1209,12 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
             return 0;
 
         szLastFunction = "SQLExecute";
+        INT64 start = Stats_Start(cur);
         Py_BEGIN_ALLOW_THREADS
         ret = SQLExecute(cur->hstmt);
         Py_END_ALLOW_THREADS
+        Stats_EndCall(cur, STATS_EXECUTE, start);
+        Trace_Call(TRACE_SQLEXECUTE, cur->hstmt, ret, start);
     }
     else
     {
@@ -675,9 +1228,12 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
 #if PY_MAJOR_VERSION < 3
         if (PyString_Check(pSql))
         {
+            INT64 start = Stats_Start(cur);
             Py_BEGIN_ALLOW_THREADS
             ret = SQLExecDirect(cur->hstmt, (SQLCHAR*)PyString_AS_STRING(pSql), SQL_NTS);
             Py_END_ALLOW_THREADS
+            Stats_EndCall(cur, STATS_EXECUTE, start);
+            Trace_Call(TRACE_SQLEXECDIRECT, cur->hstmt, ret, start);
         }
         else
 #endif
@@ -685,9 +1241,12 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
             SQLWChar query(pSql);
             if (!query)
                 return 0;
+            INT64 start = Stats_Start(cur);
             Py_BEGIN_ALLOW_THREADS
             ret = SQLExecDirectW(cur->hstmt, query, SQL_NTS);
             Py_END_ALLOW_THREADS
+            Stats_EndCall(cur, STATS_EXECUTE, start);
+            Trace_Call(TRACE_SQLEXECDIRECT, cur->hstmt, ret, start);
         }
     }
 
@@ -709,6 +1268,9 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
         return 0;
     }
 
+    // The buffer used to read streams with readinto.  See PutStream.
+    Object chunk;
+
     while (ret == SQL_NEED_DATA)
     {
         // We have bound a PyObject* using SQL_LEN_DATA_AT_EXEC, so ODBC is asking us for the data now.  We gave the
@@ -724,87 +1286,25 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
         Py_END_ALLOW_THREADS
 
         if (ret != SQL_NEED_DATA && ret != SQL_NO_DATA && !SQL_SUCCEEDED(ret))
-            return RaiseErrorFromHandle("SQLParamData", cur->cnxn->hdbc, cur->hstmt);
+        {
+            RaiseErrorFromHandle("SQLParamData", cur->cnxn->hdbc, cur->hstmt);
+            FreeParameterData(cur);
+            return 0;
+        }
 
         TRACE("SQLParamData() --> %d\n", ret);
 
         if (ret == SQL_NEED_DATA)
         {
-            szLastFunction = "SQLPutData";
-            if (PyUnicode_Check(pParam))
-            {
-                SQLWChar wchar(pParam); // Will convert to SQLWCHAR if necessary.
-
-                Py_ssize_t offset = 0;            // in characters
-                Py_ssize_t length = wchar.size(); // in characters
-
-                while (offset < length)
-                {
-                    SQLLEN remaining = min(cur->cnxn->varchar_maxlength, length - offset);
-                    Py_BEGIN_ALLOW_THREADS
-                    ret = SQLPutData(cur->hstmt, (SQLPOINTER)wchar[offset], (SQLLEN)(remaining * sizeof(SQLWCHAR)));
-                    Py_END_ALLOW_THREADS
-                    if (!SQL_SUCCEEDED(ret))
-                        return RaiseErrorFromHandle("SQLPutData", cur->cnxn->hdbc, cur->hstmt);
-                    offset += remaining;
-                }
-            }
-            else if (PyBytes_Check(pParam))
-            {
-                const char* p = PyBytes_AS_STRING(pParam);
-                SQLLEN offset = 0;
-                SQLLEN cb = (SQLLEN)PyBytes_GET_SIZE(pParam);
-                while (offset < cb)
-                {
-                    SQLLEN remaining = min(cur->cnxn->varchar_maxlength, cb - offset);
-                    TRACE("SQLPutData [%d] (%d) %s\n", offset, remaining, &p[offset]);
-                    Py_BEGIN_ALLOW_THREADS
-                    ret = SQLPutData(cur->hstmt, (SQLPOINTER)&p[offset], remaining);
-                    Py_END_ALLOW_THREADS
-                    if (!SQL_SUCCEEDED(ret))
-                        return RaiseErrorFromHandle("SQLPutData", cur->cnxn->hdbc, cur->hstmt);
-                    offset += remaining;
-                }
-            }
-#if PY_VERSION_HEX >= 0x02060000
-            else if (PyByteArray_Check(pParam))
-            {
-                const char* p = PyByteArray_AS_STRING(pParam);
-                SQLLEN offset = 0;
-                SQLLEN cb     = (SQLLEN)PyByteArray_GET_SIZE(pParam);
-                while (offset < cb)
-                {
-                    SQLLEN remaining = min(cur->cnxn->varchar_maxlength, cb - offset);
-                    TRACE("SQLPutData [%d] (%d) %s\n", offset, remaining, &p[offset]);
-                    Py_BEGIN_ALLOW_THREADS
-                    ret = SQLPutData(cur->hstmt, (SQLPOINTER)&p[offset], remaining);
-                    Py_END_ALLOW_THREADS
-                    if (!SQL_SUCCEEDED(ret))
-                        return RaiseErrorFromHandle("SQLPutData", cur->cnxn->hdbc, cur->hstmt);
-                    offset += remaining;
-                }
-            }
-#endif
-#if PY_MAJOR_VERSION < 3
-            else if (PyBuffer_Check(pParam))
+            // Streams and iterators call Python code, which could free the parameters, so hold a reference.
+            Object param(pParam);
+            Py_INCREF(pParam);
+
+            if (!PutParameterData(cur, pParam, chunk))
             {
-                // Buffers can have multiple segments, so we might need multiple writes.  Looping through buffers isn't
-                // difficult, but we've wrapped it up in an iterator object to keep this loop simple.
-
-                BufferSegmentIterator it(pParam);
-                byte* pb;
-                SQLLEN cb;
-                while (it.Next(pb, cb))
-                {
-                    Py_BEGIN_ALLOW_THREADS
-                    ret = SQLPutData(cur->hstmt, pb, cb);
-                    Py_END_ALLOW_THREADS
-                    if (!SQL_SUCCEEDED(ret))
-                        return RaiseErrorFromHandle("SQLPutData", cur->cnxn->hdbc, cur->hstmt);
-                }
+                CancelParameterData(cur);
+                return 0;
             }
-#endif
-            ret = SQL_NEED_DATA;
         }
     }
 
@@ -822,9 +1322,11 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
         return RaiseErrorFromHandle(szLastFunction, cur->cnxn->hdbc, cur->hstmt);
 
     SQLLEN cRows = -1;
+    INT64 start = Trace_Start();
     Py_BEGIN_ALLOW_THREADS
     ret = SQLRowCount(cur->hstmt, &cRows);
     Py_END_ALLOW_THREADS
+    Trace_Call(TRACE_SQLROWCOUNT, cur->hstmt, ret, start, cRows);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLRowCount", cur->cnxn->hdbc, cur->hstmt);
 
@@ -859,10 +1361,7 @@ static PyObject* execute(Cursor* cur, PyObject* pSql, PyObject* params, bool ski
     {
         // A result set was created.
 
-        if (!PrepareResults(cur, cCols))
-            return 0;
-
-        if (!create_name_map(cur, cCols, lowercase()))
+        if (!PrepareResults(cur, cCols, lowercase(), cParams > 0))
             return 0;
     }
 
@@ -941,6 +1440,30 @@ PyObject* Cursor_execute(PyObject* self, PyObject* args)
 }
 
 
+// The maximum number of rows executemany sends with each SQLExecute when fast_executemany is set.
+static const Py_ssize_t PARAM_ARRAY_ROWS = 1000;
+
+static bool execute_rows(Cursor* cursor, PyObject* pSql, PyObject* param_seq, Py_ssize_t iFirst, Py_ssize_t cRows)
+{
+    // Executes the rows [iFirst, iFirst + cRows) of the executemany sequence one at a time.
+
+    for (Py_ssize_t i = iFirst; i < iFirst + cRows; i++)
+    {
+        PyObject* params = PySequence_GetItem(param_seq, i);
+        PyObject* result = execute(cursor, pSql, params, false);
+        bool success = result != 0;
+        Py_XDECREF(result);
+        Py_DECREF(params);
+        if (!success)
+        {
+            cursor->rowcount = -1;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static PyObject* Cursor_executemany(PyObject* self, PyObject* args)
 {
     Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
@@ -973,25 +1496,121 @@ static PyObject* Cursor_executemany(PyObject* self, PyObject* args)
         return 0;
     }
 
-    for (Py_ssize_t i = 0; i < c; i++)
+    if (cursor->fast_executemany && c > 1)
     {
-        PyObject* params = PySequence_GetItem(param_seq, i);
-        PyObject* result = execute(cursor, pSql, params, false);
-        bool success = result != 0;
-        Py_XDECREF(result);
-        Py_DECREF(params);
-        if (!success)
+        for (Py_ssize_t iFirst = 0; iFirst < c; iFirst += PARAM_ARRAY_ROWS)
         {
-            cursor->rowcount = -1;
-            return 0;
+            Py_ssize_t cRows = min(c - iFirst, PARAM_ARRAY_ROWS);
+
+            int result = PARAMARRAY_UNSUPPORTED;
+            if (cRows > 1)
+            {
+                free_results(cursor, FREE_STATEMENT | KEEP_PREPARED);
+                result = ExecuteParamArray(cursor, pSql, param_seq, iFirst, cRows);
+            }
+
+            if (result == PARAMARRAY_UNSUPPORTED)
+            {
+                // The rows are heterogeneous or the driver doesn't support parameter arrays.
+                if (!execute_rows(cursor, pSql, param_seq, iFirst, cRows))
+                    return 0;
+            }
+            else if (result == PARAMARRAY_ERROR)
+            {
+                cursor->rowcount = -1;
+                return 0;
+            }
         }
     }
+    else
+    {
+        if (!execute_rows(cursor, pSql, param_seq, 0, c))
+            return 0;
+    }
 
     cursor->rowcount = -1;
     Py_RETURN_NONE;
 }
 
 
+bool Cursor_FetchRow(Cursor* cur, SQLULEN* piRow)
+{
+    // Moves to the next row, setting *piRow to its index in the rowset (which is always zero when not block fetching)
+    // so its values can be read by the column readers.
+    //
+    // Returns false if there are no more rows or an error occurs.  (To differentiate between the two, use
+    // PyErr_Occurred.)
+
+    SQLRETURN ret = 0;
+
+    // LobReaders can no longer read the current row.
+    cur->row_serial++;
+
+    // When block fetching, the next row may already be in the fetch buffer.
+    if (cur->rowset_size == 0 || cur->rowset_index >= cur->rows_fetched)
+    {
+        // Lazy rows may still need the rowset being replaced.
+        RowBlock_Detach(cur, false);
+        Py_XDECREF(cur->overflow_values);
+        cur->overflow_values = 0;
+
+        // When prefetching, the time spent waiting for the prefetch thread is counted as the fetch.
+        INT64 start = Stats_Start(cur);
+
+        if (cur->prefetcher)
+        {
+            if (!Prefetch_Next(cur, ret))
+                return false;
+        }
+        else
+        {
+            Py_BEGIN_ALLOW_THREADS
+            ret = SQLFetch(cur->hstmt);
+            Py_END_ALLOW_THREADS
+            Trace_Call(TRACE_SQLFETCH, cur->hstmt, ret, start, !SQL_SUCCEEDED(ret) ? 0 : cur->rowset_size ? (INT64)cur->rows_fetched : 1);
+        }
+
+        Stats_EndCall(cur, STATS_FETCH, start);
+
+        if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+        {
+            // The connection was closed by another thread in the ALLOW_THREADS block above.
+            RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+            return false;
+        }
+
+        if (ret == SQL_NO_DATA)
+        {
+            cur->rows_fetched = 0;
+            return false;
+        }
+
+        if (!SQL_SUCCEEDED(ret))
+        {
+            RaiseErrorFromHandle("SQLFetch", cur->cnxn->hdbc, cur->hstmt);
+            return false;
+        }
+
+        cur->rowset_index = 0;
+
+        // Drivers report values that didn't fit in their bound buffers with a warning.
+        if (ret == SQL_SUCCESS_WITH_INFO && cur->rowset_size != 0 && !GetData_ReadOverflow(cur))
+            return false;
+    }
+
+    SQLULEN iRow = cur->rowset_index++;
+
+    if (cur->rowset_size != 0 && cur->row_status[iRow] == SQL_ROW_ERROR)
+    {
+        RaiseErrorFromHandle("SQLFetch", cur->cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+    *piRow = iRow;
+    return true;
+}
+
+
 static PyObject* Cursor_fetch(Cursor* cur)
 {
     // Internal function to fetch a single row and construct a Row object from it.  Used by all of the fetching
@@ -1000,47 +1619,50 @@ static PyObject* Cursor_fetch(Cursor* cur)
     // Returns a Row object if successful.  If there are no more rows, zero is returned.  If an error occurs, an
     // exception is set and zero is returned.  (To differentiate between the last two, use PyErr_Occurred.)
 
-    SQLRETURN ret = 0;
     Py_ssize_t field_count, i;
-    PyObject** apValues;
+    SQLULEN iRow;
 
-    Py_BEGIN_ALLOW_THREADS
-    ret = SQLFetch(cur->hstmt);
-    Py_END_ALLOW_THREADS
-
-    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
-    {
-        // The connection was closed by another thread in the ALLOW_THREADS block above.
-        return RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
-    }
-
-    if (ret == SQL_NO_DATA)
+    if (!Cursor_FetchRow(cur, &iRow))
         return 0;
 
-    if (!SQL_SUCCEEDED(ret))
-        return RaiseErrorFromHandle("SQLFetch", cur->cnxn->hdbc, cur->hstmt);
+    INT64 start = Stats_Start(cur);
+    INT64 odbc_ns = cur->odbc_ns;
 
     field_count = PyTuple_GET_SIZE(cur->description);
 
-    apValues = (PyObject**)pyodbc_malloc(sizeof(PyObject*) * field_count);
+    Row* row = Row_New(cur->description, cur->map_name_to_index, field_count);
+    if (row == 0)
+        return 0;
 
-    if (apValues == 0)
-        return PyErr_NoMemory();
+    // Binding stops at the first column that can't be bound, so if the last one is bound, they all are.
+    if (cur->lazy_rows && cur->rowset_size != 0 && field_count != 0 && cur->colinfos[field_count - 1].data != 0)
+    {
+        row->block = RowBlock_Get(cur);
+        if (row->block == 0)
+        {
+            Py_DECREF(row);
+            return 0;
+        }
+        row->iRow = iRow;
+        Stats_EndRows(cur, start, odbc_ns);
+        return (PyObject*)row;
+    }
 
     for (i = 0; i < field_count; i++)
     {
-        PyObject* value = GetData(cur, i);
+        PyObject* value = cur->colinfos[i].reader(cur, i, iRow);
 
         if (!value)
         {
-            FreeRowValues(i, apValues);
+            Py_DECREF(row);
             return 0;
         }
 
-        apValues[i] = value;
+        row->apValues[i] = value;
     }
 
-    return (PyObject*)Row_New(cur->description, cur->map_name_to_index, field_count, apValues);
+    Stats_EndRows(cur, start, odbc_ns);
+    return (PyObject*)row;
 }
 
 
@@ -1164,6 +1786,57 @@ static PyObject* Cursor_fetchmany(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* Cursor_fetchnumpy(PyObject* self, PyObject* args)
+{
+    long rows = -1;
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_RESULTS | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    if (!PyArg_ParseTuple(args, "|l", &rows))
+        return 0;
+
+    if (rows < -1)
+        rows = -1;
+
+    return FetchNumPy(cursor, rows);
+}
+
+
+static PyObject* Cursor_fetcharrow(PyObject* self, PyObject* args)
+{
+    PyObject* pArray;
+    PyObject* pSchema;
+    long rows = -1;
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_RESULTS | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    if (!PyArg_ParseTuple(args, "OO|l", &pArray, &pSchema, &rows))
+        return 0;
+
+    ArrowArray*  array  = (ArrowArray*)PyLong_AsVoidPtr(pArray);
+    ArrowSchema* schema = array ? (ArrowSchema*)PyLong_AsVoidPtr(pSchema) : 0;
+    if (!array || !schema)
+    {
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_ValueError, "The array and schema must be the addresses of ArrowArray and ArrowSchema structures.");
+        return 0;
+    }
+
+    if (rows < -1)
+        rows = -1;
+
+    Py_ssize_t count = FetchArrow(cursor, rows, array, schema);
+    if (count == -1)
+        return 0;
+
+    return PyInt_FromLong((long)count);
+}
+
+
 static char tables_doc[] =
     "C.tables(table=None, catalog=None, schema=None, tableType=None) --> self\n"
     "\n"
@@ -1215,10 +1888,7 @@ static PyObject* Cursor_tables(PyObject* self, PyObject* args, PyObject* kwargs)
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1283,10 +1953,7 @@ static PyObject* Cursor_columns(PyObject* self, PyObject* args, PyObject* kwargs
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1359,10 +2026,7 @@ static PyObject* Cursor_statistics(PyObject* self, PyObject* args, PyObject* kwa
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1435,10 +2099,7 @@ static PyObject* _specialColumns(PyObject* self, PyObject* args, PyObject* kwarg
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1503,10 +2164,7 @@ static PyObject* Cursor_primaryKeys(PyObject* self, PyObject* args, PyObject* kw
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1575,10 +2233,7 @@ static PyObject* Cursor_foreignKeys(PyObject* self, PyObject* args, PyObject* kw
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1642,10 +2297,7 @@ static PyObject* Cursor_getTypeInfo(PyObject* self, PyObject* args, PyObject* kw
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1665,6 +2317,8 @@ static PyObject* Cursor_nextset(PyObject* self, PyObject* args)
 
     SQLRETURN ret = 0;
 
+    Prefetch_Stop(cur);
+
     Py_BEGIN_ALLOW_THREADS
     ret = SQLMoreResults(cur->hstmt);
     Py_END_ALLOW_THREADS
@@ -1693,10 +2347,7 @@ static PyObject* Cursor_nextset(PyObject* self, PyObject* args)
     {
         // A result set was created.
 
-        if (!PrepareResults(cur, cCols))
-            return 0;
-
-        if (!create_name_map(cur, cCols, lowercase()))
+        if (!PrepareResults(cur, cCols, lowercase(), false))
             return 0;
     }
 
@@ -1770,10 +2421,7 @@ static PyObject* Cursor_procedureColumns(PyObject* self, PyObject* args, PyObjec
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1828,10 +2476,7 @@ static PyObject* Cursor_procedures(PyObject* self, PyObject* args, PyObject* kwa
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLNumResultCols", cur->cnxn->hdbc, cur->hstmt);
 
-    if (!PrepareResults(cur, cCols))
-        return 0;
-
-    if (!create_name_map(cur, cCols, true))
+    if (!PrepareResults(cur, cCols, true, false))
         return 0;
 
     // Return the cursor so the results can be iterated over directly.
@@ -1857,20 +2502,85 @@ static PyObject* Cursor_skip(PyObject* self, PyObject* args)
     if (count == 0)
         Py_RETURN_NONE;
 
+    cursor->row_serial++;
+
     // Note: I'm not sure about the performance implications of looping here -- I certainly would rather use
     // SQLFetchScroll(SQL_FETCH_RELATIVE, count), but it requires scrollable cursors which are often slower.  I would
     // not expect skip to be used in performance intensive code since different SQL would probably be the "right"
     // answer instead of skip anyway.
 
+    if (cursor->prefetcher)
+    {
+        // The prefetch thread owns the HSTMT, so let it fetch the rows being skipped.
+        SQLULEN iRow;
+        while (count > 0 && Cursor_FetchRow(cursor, &iRow))
+            count--;
+        if (PyErr_Occurred())
+            return 0;
+        Py_RETURN_NONE;
+    }
+
+    if (cursor->rowset_size != 0)
+    {
+        // When block fetching, skip the rows already in the fetch buffer first.  Each SQLFetchScroll below skips a
+        // whole rowset, and the rows remaining in the last one are left in the buffer.
+
+        SQLULEN cAvailable = cursor->rows_fetched - cursor->rowset_index;
+        SQLULEN cSkip = min((SQLULEN)count, cAvailable);
+        cursor->rowset_index += cSkip;
+        count -= (int)cSkip;
+    }
+
+    if (count > 0)
+    {
+        // Lazy rows may still need the rowset being replaced.
+        RowBlock_Detach(cursor, false);
+        Py_XDECREF(cursor->overflow_values);
+        cursor->overflow_values = 0;
+    }
+
     SQLRETURN ret = SQL_SUCCESS;
+    INT64 cFetches = 0;
+    int cSkip = count;
+    INT64 start = Stats_Start(cursor);
     Py_BEGIN_ALLOW_THREADS
-    for (int i = 0; i < count && SQL_SUCCEEDED(ret); i++)
+    while (count > 0 && SQL_SUCCEEDED(ret))
+    {
         ret = SQLFetchScroll(cursor->hstmt, SQL_FETCH_NEXT, 0);
+        cFetches++;
+        if (cursor->rowset_size == 0)
+        {
+            count--;
+        }
+        else if (SQL_SUCCEEDED(ret))
+        {
+            cursor->rowset_index = min((SQLULEN)count, cursor->rows_fetched);
+            count -= (int)cursor->rowset_index;
+        }
+        else
+        {
+            cursor->rows_fetched = 0;
+        }
+    }
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cursor, STATS_FETCH, start, cFetches);
+    Trace_Call(TRACE_SQLFETCHSCROLL, cursor->hstmt, ret, start, cSkip - count);
+
+    if (cursor->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return 0;
+    }
 
     if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
         return RaiseErrorFromHandle("SQLFetchScroll", cursor->cnxn->hdbc, cursor->hstmt);
 
+    // The rows left in the last rowset may include values that were too long for their bound buffers (see
+    // Cursor_FetchRow).
+    if (ret == SQL_SUCCESS_WITH_INFO && cursor->rowset_size != 0 && !GetData_ReadOverflow(cursor))
+        return 0;
+
     Py_RETURN_NONE;
 }
 
@@ -1903,7 +2613,12 @@ static char description_doc[] =
 
 static char arraysize_doc[] =
     "This read/write attribute specifies the number of rows to fetch at a time with\n" \
-    "fetchmany(). It defaults to 1 meaning to fetch a single row at a time.";
+    "fetchmany(). It defaults to 1 meaning to fetch a single row at a time.\n" \
+    "\n" \
+    "If it is greater than 1 when a query is executed, the results are fetched from\n" \
+    "the driver in blocks of up to this many rows using bound column buffers, which\n" \
+    "is much faster for large result sets.  Result sets with long columns, such as\n" \
+    "varchar(max) or text, are still fetched a row at a time.";
 
 static char connection_doc[] =
     "This read-only attribute return a reference to the Connection object on which\n" \
@@ -1972,12 +2687,251 @@ static int Cursor_setnoscan(PyObject* self, PyObject* value, void *closure)
         return -1;
     }
 
+    cursor->noscan = (noscan == SQL_NOSCAN_ON);
+
+    return 0;
+}
+
+static PyObject* Cursor_getfastexecmany(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    if (cursor->fast_executemany)
+        Py_RETURN_TRUE;
+
+    Py_RETURN_FALSE;
+}
+
+static int Cursor_setfastexecmany(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the fast_executemany attribute");
+        return -1;
+    }
+
+    cursor->fast_executemany = PyObject_IsTrue(value) != 0;
+    return 0;
+}
+
+static char fast_executemany_doc[] =
+    "If True, executemany binds arrays of parameters and sends up to 1000 rows with\n" \
+    "each execution instead of executing each row separately.  The values for each\n" \
+    "parameter must have the same type (or be None) to be sent together; rows that\n" \
+    "cannot be are executed one at a time.  Defaults to False.";
+
+static PyObject* Cursor_getlazyrows(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    if (cursor->lazy_rows)
+        Py_RETURN_TRUE;
+
+    Py_RETURN_FALSE;
+}
+
+static int Cursor_setlazyrows(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the lazyrows attribute");
+        return -1;
+    }
+
+    cursor->lazy_rows = PyObject_IsTrue(value) != 0;
+    return 0;
+}
+
+static char lazyrows_doc[] =
+    "If True, rows fetched in blocks (see arraysize) don't convert their values to\n" \
+    "Python objects until they are read, which saves time when only some of the\n" \
+    "columns are used.  Each row keeps the block it was fetched in (up to 4MB) until\n" \
+    "it is deleted or all of its values have been read, so keeping rows from many\n" \
+    "blocks keeps all of those blocks in memory.  Conversion errors are raised when\n" \
+    "the value is read.  Defaults to False.";
+
+static PyObject* Cursor_getstreamlobs(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    if (cursor->stream_lobs)
+        Py_RETURN_TRUE;
+
+    Py_RETURN_FALSE;
+}
+
+static int Cursor_setstreamlobs(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the streamlobs attribute");
+        return -1;
+    }
+
+    cursor->stream_lobs = PyObject_IsTrue(value) != 0;
+    return 0;
+}
+
+static char streamlobs_doc[] =
+    "If True, when the last column of the results is a long text or binary column\n" \
+    "(such as varchar(max) or varbinary(max)), its non-NULL values are returned as\n" \
+    "pyodbc.LobReader objects that read the value in chunks instead of strings.  A\n" \
+    "reader can only be used until the cursor moves to another row, so fetch rows\n" \
+    "with fetchone or by iterating.  Takes effect at the next execute.  Defaults to\n" \
+    "False.";
+
+static PyObject* Cursor_getprefetch(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    return PyInt_FromLong(cursor->prefetch);
+}
+
+static int Cursor_setprefetch(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the prefetch attribute");
+        return -1;
+    }
+
+    long count = PyInt_AsLong(value);
+    if (count == -1 && PyErr_Occurred())
+        return -1;
+    if (count < 0 || count > MAX_PREFETCH)
+    {
+        PyErr_Format(PyExc_ValueError, "prefetch must be between 0 and %d.", MAX_PREFETCH);
+        return -1;
+    }
+
+    cursor->prefetch = (int)count;
+    return 0;
+}
+
+static char prefetch_doc[] =
+    "This read/write attribute specifies the number of blocks of rows to fetch ahead\n" \
+    "in a background thread while the current block is being converted.  It\n" \
+    "defaults to 0, which disables prefetching, and can be at most 64.\n" \
+    "\n" \
+    "It only applies to block fetches, so arraysize must also be greater than 1, and\n" \
+    "is ignored for result sets with long columns.  Each block uses up to 4MB.\n" \
+    "Changes take effect when the next query is executed.";
+
+static PyObject* Cursor_getparamchunksize(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return 0;
+
+    return PyInt_FromLong(cursor->param_chunk_size);
+}
+
+static int Cursor_setparamchunksize(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+
+    Cursor* cursor = Cursor_Validate(self, CURSOR_REQUIRE_OPEN | CURSOR_RAISE_ERROR);
+    if (!cursor)
+        return -1;
+
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the paramchunksize attribute");
+        return -1;
+    }
+
+    long size = PyInt_AsLong(value);
+    if (size == -1 && PyErr_Occurred())
+        return -1;
+    if (size < 1 || size > INT_MAX)
+    {
+        PyErr_SetString(PyExc_ValueError, "paramchunksize must be between 1 and INT_MAX.");
+        return -1;
+    }
+
+    cursor->param_chunk_size = (int)size;
     return 0;
 }
 
+static char paramchunksize_doc[] =
+    "The number of bytes sent to the driver at a time for parameters that are sent\n" \
+    "during execute: long strings, and binary data from memoryviews, file-like\n" \
+    "objects, and iterators.\n" \
+    "\n" \
+    "A file-like object parameter (one with a read method) is read up to this many\n" \
+    "bytes at a time, using readinto if it has it, and an iterator parameter (such\n" \
+    "as a generator) must return bytes objects.  Neither is read into memory all at\n" \
+    "once, and both are sent as long binary data without the length, which some\n" \
+    "drivers don't support.  Defaults to 65536.";
+
+static PyObject* Cursor_getstats(PyObject* self, void *closure)
+{
+    UNUSED(closure);
+    return Stats_Get(((Cursor*)self)->stats);
+}
+
+static int Cursor_setstats(PyObject* self, PyObject* value, void *closure)
+{
+    UNUSED(closure);
+    return Stats_Set(((Cursor*)self)->stats, value);
+}
+
+static char stats_doc[] =
+    "A pyodbc.Stats object that the cursor adds its statistics to, or None, the\n" \
+    "default, to not collect them.  Statistics are also added to the connection's\n" \
+    "stats object, if it has one.";
+
 static PyGetSetDef Cursor_getsetters[] =
 {
     {"noscan", Cursor_getnoscan, Cursor_setnoscan, "NOSCAN statement attr", 0},
+    {"fast_executemany", Cursor_getfastexecmany, Cursor_setfastexecmany, fast_executemany_doc, 0},
+    {"lazyrows", Cursor_getlazyrows, Cursor_setlazyrows, lazyrows_doc, 0},
+    {"streamlobs", Cursor_getstreamlobs, Cursor_setstreamlobs, streamlobs_doc, 0},
+    {"prefetch", Cursor_getprefetch, Cursor_setprefetch, prefetch_doc, 0},
+    {"paramchunksize", Cursor_getparamchunksize, Cursor_setparamchunksize, paramchunksize_doc, 0},
+    {"stats", Cursor_getstats, Cursor_setstats, stats_doc, 0},
     { 0 }
 };
 
@@ -2030,6 +2984,45 @@ static char fetchmany_doc[] =
     "A ProgrammingError exception is raised if the previous call to execute() did\n" \
     "not produce any result set or no call was issued yet.";
 
+static char fetchnumpy_doc[] =
+    "fetchnumpy(size=-1) --> dict of numpy.ma.MaskedArray\n" \
+    "\n" \
+    "Fetch up to `size` rows of a query result, or all remaining rows if size is -1,\n" \
+    "into a NumPy masked array per column, returned in a dictionary keyed by column\n" \
+    "name.  The mask is True where the value is NULL.\n" \
+    "\n" \
+    "Integer, floating point, bit, date, and timestamp columns are read directly into\n" \
+    "int32, int64, float64, bool, datetime64[D], and datetime64[us] arrays without\n" \
+    "creating Python objects.  Other columns, and columns with output converters,\n" \
+    "are returned as object arrays.  NumPy must be installed.\n" \
+    "\n" \
+    "A ProgrammingError exception is raised if the previous call to execute() did\n" \
+    "not produce any result set or no call was issued yet.";
+
+static char fetcharrow_doc[] =
+    "fetcharrow(array, schema, size=-1) --> int\n" \
+    "\n" \
+    "Fetch up to `size` rows of a query result, or all remaining rows if size is -1,\n" \
+    "into an Apache Arrow record batch and return the number of rows fetched.\n" \
+    "\n" \
+    "The batch is exported using the Arrow C Data Interface into the ArrowArray and\n" \
+    "ArrowSchema structures at the addresses `array` and `schema`, which the caller\n" \
+    "allocates and must release.  With pyarrow:\n" \
+    "\n" \
+    "  from pyarrow.cffi import ffi\n" \
+    "  c_array, c_schema = ffi.new('struct ArrowArray*'), ffi.new('struct ArrowSchema*')\n" \
+    "  pa, ps = int(ffi.cast('uintptr_t', c_array)), int(ffi.cast('uintptr_t', c_schema))\n" \
+    "  cursor.fetcharrow(pa, ps, 100000)\n" \
+    "  batch = pyarrow.RecordBatch._import_from_c(pa, ps)\n" \
+    "\n" \
+    "Integer, floating point, bit, date, time, and timestamp columns become int32,\n" \
+    "int64, float64, bool, date32, time64[us], and timestamp[us] arrays.  Decimals\n" \
+    "become decimal128 arrays, binary columns binary arrays, and all other columns\n" \
+    "UTF-8 string arrays.  Output converters are not used.\n" \
+    "\n" \
+    "A ProgrammingError exception is raised if the previous call to execute() did\n" \
+    "not produce any result set or no call was issued yet.";
+
 static PyMethodDef Cursor_methods[] =
 {
     { "close",            (PyCFunction)Cursor_close,            METH_NOARGS,                close_doc            },
@@ -2040,6 +3033,8 @@ static PyMethodDef Cursor_methods[] =
     { "fetchone",         (PyCFunction)Cursor_fetchone,         METH_NOARGS,                fetchone_doc         },
     { "fetchall",         (PyCFunction)Cursor_fetchall,         METH_NOARGS,                fetchall_doc         },
     { "fetchmany",        (PyCFunction)Cursor_fetchmany,        METH_VARARGS,               fetchmany_doc        },
+    { "fetchnumpy",       (PyCFunction)Cursor_fetchnumpy,       METH_VARARGS,               fetchnumpy_doc       },
+    { "fetcharrow",       (PyCFunction)Cursor_fetcharrow,       METH_VARARGS,               fetcharrow_doc       },
     { "nextset",          (PyCFunction)Cursor_nextset,          METH_NOARGS,                nextset_doc          },
     { "tables",           (PyCFunction)Cursor_tables,           METH_VARARGS|METH_KEYWORDS, tables_doc           },
     { "columns",          (PyCFunction)Cursor_columns,          METH_VARARGS|METH_KEYWORDS, columns_doc          },
@@ -2121,6 +3116,9 @@ PyTypeObject CursorType =
     0,                                                      // tp_weaklist
 };
 
+// The default Cursor.paramchunksize.
+static const int DEFAULT_PARAM_CHUNK_SIZE = 64 * 1024;
+
 Cursor*
 Cursor_New(Connection* cnxn)
 {
@@ -2138,18 +3136,53 @@ Cursor_New(Connection* cnxn)
     {
         cur->cnxn              = cnxn;
         cur->hstmt             = SQL_NULL_HANDLE;
+        cur->timeout           = 0;
+        cur->noscan            = false;
         cur->description       = Py_None;
         cur->pPreparedSQL      = 0;
         cur->paramcount        = 0;
         cur->paramtypes        = 0;
         cur->paramInfos        = 0;
+        cur->fast_executemany  = false;
+        cur->param_chunk_size  = DEFAULT_PARAM_CHUNK_SIZE;
         cur->colinfos          = 0;
         cur->arraysize         = 1;
         cur->rowcount          = -1;
         cur->map_name_to_index = 0;
+        cur->fetch_buffer      = 0;
+        cur->rowset_size       = 0;
+        cur->rows_fetched      = 0;
+        cur->rowset_index      = 0;
+        cur->row_status        = 0;
+        cur->prefetch          = 0;
+        cur->prefetcher        = 0;
+        cur->rowset_bytes      = 0;
+        cur->lazy_rows         = false;
+        cur->row_block         = 0;
+        cur->overflow_values   = 0;
+        cur->stream_lobs       = false;
+        cur->row_serial        = 0;
+        cur->stats             = 0;
+        cur->odbc_ns           = 0;
+
+        Arena_Init(cur->arena);
+
+        cur->cached_sql               = 0;
+        cur->cached_colinfos          = 0;
+        cur->cached_column_count      = 0;
+        cur->cached_description       = 0;
+        cur->cached_map_name_to_index = 0;
+        cur->cached_lower             = false;
+        cur->cached_conv_generation   = 0;
+        cur->cached_bound_types       = 0;
+        cur->cached_bound_types_count = 0;
+        cur->bound_types              = 0;
+        cur->bound_types_count        = 0;
+        cur->bound_types_capacity     = 0;
 
         Py_INCREF(cnxn);
         Py_INCREF(cur->description);
+        cnxn->cursor_count++;
 
         SQLRETURN ret;
         Py_BEGIN_ALLOW_THREADS
@@ -2175,6 +3208,8 @@ Cursor_New(Connection* cnxn)
                 Py_DECREF(cur);
                 return 0;
             }
+
+            cur->timeout = cnxn->timeout;
         }
 
         TRACE("cursor.new cnxn=%p hdbc=%d cursor=%p hstmt=%d\n", (Connection*)cur->cnxn, ((Connection*)cur->cnxn)->hdbc, cur, cur->hstmt);
@@ -15,6 +15,20 @@
 #define CURSOR_H
 
 struct Connection;
+struct Prefetcher;
+struct RowBlock;
+struct Stats;
+
+struct Cursor;
+struct ColumnInfo;
+
+// Returns the value of column `iCol` in the current row, or zero with an exception set.  When block fetching, `iRow`
+// is the row's index in the rowset.  Readers that use SQLGetData ignore it.
+typedef PyObject* (*ColumnReader)(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow);
+
+// Returns the value of row `iRow` in the buffers of a bound column, or zero with an exception set.  Unlike a
+// ColumnReader, it doesn't use the cursor, so it can also read rowsets kept by lazy rows (see rowblock.cpp).
+typedef PyObject* (*BoundReader)(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow);
 
 struct ColumnInfo
 {
@@ -32,6 +46,33 @@ struct ColumnInfo
     // of the integer types are the same size whether signed and unsigned, so we can allocate memory ahead of time
     // without knowing this.  We use this during the fetch when converting to a Python integer or long.
     bool is_unsigned;
+
+    // The C type the column is read as.  This is the SQLBindCol target type for bound columns and the SQLGetData
+    // target type for character and binary columns that are not.
+    SQLSMALLINT c_type;
+
+    // Block fetch information, set only when the column is bound with SQLBindCol (see BindResults in cursor.cpp).
+    // If `data` is zero, the column is not bound and values are read using SQLGetData.
+    //
+    // Otherwise, `data` points into the cursor's fetch_buffer and holds one element of `buffer_length` bytes for each
+    // row in the rowset.  `lengths` holds the length/indicator value for each row.
+    SQLLEN buffer_length;
+    char* data;
+    SQLLEN* lengths;
+
+    // The function that reads each value, chosen by GetColumnReader when the results are prepared so fetching does
+    // not need to examine the type of every value.
+    ColumnReader reader;
+
+    // The index into the connection's user-defined conversions used by `reader`, or -1 if there isn't one.
+    int conv_index;
+
+    // For bound columns, the function `reader` uses to convert the value.  Zero if the column is not bound.
+    BoundReader bound_reader;
+
+    // The length in bytes of the largest value GetDataString has read from the column in the current results.  Used to
+    // size the buffer when the driver doesn't report how long a value is.
+    SQLLEN max_length;
 };
 
 struct ParamInfo
@@ -42,20 +83,23 @@ struct ParamInfo
     SQLULEN     ColumnSize;
     SQLSMALLINT DecimalDigits;
 
-    // The value pointer that will be bound.  If `alloc` is true, this was allocated with malloc and must be freed.
-    // Otherwise it is zero or points into memory owned by the original Python parameter.
+    // The value pointer that will be bound.  This is zero, points into Data or memory owned by the original Python
+    // parameter, or was allocated from the cursor's arena.
     SQLPOINTER ParameterValuePtr;
 
     SQLLEN BufferLength;
     SQLLEN StrLen_or_Ind;
 
-    // If true, the memory in ParameterValuePtr was allocated via malloc and must be freed.
-    bool allocated;
-
     // The python object containing the parameter value.  A reference to this object should be held until we have
     // finished using memory owned by it.
     PyObject* pParam;
 
+#if PY_VERSION_HEX >= 0x02060000
+    // If non-zero, the view of pParam's memory for objects that export the buffer protocol, allocated from the arena.
+    // It is held until the info is freed so the object can't resize or release the memory while it is bound.
+    Py_buffer* pView;
+#endif
+
     // Optional data.  If used, ParameterValuePtr will point into this.
     union
     {
@@ -79,6 +123,11 @@ struct Cursor
     // Set to SQL_NULL_HANDLE when the cursor is closed.
     HSTMT hstmt;
 
+    // The query timeout and noscan attributes set on hstmt.  The statement cache moves HSTMTs between cursors, so a
+    // handle the cursor receives from it is given the connection's current timeout and the cursor's noscan setting.
+    intptr_t timeout;
+    bool noscan;
+
     //
     // SQL Parameters
     //
@@ -96,18 +145,33 @@ struct Cursor
     // allocated (length == paramcount) but all entries are set to SQL_UNKNOWN_TYPE.
     SQLSMALLINT* paramtypes;
 
-    // If non-zero, a pointer to a buffer containing the actual parameters bound.  If pPreparedSQL is zero, this should
-    // be freed using free and set to zero.
+    // If non-zero, a pointer to a buffer containing the actual parameters bound, allocated from `arena`.  It is released
+    // by FreeParameterData.
     //
     // Even if the same SQL statement is executed twice, the parameter bindings are redone from scratch since we try to
     // bind into the Python objects directly.
     ParamInfo* paramInfos;
 
+    // The C and SQL types (ValueType and ParameterType) of each parameter bound by the last PrepareAndBind, allocated
+    // via malloc with room for bound_types_capacity parameters.  Results of a statement can change type with its
+    // parameters (`select ?`), so cached results are only reused when the types match.  See PrepareResults.
+    SQLSMALLINT* bound_types;
+    int bound_types_count;
+    int bound_types_capacity;
+
+    // If true, executemany binds arrays of parameters and sends many rows with each SQLExecute.  See
+    // ExecuteParamArray.
+    bool fast_executemany;
+
+    // The number of bytes sent with each SQLPutData call for parameters sent at execution time (long values and
+    // streams).  A bytearray of this size is used to read streams that have a readinto method.
+    int param_chunk_size;
+
     //
     // Result Information
     //
 
-    // An array of ColumnInfos, allocated via malloc.  This will be zero when closed or when there are no query
+    // An array of ColumnInfos, allocated from `arena`.  This will be zero when closed or when there are no query
     // results.
     ColumnInfo* colinfos;
 
@@ -119,16 +183,119 @@ struct Cursor
     // The Cursor.rowcount attribute from the DB API specification.
     int rowcount;
 
-    // A dictionary that maps from column name (PyString) to index into the result columns (PyInteger).  This is
-    // constructued during an execute and shared with each row (reference counted) to implement accessing results by
-    // column name.
+    // A ColumnMap (see colmap.h) that maps from column name to index into the result columns.  This is constructued
+    // during an execute and shared with each row (reference counted) to implement accessing results by column name.
     //
     // This duplicates some ODBC functionality, but allows us to use Row objects after the statement is closed and
     // should use less memory than putting each column into the Row's __dict__.
     //
-    // Since this is shared by Row objects, it cannot be reused.  New dictionaries are created for every execute.  This
-    // will be zero whenever there are no results.
+    // Since this is shared by Row objects, it is never modified after it is created.  This will be zero whenever there
+    // are no results.
     PyObject* map_name_to_index;
+
+    //
+    // Cached Results
+    //
+    // The column information of the first result set of the prepared statement, kept so that executing the same
+    // statement again does not have to describe the columns and create a new description and name map.  It is reused
+    // when SQLNumResultCols reports the same number of columns.
+
+    // A reference to the pPreparedSQL the cached results are from, or zero if nothing is cached.  Since we hold a
+    // reference, the object can't be reused for another statement while it is cached.
+    PyObject* cached_sql;
+
+    // A copy of the ColumnInfos (allocated via malloc) before any columns were bound, and the number of them.
+    ColumnInfo* cached_colinfos;
+    int cached_column_count;
+
+    // A copy of bound_types when the results were cached, stored in the cached_colinfos allocation after the
+    // ColumnInfos.
+    SQLSMALLINT* cached_bound_types;
+    int cached_bound_types_count;
+
+    PyObject* cached_description;
+    PyObject* cached_map_name_to_index;
+
+    // The settings the description was created with.  See PrepareResults.
+    bool cached_lower;
+    int cached_conv_generation;
+
+    //
+    // Block Fetching
+    //
+
+    // If non-zero, the buffer (allocated via malloc) that result columns are bound into.  This is only used when
+    // arraysize is greater than 1 when the results are prepared.  The buffer is divided into a row status array and
+    // the column-wise `data` and `lengths` arrays of each bound ColumnInfo.
+    char* fetch_buffer;
+
+    // The number of rows each SQLFetch returns into fetch_buffer, zero when not block fetching.
+    SQLULEN rowset_size;
+
+    // The number of rows the last SQLFetch actually returned, set by the driver via SQL_ATTR_ROWS_FETCHED_PTR.
+    SQLULEN rows_fetched;
+
+    // The index of the next row in the rowset to be returned by a fetch.  When this reaches rows_fetched, the next
+    // rowset is fetched.
+    SQLULEN rowset_index;
+
+    // The row status array, set via SQL_ATTR_ROW_STATUS_PTR.  Points into fetch_buffer.
+    SQLUSMALLINT* row_status;
+
+    // The size of the current rowset, which starts at row_status and holds the bound columns' buffers.
+    size_t rowset_bytes;
+
+    // If true, rows fetched from rowsets with every column bound are lazy: each value is converted the first time it
+    // is read.  See rowblock.cpp.
+    bool lazy_rows;
+
+    // The RowBlock the lazy rows from the current rowset use, or zero if none have been created since it was fetched.
+    RowBlock* row_block;
+
+    // The values in the current rowset that were too long for their bound buffers, read with SQLGetData when it was
+    // fetched, or zero if there weren't any.  A dictionary keyed by the value's index in the rowset
+    // (iRow * column count + iCol).  See GetData_ReadOverflow.
+    PyObject* overflow_values;
+
+    // The number of rowsets to fetch ahead in a background thread (the Cursor.prefetch attribute).  Zero disables
+    // prefetching.
+    int prefetch;
+
+    // Set while the current results are being prefetched, in which case fetch_buffer holds prefetch + 1 rowsets and
+    // the ColumnInfos and row_status point into the current one.  See prefetch.cpp.
+    Prefetcher* prefetcher;
+
+    //
+    // LOB Streaming
+    //
+
+    // If true, a long text or binary column at the end of the results is returned as a LobReader instead of being
+    // read into a single object.  See lobreader.cpp.
+    bool stream_lobs;
+
+    // Incremented whenever the cursor moves to another row or frees its results, so a LobReader can tell that the row
+    // it reads from is no longer current.
+    unsigned long row_serial;
+
+    //
+    // Memory
+    //
+
+    // The memory needed until the next execute: the parameter infos and their converted values, and the ColumnInfos.
+    // It is reset when both paramInfos and colinfos have been released, which normally happens once per execute, so
+    // executing similar statements repeatedly reuses the same memory.
+    Arena arena;
+
+    //
+    // Statistics
+    //
+
+    // The Stats object assigned to Cursor.stats, or zero.  Statistics are also added to the connection's.  See
+    // stats.cpp.
+    Stats* stats;
+
+    // The total nanoseconds of the ODBC calls timed for the statistics, used to subtract them from the conversion time.
+    INT64 odbc_ns;
 };
 
 void Cursor_init();
@@ -136,4 +303,10 @@ void Cursor_init();
 Cursor* Cursor_New(Connection* cnxn);
 PyObject* Cursor_execute(PyObject* self, PyObject* args);
 
+/**
+ * Moves to the next row of the results and sets *piRow to the row's index in the rowset, which is passed to the column
+ * readers.  Returns false if there are no more rows, or with an exception set if an error occurs.
+ */
+bool Cursor_FetchRow(Cursor* cur, SQLULEN* piRow);
+
 #endif
@@ -10,6 +10,9 @@
 #include "dbspecific.h"
 #include "sqlwchar.h"
 #include "wrapper.h"
+#include "getdata.h"
+#include "stats.h"
+#include "lobreader.h"
 #include <datetime.h>
 
 void GetData_init()
@@ -17,6 +20,62 @@ void GetData_init()
     PyDateTime_IMPORT;
 }
 
+static SQLSMALLINT GetStringTargetType(Cursor* cur, SQLSMALLINT sql_type)
+{
+    // Returns the C type we read character and binary columns as: SQL_C_CHAR, SQL_C_WCHAR, or SQL_C_BINARY.
+
+    switch (sql_type)
+    {
+    case SQL_CHAR:
+    case SQL_VARCHAR:
+    case SQL_LONGVARCHAR:
+    case SQL_GUID:
+    case SQL_SS_XML:
+#if PY_MAJOR_VERSION < 3
+        if (cur->cnxn->unicode_results)
+            return SQL_C_WCHAR;
+        return SQL_C_CHAR;
+#else
+        UNUSED(cur);
+        return SQL_C_WCHAR;
+#endif
+
+    case SQL_WCHAR:
+    case SQL_WVARCHAR:
+    case SQL_WLONGVARCHAR:
+        return SQL_C_WCHAR;
+    }
+
+    return SQL_C_BINARY;
+}
+
+
+static PyObject* PythonFromText(SQLSMALLINT dataType, const char* buffer, SQLLEN cb)
+{
+    // Creates the Python object for `cb` bytes of character or binary data of type `dataType` (SQL_C_CHAR,
+    // SQL_C_WCHAR, or SQL_C_BINARY).
+
+    if (dataType == SQL_C_CHAR)
+        return PyBytes_FromStringAndSize(buffer, cb);
+
+    if (dataType == SQL_C_BINARY)
+    {
+#if PY_VERSION_HEX >= 0x02060000
+        return PyByteArray_FromStringAndSize(buffer, cb);
+#else
+        return PyBytes_FromStringAndSize(buffer, cb);
+#endif
+    }
+
+#if PY_VERSION_HEX < 0x03030000
+    if (sizeof(SQLWCHAR) == Py_UNICODE_SIZE)
+        return PyUnicode_FromUnicode((const Py_UNICODE*)buffer, cb / (SQLLEN)sizeof(SQLWCHAR));
+#endif
+
+    return PyUnicode_FromSQLWCHAR((const SQLWCHAR*)buffer, cb / (SQLLEN)sizeof(SQLWCHAR));
+}
+
+
 class DataBuffer
 {
     // Manages memory that GetDataString uses to read data in chunks.  We use the same function (GetDataString) to read
@@ -33,7 +92,8 @@ class DataBuffer
     // these are the same we can use a PyUnicode object so we don't have to allocate our own buffer and then the
     // Unicode object.  If they are not the same (e.g. OS/X where wchar_t-->4 Py_UNICODE-->2) then we need to maintain
     // our own buffer and pass it to the PyUnicode object later.  Many Linux distros are now using UCS4, so Py_UNICODE
-    // will be larger than SQLWCHAR.
+    // will be larger than SQLWCHAR.  Python 3.3+ strings don't hold Py_UNICODE, so we always use our own buffer and
+    // PyUnicode_FromSQLWCHAR decodes it into the final string.
     //
     // To reduce heap fragmentation, we perform the initial read into an array on the stack since we don't know the
     // length of the data.  If the data doesn't fit, this class then allocates new memory.  If the first read gives us
@@ -43,8 +103,8 @@ private:
     SQLSMALLINT dataType;
 
     char* buffer;
-    Py_ssize_t bufferSize;      // How big is the buffer.
-    int bytesUsed;              // How many elements have been read into the buffer?
+    SQLLEN bufferSize;          // How big is the buffer.
+    SQLLEN bytesUsed;           // How many bytes have been read into the buffer?
 
     PyObject* bufferOwner;      // If possible, we bind into a PyString, PyUnicode, or PyByteArray object.
     int element_size;           // How wide is each character: ASCII/ANSI -> 1, Unicode -> 2 or 4, binary -> 1
@@ -100,10 +160,20 @@ public:
         return bufferSize - bytesUsed;
     }
 
+    SQLLEN GetSize() const
+    {
+        return bufferSize;
+    }
+
+    SQLLEN GetUsed() const
+    {
+        return bytesUsed;
+    }
+
     void AddUsed(SQLLEN cbRead)
     {
         I(cbRead <= GetRemaining());
-        bytesUsed += (int)cbRead;
+        bytesUsed += cbRead;
     }
 
     bool AllocateMore(SQLLEN cbAdd)
@@ -138,17 +208,19 @@ public:
                 buffer      = bufferOwner ? PyBytes_AS_STRING(bufferOwner) : 0;
 #endif
             }
+#if PY_VERSION_HEX < 0x03030000
             else if (sizeof(SQLWCHAR) == Py_UNICODE_SIZE)
             {
                 // Allocate directly into a Unicode object.
                 bufferOwner = PyUnicode_FromUnicode(0, newSize / element_size);
                 buffer      = bufferOwner ? (char*)PyUnicode_AsUnicode(bufferOwner) : 0;
             }
+#endif
             else
             {
                 // We're Unicode, but SQLWCHAR and Py_UNICODE don't match, so maintain our own SQLWCHAR buffer.
                 bufferOwner = 0;
-                buffer      = (char*)pyodbc_malloc((size_t)newSize);
+                buffer      = (char*)pyodbc_malloc(ALLOC_GETDATA, (size_t)newSize);
             }
 
             if (buffer == 0)
@@ -156,7 +228,7 @@ public:
 
             usingStack = false;
 
-            memcpy(buffer, stackBuffer, (size_t)bufferSize);
+            memcpy(buffer, stackBuffer, (size_t)bytesUsed);
             bufferSize = newSize;
             return true;
         }
@@ -167,6 +239,16 @@ public:
                 return false;
             buffer = (char*)PyUnicode_AsUnicode(bufferOwner);
         }
+        else if (bufferOwner && PyBytes_CheckExact(bufferOwner))
+        {
+            if (_PyBytes_Resize(&bufferOwner, newSize) == -1)
+            {
+                // The object has been freed.
+                buffer = 0;
+                return false;
+            }
+            buffer = PyBytes_AS_STRING(bufferOwner);
+        }
 #if PY_VERSION_HEX >= 0x02060000
         else if (bufferOwner && PyByteArray_CheckExact(bufferOwner))
         {
@@ -174,17 +256,10 @@ public:
                 return false;
             buffer = PyByteArray_AS_STRING(bufferOwner);
         }
-#else
-        else if (bufferOwner && PyBytes_CheckExact(bufferOwner))
-        {
-            if (_PyBytes_Resize(&bufferOwner, newSize) == -1)
-                return false;
-            buffer = PyBytes_AS_STRING(bufferOwner);
-        }
 #endif
         else
         {
-            char* tmp = (char*)realloc(buffer, (size_t)newSize);
+            char* tmp = (char*)pyodbc_realloc(buffer, (size_t)newSize);
             if (tmp == 0)
                 return false;
             buffer = tmp;
@@ -203,24 +278,7 @@ public:
             Py_RETURN_NONE;
 
         if (usingStack)
-        {
-            if (dataType == SQL_C_CHAR)
-                return PyBytes_FromStringAndSize(buffer, bytesUsed);
-
-            if (dataType == SQL_C_BINARY)
-            {
-#if PY_VERSION_HEX >= 0x02060000
-                return PyByteArray_FromStringAndSize(buffer, bytesUsed);
-#else
-                return PyBytes_FromStringAndSize(buffer, bytesUsed);
-#endif
-            }
-
-            if (sizeof(SQLWCHAR) == Py_UNICODE_SIZE)
-                return PyUnicode_FromUnicode((const Py_UNICODE*)buffer, bytesUsed / element_size);
-
-            return PyUnicode_FromSQLWCHAR((const SQLWCHAR*)buffer, bytesUsed / element_size);
-        }
+            return PythonFromText(dataType, buffer, bytesUsed);
 
         if (bufferOwner && PyUnicode_CheckExact(bufferOwner))
         {
@@ -266,9 +324,14 @@ public:
 };
 
 
-static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol)
+// The largest declared column size, in characters or bytes, GetDataString uses to guess the length of a value when the
+// driver doesn't report it.  Larger columns, such as text and varchar(max), are usually far from full.
+static const SQLULEN MAX_GUESS_COLUMN_SIZE = 1024 * 1024;
+
+static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    // Returns a string, unicode, or bytearray object for character and binary data.
+    // Returns a string, unicode, or bytearray object for character and binary data.  The data is read as the column's
+    // c_type, which GetColumnReader sets to SQL_C_CHAR, SQL_C_WCHAR, or SQL_C_BINARY.
     //
     // In Python 2.6+, binary data is returned as a byte array.  Earlier versions will return an ASCII str object here
     // which will be wrapped in a buffer object by the caller.
@@ -291,54 +354,36 @@ static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol)
     //  1) Include NULL terminators in input buffer lengths.
     //  2) NULL terminators are not used in data lengths.
 
+    UNUSED(iRow);
+
     ColumnInfo* pinfo = &cur->colinfos[iCol];
+    SQLSMALLINT nTargetType = pinfo->c_type;
 
-    // Some Unix ODBC drivers do not return the correct length.
-    if (pinfo->sql_type == SQL_GUID)
-        pinfo->column_size = 36;
+    char tempBuffer[1024];
+    DataBuffer buffer(nTargetType, tempBuffer, sizeof(tempBuffer));
 
-    SQLSMALLINT nTargetType;
+    // When the driver doesn't report the length of a long value (SQL_NO_TOTAL), the first guess is the largest value
+    // read from the column so far or, if it is small enough to be worth allocating, its declared size.  After that the
+    // buffer doubles each time, so reading a value takes a handful of SQLGetData calls however long it is.
 
-    switch (pinfo->sql_type)
+    SQLLEN cbGuess = pinfo->max_length;
+    if (pinfo->column_size != 0 && pinfo->column_size <= MAX_GUESS_COLUMN_SIZE)
     {
-    case SQL_CHAR:
-    case SQL_VARCHAR:
-    case SQL_LONGVARCHAR:
-    case SQL_GUID:
-    case SQL_SS_XML:
-#if PY_MAJOR_VERSION < 3
-        if (cur->cnxn->unicode_results)
-            nTargetType  = SQL_C_WCHAR;
-        else
-            nTargetType  = SQL_C_CHAR;
-#else
-        nTargetType  = SQL_C_WCHAR;
-#endif
-
-        break;
-
-    case SQL_WCHAR:
-    case SQL_WVARCHAR:
-    case SQL_WLONGVARCHAR:
-        nTargetType  = SQL_C_WCHAR;
-        break;
-
-    default:
-        nTargetType  = SQL_C_BINARY;
-        break;
+        SQLLEN cbColumn = (SQLLEN)pinfo->column_size * (nTargetType == SQL_C_WCHAR ? (SQLLEN)sizeof(SQLWCHAR) : 1);
+        cbGuess = max(cbGuess, cbColumn);
     }
 
-    char tempBuffer[1024];
-    DataBuffer buffer(nTargetType, tempBuffer, sizeof(tempBuffer));
-
-    for (int iDbg = 0; iDbg < 10; iDbg++) // failsafe
+    for (;;)
     {
         SQLRETURN ret;
         SQLLEN cbData = 0;
 
+        INT64 start = Stats_Start(cur);
         Py_BEGIN_ALLOW_THREADS
         ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), nTargetType, buffer.GetBuffer(), buffer.GetRemaining(), &cbData);
-        Py_END_ALLOW_THREADS;
+        Py_END_ALLOW_THREADS
+        Stats_EndCall(cur, STATS_GETDATA, start);
+        Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
 
         if (cbData == SQL_NULL_DATA || (ret == SQL_SUCCESS && cbData < 0))
         {
@@ -375,7 +420,7 @@ static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol)
             {
                 // We don't know how much more, so just guess.
                 cbRead = cbBuffer - buffer.null_size;
-                cbMore = 2048;
+                cbMore = max(buffer.GetSize(), cbGuess - (buffer.GetUsed() + cbRead));
             }
             else if (cbData >= cbBuffer)
             {
@@ -393,6 +438,12 @@ static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol)
             }
 
             buffer.AddUsed(cbRead);
+            Stats_Bytes(cur, cbRead);
+
+            // Make sure the next call can make progress even if the driver's lengths are odd.
+            if (buffer.GetRemaining() + cbMore <= buffer.null_size)
+                cbMore = buffer.GetSize();
+
             if (!buffer.AllocateMore(cbMore))
                 return PyErr_NoMemory();
         }
@@ -400,26 +451,37 @@ static PyObject* GetDataString(Cursor* cur, Py_ssize_t iCol)
         {
             // For some reason, the NULL terminator is used in intermediate buffers but not in this final one.
             buffer.AddUsed(cbData);
+            Stats_Bytes(cur, cbData);
         }
 
         if (ret == SQL_SUCCESS || ret == SQL_NO_DATA)
+        {
+            pinfo->max_length = max(pinfo->max_length, buffer.GetUsed());
             return buffer.DetachValue();
+        }
     }
-
-    // REVIEW: Add an error message.
-    return 0;
 }
 
 
-static PyObject* GetDataUser(Cursor* cur, Py_ssize_t iCol, int conv)
+static PyObject* GetDataUser(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    // conv
-    //   The index into the connection's user-defined conversions `conv_types`.
+    // Passes the column's data to the user-defined conversion that was registered when the results were prepared.
 
-    PyObject* value = GetDataString(cur, iCol);
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    PyObject* value = GetDataString(cur, iCol, iRow);
     if (value == 0)
         return 0;
 
+    // The conversions may have been changed since then, in which case we'll look again.
+    int conv = pinfo->conv_index;
+    if (conv >= cur->cnxn->conv_count || cur->cnxn->conv_types[conv] != pinfo->sql_type)
+    {
+        conv = GetUserConvIndex(cur, pinfo->sql_type);
+        if (conv == -1)
+            return value;
+    }
+
     PyObject* result = PyObject_CallFunction(cur->cnxn->conv_funcs[conv], "(O)", value);
     Py_DECREF(value);
     return result;
@@ -427,9 +489,9 @@ static PyObject* GetDataUser(Cursor* cur, Py_ssize_t iCol, int conv)
 
 
 #if PY_VERSION_HEX < 0x02060000
-static PyObject* GetDataBuffer(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataBuffer(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    PyObject* str = GetDataString(cur, iCol);
+    PyObject* str = GetDataString(cur, iCol, iRow);
 
     if (str == Py_None)
         return str;
@@ -447,7 +509,104 @@ static PyObject* GetDataBuffer(Cursor* cur, Py_ssize_t iCol)
 #endif
 
 
-static PyObject* GetDataDecimal(Cursor* cur, Py_ssize_t iCol)
+static PyObject* DecimalFromSQLWCHAR(SQLWCHAR* buffer, int cch)
+{
+    // Creates a Decimal from the zero-terminated text of a decimal or numeric column.  The text is modified in place.
+    //
+    // Remove non-digits and convert the databases decimal to a '.' (required by decimal ctor).
+    //
+    // We are assuming that the decimal point and digits fit within the size of SQLWCHAR.
+
+    for (int i = (cch - 1); i >= 0; i--)
+    {
+        if (buffer[i] == chDecimal)
+        {
+            // Must force it to use '.' since the Decimal class doesn't pay attention to the locale.
+            buffer[i] = '.';
+        }
+        else if ((buffer[i] < '0' || buffer[i] > '9') && buffer[i] != '-')
+        {
+            memmove(&buffer[i], &buffer[i] + 1, (cch - i) * sizeof(SQLWCHAR));
+            cch--;
+        }
+    }
+
+    I(buffer[cch] == 0);
+
+    Object str(PyUnicode_FromSQLWCHAR(buffer, cch));
+    if (!str)
+        return 0;
+
+    return PyObject_CallFunction(decimal_type, "O", str.Get());
+}
+
+
+// The number of characters read at a time for decimal and numeric columns and bound for them when block fetching.
+static const SQLLEN DECIMAL_BUFFER_CHARS = 100;
+
+static PyObject* GetDataLongDecimal(Cursor* cur, Py_ssize_t iCol, const SQLWCHAR* prefix)
+{
+    // Finishes reading a decimal too long for GetDataDecimal's buffer, which only happens when a driver reports the
+    // wrong precision.  `prefix` holds the DECIMAL_BUFFER_CHARS - 1 characters already read.  The buffer doubles until
+    // the rest fits.
+
+    SQLLEN cchBuffer = DECIMAL_BUFFER_CHARS * 2;
+    SQLLEN cchUsed = DECIMAL_BUFFER_CHARS - 1;
+
+    SQLWCHAR* buffer = (SQLWCHAR*)pyodbc_malloc(ALLOC_GETDATA, sizeof(SQLWCHAR) * cchBuffer);
+    if (buffer == 0)
+        return PyErr_NoMemory();
+    memcpy(buffer, prefix, sizeof(SQLWCHAR) * cchUsed);
+
+    for (;;)
+    {
+        SQLRETURN ret;
+        SQLLEN cbData = 0;
+        SQLLEN cbAvailable = (cchBuffer - cchUsed) * (SQLLEN)sizeof(SQLWCHAR);
+
+        INT64 start = Stats_Start(cur);
+        Py_BEGIN_ALLOW_THREADS
+        ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_WCHAR, &buffer[cchUsed], cbAvailable, &cbData);
+        Py_END_ALLOW_THREADS
+        Stats_EndCall(cur, STATS_GETDATA, start);
+        Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+        if (ret == SQL_NO_DATA)
+            break;
+
+        if (!SQL_SUCCEEDED(ret))
+        {
+            pyodbc_free(buffer);
+            return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+        }
+
+        if (ret == SQL_SUCCESS_WITH_INFO && (cbData == SQL_NO_TOTAL || cbData >= cbAvailable))
+        {
+            // The buffer was filled, less the NULL terminator.
+            cchUsed = cchBuffer - 1;
+            cchBuffer *= 2;
+            SQLWCHAR* pNew = (SQLWCHAR*)pyodbc_realloc(buffer, sizeof(SQLWCHAR) * cchBuffer);
+            if (pNew == 0)
+            {
+                pyodbc_free(buffer);
+                return PyErr_NoMemory();
+            }
+            buffer = pNew;
+            continue;
+        }
+
+        cchUsed += cbData / (SQLLEN)sizeof(SQLWCHAR);
+        break;
+    }
+
+    buffer[cchUsed] = 0;
+    PyObject* value = DecimalFromSQLWCHAR(buffer, (int)cchUsed);
+    pyodbc_free(buffer);
+    return value;
+}
+
+
+static PyObject* GetDataDecimal(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
     // The SQL_NUMERIC_STRUCT support is hopeless (SQL Server ignores scale on input parameters and output columns,
     // Oracle does something else weird, and many drivers don't support it at all), so we'll rely on the Decimal's
@@ -463,58 +622,45 @@ static PyObject* GetDataDecimal(Cursor* cur, Py_ssize_t iCol)
 
     // TODO: Is Unicode a good idea for Python 2.7?  We need to know which drivers support Unicode.
 
-    SQLWCHAR buffer[100];
+    UNUSED(iRow);
+
+    SQLWCHAR buffer[DECIMAL_BUFFER_CHARS];
     SQLLEN cbFetched = 0; // Note: will not include the NULL terminator.
 
     SQLRETURN ret;
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
     ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_WCHAR, buffer, sizeof(buffer), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    // Remove non-digits and convert the databases decimal to a '.' (required by decimal ctor).
-    //
-    // We are assuming that the decimal point and digits fit within the size of SQLWCHAR.
-
-    int cch = (int)(cbFetched / sizeof(SQLWCHAR));
-
-    for (int i = (cch - 1); i >= 0; i--)
-    {
-        if (buffer[i] == chDecimal)
-        {
-            // Must force it to use '.' since the Decimal class doesn't pay attention to the locale.
-            buffer[i] = '.';
-        }
-        else if ((buffer[i] < '0' || buffer[i] > '9') && buffer[i] != '-')
-        {
-            memmove(&buffer[i], &buffer[i] + 1, (cch - i) * sizeof(SQLWCHAR));
-            cch--;
-        }
-    }
-
-    I(buffer[cch] == 0);
-
-    Object str(PyUnicode_FromSQLWCHAR(buffer, cch));
-    if (!str)
-        return 0;
+    if (ret == SQL_SUCCESS_WITH_INFO && (cbFetched == SQL_NO_TOTAL || cbFetched >= (SQLLEN)sizeof(buffer)))
+        return GetDataLongDecimal(cur, iCol, buffer);
 
-    return PyObject_CallFunction(decimal_type, "O", str.Get());
+    return DecimalFromSQLWCHAR(buffer, (int)(cbFetched / sizeof(SQLWCHAR)));
 }
 
 
-static PyObject* GetDataBit(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataBit(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
+    UNUSED(iRow);
+
     SQLCHAR ch;
     SQLLEN cbFetched;
     SQLRETURN ret;
 
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
     ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_BIT, &ch, sizeof(ch), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
 
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
@@ -529,115 +675,162 @@ static PyObject* GetDataBit(Cursor* cur, Py_ssize_t iCol)
 }
 
 
-static PyObject* GetDataLong(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataLong(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    ColumnInfo* pinfo = &cur->colinfos[iCol];
+    UNUSED(iRow);
 
     SQLINTEGER value;
     SQLLEN cbFetched;
     SQLRETURN ret;
 
-    SQLSMALLINT nCType = pinfo->is_unsigned ? SQL_C_ULONG : SQL_C_LONG;
-
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
-    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), nCType, &value, sizeof(value), &cbFetched);
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_LONG, &value, sizeof(value), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    if (pinfo->is_unsigned)
-        return PyInt_FromLong(*(SQLINTEGER*)&value);
-
     return PyInt_FromLong(value);
 }
 
 
-static PyObject* GetDataLongLong(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataULong(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    ColumnInfo* pinfo = &cur->colinfos[iCol];
+    UNUSED(iRow);
 
-    SQLSMALLINT nCType = pinfo->is_unsigned ? SQL_C_UBIGINT : SQL_C_SBIGINT;
-    SQLBIGINT   value;
-    SQLLEN      cbFetched;
-    SQLRETURN   ret;
+    SQLUINTEGER value;
+    SQLLEN cbFetched;
+    SQLRETURN ret;
 
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
-    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), nCType, &value, sizeof(value), &cbFetched);
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_ULONG, &value, sizeof(value), &cbFetched);
     Py_END_ALLOW_THREADS
-
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    if (pinfo->is_unsigned)
-        return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)(SQLUBIGINT)value);
+    if (value <= (SQLUINTEGER)LONG_MAX)
+        return PyInt_FromLong((long)value);
+    return PyLong_FromUnsignedLong(value);
+}
+
+
+static PyObject* GetDataLongLong(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
+{
+    UNUSED(iRow);
+
+    SQLBIGINT value;
+    SQLLEN    cbFetched;
+    SQLRETURN ret;
+
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_SBIGINT, &value, sizeof(value), &cbFetched);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+    if (!SQL_SUCCEEDED(ret))
+        return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+
+    if (cbFetched == SQL_NULL_DATA)
+        Py_RETURN_NONE;
 
     return PyLong_FromLongLong((PY_LONG_LONG)value);
 }
 
 
-static PyObject* GetDataDouble(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataULongLong(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    double value;
-    SQLLEN cbFetched = 0;
-    SQLRETURN ret;
+    UNUSED(iRow);
+
+    SQLUBIGINT value;
+    SQLLEN     cbFetched;
+    SQLRETURN  ret;
 
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
-    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_DOUBLE, &value, sizeof(value), &cbFetched);
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_UBIGINT, &value, sizeof(value), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    return PyFloat_FromDouble(value);
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)value);
 }
 
 
-static PyObject* GetSqlServerTime(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetDataDouble(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    SQL_SS_TIME2_STRUCT value;
+    UNUSED(iRow);
 
+    double value;
     SQLLEN cbFetched = 0;
     SQLRETURN ret;
 
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
-    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_BINARY, &value, sizeof(value), &cbFetched);
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_DOUBLE, &value, sizeof(value), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    int micros = (int)(value.fraction / 1000); // nanos --> micros
-    return PyTime_FromTime(value.hour, value.minute, value.second, micros);
+    return PyFloat_FromDouble(value);
 }
 
 
-static PyObject* GetDataTimestamp(Cursor* cur, Py_ssize_t iCol)
+static PyObject* GetSqlServerTime(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    TIMESTAMP_STRUCT value;
+    UNUSED(iRow);
+
+    SQL_SS_TIME2_STRUCT value;
 
     SQLLEN cbFetched = 0;
     SQLRETURN ret;
 
+    INT64 start = Stats_Start(cur);
     Py_BEGIN_ALLOW_THREADS
-    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_TYPE_TIMESTAMP, &value, sizeof(value), &cbFetched);
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_BINARY, &value, sizeof(value), &cbFetched);
     Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
     if (!SQL_SUCCEEDED(ret))
         return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
 
     if (cbFetched == SQL_NULL_DATA)
         Py_RETURN_NONE;
 
-    switch (cur->colinfos[iCol].sql_type)
+    int micros = (int)(value.fraction / 1000); // nanos --> micros
+    return PyTime_FromTime(value.hour, value.minute, value.second, micros);
+}
+
+
+static PyObject* PythonFromTimestamp(const TIMESTAMP_STRUCT& value, SQLSMALLINT sql_type)
+{
+    // Creates a time, date, or datetime object, depending on `sql_type`, from a timestamp read as
+    // SQL_C_TYPE_TIMESTAMP.
+
+    switch (sql_type)
     {
     case SQL_TYPE_TIME:
     {
@@ -654,31 +847,567 @@ static PyObject* GetDataTimestamp(Cursor* cur, Py_ssize_t iCol)
 }
 
 
-int GetUserConvIndex(Cursor* cur, SQLSMALLINT sql_type)
+static PyObject* GetDataTimestamp(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
 {
-    // If this sql type has a user-defined conversion, the index into the connection's `conv_funcs` array is returned.
-    // Otherwise -1 is returned.
+    UNUSED(iRow);
 
-    for (int i = 0; i < cur->cnxn->conv_count; i++)
-        if (cur->cnxn->conv_types[i] == sql_type)
-            return i;
-    return -1;
-}
+    TIMESTAMP_STRUCT value;
 
+    SQLLEN cbFetched = 0;
+    SQLRETURN ret;
 
-PyObject* GetData(Cursor* cur, Py_ssize_t iCol)
-{
-    // Returns an object representing the value in the row/field.  If 0 is returned, an exception has already been set.
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), SQL_C_TYPE_TIMESTAMP, &value, sizeof(value), &cbFetched);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+    if (!SQL_SUCCEEDED(ret))
+        return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+
+    if (cbFetched == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PythonFromTimestamp(value, cur->colinfos[iCol].sql_type);
+}
+
+
+INT64 DaysFromCivil(int y, int m, int d)
+{
+    y -= (m <= 2);
+    INT64 era = (y >= 0 ? y : y - 399) / 400;
+    INT64 yoe = y - era * 400;
+    INT64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    INT64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+
+int GetUserConvIndex(Cursor* cur, SQLSMALLINT sql_type)
+{
+    // If this sql type has a user-defined conversion, the index into the connection's `conv_funcs` array is returned.
+    // Otherwise -1 is returned.
+
+    for (int i = 0; i < cur->cnxn->conv_count; i++)
+        if (cur->cnxn->conv_types[i] == sql_type)
+            return i;
+    return -1;
+}
+
+
+static PyObject* GetDataUnsupported(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
+{
+    UNUSED(iRow);
+
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+    return RaiseErrorV("HY106", ProgrammingError, "ODBC SQL type %d is not yet supported.  column-index=%zd  type=%d",
+                       (int)pinfo->sql_type, iCol, (int)pinfo->sql_type);
+}
+
+
+// The largest character or binary column we will bind for block fetching, in characters or bytes.  Anything larger
+// is read with SQLGetData so we don't allocate huge buffers for columns that are usually mostly empty.
+static const SQLULEN MAX_BOUND_COLUMN_SIZE = 8000;
+
+bool GetBindInfo(Cursor* cur, Py_ssize_t iCol)
+{
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    pinfo->c_type        = 0;
+    pinfo->buffer_length = 0;
+    pinfo->data          = 0;
+    pinfo->lengths       = 0;
+    pinfo->bound_reader  = 0;
+
+    // User-defined conversions are passed the raw bytes, which we only know how to read with SQLGetData.
+    if (GetUserConvIndex(cur, pinfo->sql_type) != -1)
+        return false;
+
+    switch (pinfo->sql_type)
+    {
+    case SQL_GUID:
+        // Some Unix ODBC drivers do not return the correct length.
+        pinfo->column_size = 36;
+        // fall through
+
+    case SQL_CHAR:
+    case SQL_VARCHAR:
+    case SQL_WCHAR:
+    case SQL_WVARCHAR:
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+        if (pinfo->column_size == 0 || pinfo->column_size > MAX_BOUND_COLUMN_SIZE)
+            return false;
+
+        pinfo->c_type = GetStringTargetType(cur, pinfo->sql_type);
+
+        if (pinfo->c_type == SQL_C_WCHAR)
+            pinfo->buffer_length = (SQLLEN)((pinfo->column_size + 1) * sizeof(SQLWCHAR));
+        else if (pinfo->c_type == SQL_C_CHAR)
+            // The column size is in characters but the driver may convert to a multibyte encoding.
+            pinfo->buffer_length = (SQLLEN)(pinfo->column_size * 4 + 1);
+        else
+            pinfo->buffer_length = (SQLLEN)pinfo->column_size;
+        return true;
+
+    case SQL_DECIMAL:
+    case SQL_NUMERIC:
+        if (decimal_type == 0)
+            return false;
+        pinfo->c_type        = SQL_C_WCHAR;
+        pinfo->buffer_length = DECIMAL_BUFFER_CHARS * sizeof(SQLWCHAR);
+        return true;
+
+    case SQL_BIT:
+        pinfo->c_type        = SQL_C_BIT;
+        pinfo->buffer_length = sizeof(SQLCHAR);
+        return true;
+
+    case SQL_TINYINT:
+    case SQL_SMALLINT:
+    case SQL_INTEGER:
+        pinfo->c_type        = pinfo->is_unsigned ? SQL_C_ULONG : SQL_C_LONG;
+        pinfo->buffer_length = sizeof(SQLINTEGER);
+        return true;
+
+    case SQL_BIGINT:
+        pinfo->c_type        = pinfo->is_unsigned ? SQL_C_UBIGINT : SQL_C_SBIGINT;
+        pinfo->buffer_length = sizeof(SQLBIGINT);
+        return true;
+
+    case SQL_REAL:
+    case SQL_FLOAT:
+    case SQL_DOUBLE:
+        pinfo->c_type        = SQL_C_DOUBLE;
+        pinfo->buffer_length = sizeof(double);
+        return true;
+
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIME:
+    case SQL_TYPE_TIMESTAMP:
+        pinfo->c_type        = SQL_C_TYPE_TIMESTAMP;
+        pinfo->buffer_length = sizeof(TIMESTAMP_STRUCT);
+        return true;
+
+    case SQL_SS_TIME2:
+        pinfo->c_type        = SQL_C_BINARY;
+        pinfo->buffer_length = sizeof(SQL_SS_TIME2_STRUCT);
+        return true;
+    }
+
+    // LONGVARCHAR, LONGVARBINARY, XML, and anything we don't recognize.
+    return false;
+}
+
+
+//
+// Bound column readers
+//
+// These read row `iRow` of the rowset most recently fetched into the cursor's fetch_buffer, or of a rowset kept by lazy
+// rows.  The column was bound as the C type chosen by GetBindInfo.
+//
+// Values too long for their buffers were read by GetData_ReadOverflow when the rowset was fetched, so the cursor and
+// RowBlock look for them in the overflow values before calling these.
+//
+
+inline const char* GetBoundValue(const ColumnInfo* pinfo, SQLULEN iRow)
+{
+    return pinfo->data + (iRow * pinfo->buffer_length);
+}
+
+
+static bool IsTruncated(const ColumnInfo* pinfo, SQLULEN iRow)
+{
+    // Returns true if the text or binary value in row `iRow` didn't fit in its buffer.
+
+    SQLLEN cbData = pinfo->lengths[iRow];
+    if (cbData == SQL_NO_TOTAL)
+        return true;
+
+    SQLLEN cbMax = pinfo->buffer_length;
+    if (pinfo->c_type == SQL_C_WCHAR)
+        cbMax -= sizeof(SQLWCHAR);
+    else if (pinfo->c_type == SQL_C_CHAR)
+        cbMax -= 1;
+
+    return cbData > cbMax;
+}
+
+
+static PyObject* ReadBoundString(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    SQLLEN cbData = pinfo->lengths[iRow];
+
+    if (cbData == SQL_NULL_DATA || (cbData < 0 && cbData != SQL_NO_TOTAL))
+    {
+        // See the FreeTDS note in GetDataString.
+        Py_RETURN_NONE;
+    }
+
+    if (IsTruncated(pinfo, iRow))
+    {
+        // GetData_ReadOverflow reads the truncated values, so the driver must not have reported this one.
+        return RaiseErrorV("01004", DataError, "Data for column %zd was truncated while block fetching.", iCol);
+    }
+
+#if PY_VERSION_HEX < 0x02060000
+    if (pinfo->c_type == SQL_C_BINARY)
+    {
+        Object str(PythonFromText(pinfo->c_type, GetBoundValue(pinfo, iRow), cbData));
+        if (!str)
+            return 0;
+        return PyBuffer_FromObject(str, 0, PyString_GET_SIZE(str.Get()));
+    }
+#endif
+    return PythonFromText(pinfo->c_type, GetBoundValue(pinfo, iRow), cbData);
+}
+
+
+static PyObject* ReadBoundDecimal(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    SQLLEN cbData = pinfo->lengths[iRow];
+    if (cbData == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    if (IsTruncated(pinfo, iRow))
+    {
+        // GetData_ReadOverflow reads the truncated values, so the driver must not have reported this one.
+        return RaiseErrorV("01004", DataError, "Data for column %zd was truncated while block fetching.", iCol);
+    }
+
+    // DecimalFromSQLWCHAR modifies the text, so copy it out of the bound buffer.
+    SQLWCHAR buffer[DECIMAL_BUFFER_CHARS];
+    int cch = (int)(cbData / sizeof(SQLWCHAR));
+    memcpy(buffer, GetBoundValue(pinfo, iRow), cch * sizeof(SQLWCHAR));
+    buffer[cch] = 0;
+    return DecimalFromSQLWCHAR(buffer, cch);
+}
+
+
+static PyObject* ReadBoundBit(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    if (*(const SQLCHAR*)GetBoundValue(pinfo, iRow) == SQL_TRUE)
+        Py_RETURN_TRUE;
+
+    Py_RETURN_FALSE;
+}
+
+
+static PyObject* ReadBoundLong(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PyInt_FromLong(*(const SQLINTEGER*)GetBoundValue(pinfo, iRow));
+}
+
+
+static PyObject* ReadBoundULong(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    SQLUINTEGER value = *(const SQLUINTEGER*)GetBoundValue(pinfo, iRow);
+    if (value <= (SQLUINTEGER)LONG_MAX)
+        return PyInt_FromLong((long)value);
+    return PyLong_FromUnsignedLong(value);
+}
+
+
+static PyObject* ReadBoundLongLong(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PyLong_FromLongLong((PY_LONG_LONG)*(const SQLBIGINT*)GetBoundValue(pinfo, iRow));
+}
+
+
+static PyObject* ReadBoundULongLong(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PyLong_FromUnsignedLongLong((unsigned PY_LONG_LONG)*(const SQLUBIGINT*)GetBoundValue(pinfo, iRow));
+}
+
+
+static PyObject* ReadBoundDouble(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PyFloat_FromDouble(*(const double*)GetBoundValue(pinfo, iRow));
+}
+
+
+static PyObject* ReadBoundTimestamp(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    return PythonFromTimestamp(*(const TIMESTAMP_STRUCT*)GetBoundValue(pinfo, iRow), pinfo->sql_type);
+}
+
+
+static PyObject* ReadBoundSqlServerTime(const ColumnInfo* pinfo, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (pinfo->lengths[iRow] == SQL_NULL_DATA)
+        Py_RETURN_NONE;
+
+    const SQL_SS_TIME2_STRUCT* value = (const SQL_SS_TIME2_STRUCT*)GetBoundValue(pinfo, iRow);
+    int micros = (int)(value->fraction / 1000); // nanos --> micros
+    return PyTime_FromTime(value->hour, value->minute, value->second, micros);
+}
+
+
+static BoundReader GetBoundReader(const ColumnInfo* pinfo)
+{
+    switch (pinfo->sql_type)
+    {
+    case SQL_WCHAR:
+    case SQL_WVARCHAR:
+    case SQL_CHAR:
+    case SQL_VARCHAR:
+    case SQL_GUID:
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+        return ReadBoundString;
+
+    case SQL_DECIMAL:
+    case SQL_NUMERIC:
+        return ReadBoundDecimal;
+
+    case SQL_BIT:
+        return ReadBoundBit;
+
+    case SQL_TINYINT:
+    case SQL_SMALLINT:
+    case SQL_INTEGER:
+        return pinfo->is_unsigned ? ReadBoundULong : ReadBoundLong;
+
+    case SQL_BIGINT:
+        return pinfo->is_unsigned ? ReadBoundULongLong : ReadBoundLongLong;
+
+    case SQL_REAL:
+    case SQL_FLOAT:
+    case SQL_DOUBLE:
+        return ReadBoundDouble;
+
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIME:
+    case SQL_TYPE_TIMESTAMP:
+        return ReadBoundTimestamp;
+
+    case SQL_SS_TIME2:
+        return ReadBoundSqlServerTime;
+    }
+
+    // GetBindInfo doesn't bind any other types.
+    I(false);
+    return 0;
+}
+
+
+static PyObject* GetBound(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (cur->overflow_values)
+    {
+        PyObject* value = GetData_GetOverflow(cur->overflow_values, PyTuple_GET_SIZE(cur->description), iCol, iRow);
+        if (value || PyErr_Occurred())
+            return value;
+    }
+
+    const ColumnInfo* pinfo = &cur->colinfos[iCol];
+    return pinfo->bound_reader(pinfo, iCol, iRow);
+}
+
+
+static PyObject* GetBoundString(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
+{
+    // The same as GetBound, but also counts the bytes read for the statistics.  (GetData_ReadOverflow counted the
+    // overflow values.)
+
+    if (cur->overflow_values)
+    {
+        PyObject* value = GetData_GetOverflow(cur->overflow_values, PyTuple_GET_SIZE(cur->description), iCol, iRow);
+        if (value || PyErr_Occurred())
+            return value;
+    }
+
+    const ColumnInfo* pinfo = &cur->colinfos[iCol];
+    PyObject* value = ReadBoundString(pinfo, iCol, iRow);
+    if (value != 0 && value != Py_None)
+        Stats_Bytes(cur, pinfo->lengths[iRow]);
+    return value;
+}
+
+
+bool GetData_ReadOverflow(Cursor* cur)
+{
+    // GetBindInfo sizes the bound buffers from the column sizes, but some drivers report sizes too small for the data
+    // and the results cached for a prepared statement keep the sizes described by its first execution, so a value can
+    // be truncated.  The driver reports it with SQL_SUCCESS_WITH_INFO (01004) from the fetch.
     //
-    // The data is assumed to be the default C type for the column's SQL type.
+    // Rather than fail, read each truncated value again using SQLSetPos to select its row and SQLGetData while the
+    // rowset is still the driver's current one.  (The prefetch thread stops after any fetch that doesn't return
+    // SQL_SUCCESS, so this is true when prefetching too.)  The values are stored as Python objects and the bound
+    // readers are skipped for them.
+
+    Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+
+    for (SQLULEN iRow = 0; iRow < cur->rows_fetched; iRow++)
+    {
+        if (cur->row_status[iRow] == SQL_ROW_ERROR || cur->row_status[iRow] == SQL_ROW_NOROW)
+            continue;
+
+        bool fPositioned = false;
+
+        for (Py_ssize_t iCol = 0; iCol < cCols; iCol++)
+        {
+            const ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+            if (pinfo->bound_reader != ReadBoundString && pinfo->bound_reader != ReadBoundDecimal)
+                continue;
+
+            SQLLEN cbData = pinfo->lengths[iRow];
+            if ((cbData < 0 && cbData != SQL_NO_TOTAL) || !IsTruncated(pinfo, iRow))
+                continue;
+
+            if (!fPositioned)
+            {
+                SQLRETURN ret;
+                Py_BEGIN_ALLOW_THREADS
+                ret = SQLSetPos(cur->hstmt, (SQLSETPOSIROW)(iRow + 1), SQL_POSITION, SQL_LOCK_NO_CHANGE);
+                Py_END_ALLOW_THREADS
+
+                if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+                {
+                    // The connection was closed by another thread in the ALLOW_THREADS block above.
+                    RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+                    return false;
+                }
+
+                if (!SQL_SUCCEEDED(ret))
+                {
+                    RaiseErrorFromHandle("SQLSetPos", cur->cnxn->hdbc, cur->hstmt);
+                    return false;
+                }
+
+                fPositioned = true;
+            }
+
+            // Columns must be read in order, which the loop does.
+
+            Object value;
+            if (pinfo->bound_reader == ReadBoundDecimal)
+                value.Attach(GetDataDecimal(cur, iCol, iRow));
+#if PY_VERSION_HEX < 0x02060000
+            else if (pinfo->c_type == SQL_C_BINARY)
+                value.Attach(GetDataBuffer(cur, iCol, iRow));
+#endif
+            else
+                value.Attach(GetDataString(cur, iCol, iRow));
+            if (!value)
+                return false;
+
+            if (cur->overflow_values == 0)
+            {
+                cur->overflow_values = PyDict_New();
+                if (cur->overflow_values == 0)
+                    return false;
+            }
+
+            Object key(PyInt_FromLong((long)(iRow * cCols + iCol)));
+            if (!key || PyDict_SetItem(cur->overflow_values, key, value) == -1)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+PyObject* GetData_GetOverflow(PyObject* overflow_values, Py_ssize_t cCols, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (overflow_values == 0)
+        return 0;
+
+    Object key(PyInt_FromLong((long)(iRow * cCols + iCol)));
+    if (!key)
+        return 0;
+
+    PyObject* value = PyDict_GetItem(overflow_values, key);
+    Py_XINCREF(value);
+    return value;
+}
+
+
+static bool IsLobColumn(Cursor* cur, Py_ssize_t iCol)
+{
+    // Returns true if the column can be returned as a LobReader: it is the last column and is a text or binary column
+    // that is too large to bind.
 
+    const ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    if (iCol != PyTuple_GET_SIZE(cur->description) - 1 || pinfo->data != 0)
+        return false;
+
+    switch (pinfo->sql_type)
+    {
+    case SQL_LONGVARCHAR:
+    case SQL_WLONGVARCHAR:
+    case SQL_LONGVARBINARY:
+    case SQL_SS_XML:
+        return true;
+
+    case SQL_CHAR:
+    case SQL_VARCHAR:
+    case SQL_WCHAR:
+    case SQL_WVARCHAR:
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+        // The "max" types report a size of zero or SQL_NO_TOTAL.
+        return pinfo->column_size == 0 || pinfo->column_size > MAX_BOUND_COLUMN_SIZE;
+    }
+
+    return false;
+}
+
+
+ColumnReader GetColumnReader(Cursor* cur, Py_ssize_t iCol)
+{
     ColumnInfo* pinfo = &cur->colinfos[iCol];
 
+    // Some Unix ODBC drivers do not return the correct length.
+    if (pinfo->sql_type == SQL_GUID)
+        pinfo->column_size = 36;
+
+    pinfo->max_length = 0;
+
     // First see if there is a user-defined conversion.
 
-    int conv_index = GetUserConvIndex(cur, pinfo->sql_type);
-    if (conv_index != -1)
-        return GetDataUser(cur, iCol, conv_index);
+    pinfo->conv_index = GetUserConvIndex(cur, pinfo->sql_type);
+    if (pinfo->conv_index != -1)
+    {
+        pinfo->c_type = GetStringTargetType(cur, pinfo->sql_type);
+        return GetDataUser;
+    }
+
+    if (pinfo->data)
+    {
+        pinfo->bound_reader = GetBoundReader(pinfo);
+        return (pinfo->bound_reader == ReadBoundString) ? GetBoundString : GetBound;
+    }
+
+    if (cur->stream_lobs && IsLobColumn(cur, iCol))
+    {
+        pinfo->c_type = GetStringTargetType(cur, pinfo->sql_type);
+        return GetDataLob;
+    }
 
     switch (pinfo->sql_type)
     {
@@ -695,13 +1424,15 @@ PyObject* GetData(Cursor* cur, Py_ssize_t iCol)
     case SQL_VARBINARY:
     case SQL_LONGVARBINARY:
 #endif
-        return GetDataString(cur, iCol);
+        pinfo->c_type = GetStringTargetType(cur, pinfo->sql_type);
+        return GetDataString;
 
 #if PY_VERSION_HEX < 0x02060000
     case SQL_BINARY:
     case SQL_VARBINARY:
     case SQL_LONGVARBINARY:
-        return GetDataBuffer(cur, iCol);
+        pinfo->c_type = SQL_C_BINARY;
+        return GetDataBuffer;
 #endif
 
     case SQL_DECIMAL:
@@ -710,35 +1441,34 @@ PyObject* GetData(Cursor* cur, Py_ssize_t iCol)
         if (decimal_type == 0)
             break;
 
-        return GetDataDecimal(cur, iCol);
+        return GetDataDecimal;
     }
 
     case SQL_BIT:
-        return GetDataBit(cur, iCol);
+        return GetDataBit;
 
     case SQL_TINYINT:
     case SQL_SMALLINT:
     case SQL_INTEGER:
-        return GetDataLong(cur, iCol);
+        return pinfo->is_unsigned ? GetDataULong : GetDataLong;
 
     case SQL_BIGINT:
-        return GetDataLongLong(cur, iCol);
+        return pinfo->is_unsigned ? GetDataULongLong : GetDataLongLong;
 
     case SQL_REAL:
     case SQL_FLOAT:
     case SQL_DOUBLE:
-        return GetDataDouble(cur, iCol);
-
+        return GetDataDouble;
 
     case SQL_TYPE_DATE:
     case SQL_TYPE_TIME:
     case SQL_TYPE_TIMESTAMP:
-        return GetDataTimestamp(cur, iCol);
+        return GetDataTimestamp;
 
     case SQL_SS_TIME2:
-        return GetSqlServerTime(cur, iCol);
+        return GetSqlServerTime;
     }
 
-    return RaiseErrorV("HY106", ProgrammingError, "ODBC SQL type %d is not yet supported.  column-index=%zd  type=%d",
-                       (int)pinfo->sql_type, iCol, (int)pinfo->sql_type);
+    // Report the error when the column is read, not when the statement is executed.
+    return GetDataUnsupported;
 }
@@ -4,12 +4,42 @@
 
 void GetData_init();
 
-PyObject* GetData(Cursor* cur, Py_ssize_t iCol);
-
 /**
  * If this sql type has a user-defined conversion, the index into the connection's `conv_funcs` array is returned.
  * Otherwise -1 is returned.
  */
 int GetUserConvIndex(Cursor* cur, SQLSMALLINT sql_type);
 
+/**
+ * Sets the c_type and buffer_length of the column's ColumnInfo for block fetching and returns true.  Returns false if
+ * the column cannot be bound and must be read using SQLGetData, such as LOBs and columns without a maximum size.
+ */
+bool GetBindInfo(Cursor* cur, Py_ssize_t iCol);
+
+/**
+ * Returns the function that Cursor_fetch uses to read the column's values, specialized for its type, signedness,
+ * binding, and any user-defined conversion.  Called once per result set, after GetBindInfo, since it also sets the
+ * ColumnInfo fields the reader uses.
+ */
+ColumnReader GetColumnReader(Cursor* cur, Py_ssize_t iCol);
+
+/**
+ * Called by Cursor_FetchRow when a block fetch returns SQL_SUCCESS_WITH_INFO.  Reads any values that were truncated
+ * because they didn't fit in their bound buffers using SQLSetPos and SQLGetData and stores them in the cursor's
+ * overflow_values.  Returns false with an exception set if they can't be read.
+ */
+bool GetData_ReadOverflow(Cursor* cur);
+
+/**
+ * Returns a new reference to the value GetData_ReadOverflow read for column `iCol` of row `iRow` in `overflow_values`
+ * (which may be zero), or zero if there isn't one.  Also returns zero, with an exception set, if an error occurs.
+ */
+PyObject* GetData_GetOverflow(PyObject* overflow_values, Py_ssize_t cCols, Py_ssize_t iCol, SQLULEN iRow);
+
+/**
+ * Returns the number of days from 1970-01-01 to the given date in the proleptic Gregorian calendar, which is how
+ * NumPy's datetime64 and Arrow's date types count days.
+ */
+INT64 DaysFromCivil(int year, int month, int day);
+
 #endif // _GETDATA_H_
@@ -0,0 +1,454 @@
+// LobReader, the file-like object returned for long text and binary values when Cursor.streamlobs is set.
+//
+// A LobReader doesn't hold the value.  It reads it with SQLGetData from the cursor's current row in chunks sized by
+// the caller, so a value larger than memory can be copied to a file or socket, and readinto reads binary data directly
+// into the caller's buffer.
+//
+// SQLGetData can only read the columns of a row in order and only while the cursor is on the row, so only the last
+// column of the results is streamed, and a reader can only be used until the cursor fetches another row, skips,
+// executes, or is closed.  Cursor.row_serial changes whenever any of those happen.
+//
+// When the row is fetched, GetDataLob calls SQLGetData with an empty buffer, which returns NULL values and the total
+// length, if the driver knows it, without reading any data.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "cursor.h"
+#include "connection.h"
+#include "errors.h"
+#include "sqlwchar.h"
+#include "wrapper.h"
+#include "stats.h"
+#include "lobreader.h"
+
+struct LobReader
+{
+    PyObject_HEAD
+
+    // The cursor whose current row the value is in, or zero after the reader is closed.
+    Cursor* cur;
+    Py_ssize_t iCol;
+
+    // The cursor's row_serial when the reader was created.
+    unsigned long serial;
+
+    // The C type the value is read as: SQL_C_CHAR, SQL_C_WCHAR, or SQL_C_BINARY.
+    SQLSMALLINT c_type;
+
+    // The length of the value in bytes (of c_type), or SQL_NO_TOTAL if the driver didn't report it.
+    SQLLEN length;
+
+    // Set once SQLGetData has returned all of the data.
+    bool finished;
+
+    // When reading text in chunks, a high surrogate at the end of a chunk is kept and returned with the low surrogate
+    // at the start of the next so the pair is decoded as one character.
+    bool has_carry;
+    SQLWCHAR carry;
+};
+
+// The size of the chunks `read()` uses to read the rest of a value whose length the driver didn't report.
+static const SQLLEN READ_ALL_CHUNK = 64 * 1024;
+
+inline SQLLEN ElementSize(LobReader* self)
+{
+    return (self->c_type == SQL_C_WCHAR) ? (SQLLEN)sizeof(SQLWCHAR) : 1;
+}
+
+inline SQLLEN NullSize(LobReader* self)
+{
+    // SQLGetData writes a NULL terminator after text data.
+    return (self->c_type == SQL_C_BINARY) ? 0 : ElementSize(self);
+}
+
+
+PyObject* GetDataLob(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow)
+{
+    UNUSED(iRow);
+
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    char ch;
+    SQLLEN cbData = 0;
+    SQLRETURN ret;
+
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol+1), pinfo->c_type, &ch, 0, &cbData);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        return RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+    }
+
+    if (!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA)
+        return RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+
+    // See the FreeTDS note in GetDataString.
+    if (cbData == SQL_NULL_DATA || (cbData < 0 && cbData != SQL_NO_TOTAL))
+        Py_RETURN_NONE;
+
+    LobReader* reader = PyObject_NEW(LobReader, &LobReaderType);
+    if (!reader)
+        return 0;
+
+    Py_INCREF(cur);
+    reader->cur       = cur;
+    reader->iCol      = iCol;
+    reader->serial    = cur->row_serial;
+    reader->c_type    = pinfo->c_type;
+    reader->length    = cbData;
+    reader->finished  = (ret != SQL_SUCCESS_WITH_INFO);  // an empty value is returned by the probe
+    reader->has_carry = false;
+    reader->carry     = 0;
+
+    return (PyObject*)reader;
+}
+
+
+static bool LobReader_Validate(LobReader* self)
+{
+    if (self->cur == 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on a closed LobReader");
+        return false;
+    }
+
+    if (self->serial != self->cur->row_serial || self->cur->hstmt == SQL_NULL_HANDLE)
+    {
+        RaiseErrorV(0, ProgrammingError, "The LobReader's row is no longer the cursor's current row.");
+        return false;
+    }
+
+    if (self->cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool ReadChunk(LobReader* self, char* pb, SQLLEN cbBuffer, SQLLEN& cbRead)
+{
+    // Reads the next chunk of the value into `pb`.  `cbBuffer` must have room for at least one element and the NULL
+    // terminator.  Sets `cbRead` to the number of bytes read, not including the NULL terminator, which is zero only
+    // if all of the data has been read.
+
+    cbRead = 0;
+
+    if (self->finished)
+        return true;
+
+    Cursor* cur = self->cur;
+    SQLLEN cbData = 0;
+    SQLRETURN ret;
+
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(self->iCol+1), self->c_type, pb, cbBuffer, &cbData);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (ret == SQL_NO_DATA)
+    {
+        self->finished = true;
+        return true;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+    // See GetDataString for how the lengths work.
+    SQLLEN cbAvailable = cbBuffer - NullSize(self);
+    cbAvailable -= cbAvailable % ElementSize(self);
+
+    if (ret == SQL_SUCCESS_WITH_INFO && (cbData == SQL_NO_TOTAL || cbData > cbAvailable))
+    {
+        cbRead = cbAvailable;
+    }
+    else
+    {
+        cbRead = max((SQLLEN)0, cbData);
+        self->finished = true;
+    }
+
+    Stats_Bytes(cur, cbRead);
+    return true;
+}
+
+
+static PyObject* ConvertChunk(LobReader* self, const char* pb, SQLLEN cb)
+{
+    if (self->c_type == SQL_C_WCHAR)
+        return PyUnicode_FromSQLWCHAR((const SQLWCHAR*)pb, cb / (SQLLEN)sizeof(SQLWCHAR));
+    return PyBytes_FromStringAndSize(pb, cb);
+}
+
+
+static char read_doc[] =
+    "read([size]) --> str | bytes\n" \
+    "\n" \
+    "Reads and returns up to `size` characters of text or bytes of binary data, or\n" \
+    "all of the remaining data if `size` is omitted or negative.  Returns an empty\n" \
+    "value when all of the data has been read.";
+
+static PyObject* LobReader_read(PyObject* o, PyObject* args)
+{
+    LobReader* self = (LobReader*)o;
+
+    long size = -1;
+    if (!PyArg_ParseTuple(args, "|l", &size))
+        return 0;
+
+    if (!LobReader_Validate(self))
+        return 0;
+
+    SQLLEN cbElement = ElementSize(self);
+    SQLLEN cbNull    = NullSize(self);
+
+    // The number of bytes of data to read.  A text chunk needs room for at least two elements so there is something
+    // to return when the last one is a high surrogate that is carried to the next chunk.
+    SQLLEN cbWanted;
+    if (size >= 0)
+    {
+        if (size == 0)
+            return ConvertChunk(self, "", 0);
+        cbWanted = (SQLLEN)size * cbElement;
+        if (self->c_type == SQL_C_WCHAR)
+            cbWanted = max(cbWanted, 2 * cbElement);
+    }
+    else
+    {
+        cbWanted = (self->length > 0) ? self->length + cbElement : READ_ALL_CHUNK;
+    }
+
+    SQLLEN cbCarry  = self->has_carry ? cbElement : 0;
+    SQLLEN cbBuffer = cbCarry + cbWanted;
+    char* pb = (char*)pyodbc_malloc(ALLOC_GETDATA, (size_t)(cbBuffer + cbNull));
+    if (!pb)
+        return PyErr_NoMemory();
+
+    SQLLEN cbUsed = 0;
+    if (self->has_carry)
+    {
+        memcpy(pb, &self->carry, sizeof(SQLWCHAR));
+        cbUsed = cbCarry;
+        self->has_carry = false;
+    }
+
+    for (;;)
+    {
+        SQLLEN cbRead;
+        if (!ReadChunk(self, pb + cbUsed, cbBuffer - cbUsed + cbNull, cbRead))
+        {
+            pyodbc_free(pb);
+            return 0;
+        }
+        cbUsed += cbRead;
+
+        // A single SQLGetData fills the buffer unless it reaches the end.
+        if (size >= 0 || self->finished)
+            break;
+
+        if (cbBuffer - cbUsed < cbElement)
+        {
+            SQLLEN cbNew = cbBuffer * 2;
+            char* pbNew = (char*)pyodbc_realloc(pb, (size_t)(cbNew + cbNull));
+            if (!pbNew)
+            {
+                pyodbc_free(pb);
+                return PyErr_NoMemory();
+            }
+            pb = pbNew;
+            cbBuffer = cbNew;
+        }
+    }
+
+    if (self->c_type == SQL_C_WCHAR && !self->finished && SQLWCHAR_SIZE == 2)
+    {
+        SQLWCHAR last = *(SQLWCHAR*)(pb + cbUsed - cbElement);
+        if (last >= 0xD800 && last <= 0xDBFF)
+        {
+            self->carry     = last;
+            self->has_carry = true;
+            cbUsed -= cbElement;
+        }
+    }
+
+    PyObject* result = ConvertChunk(self, pb, cbUsed);
+    pyodbc_free(pb);
+    return result;
+}
+
+
+static char readinto_doc[] =
+    "readinto(b) --> int\n" \
+    "\n" \
+    "Reads binary data directly into the writable buffer `b` (such as a bytearray or\n" \
+    "memoryview) and returns the number of bytes read, which is 0 when all of the\n" \
+    "data has been read.  Only supported for binary columns.";
+
+static PyObject* LobReader_readinto(PyObject* o, PyObject* args)
+{
+    LobReader* self = (LobReader*)o;
+
+    PyObject* b;
+    if (!PyArg_ParseTuple(args, "O", &b))
+        return 0;
+
+    if (!LobReader_Validate(self))
+        return 0;
+
+    if (self->c_type != SQL_C_BINARY)
+    {
+        PyErr_SetString(PyExc_TypeError, "readinto is only supported for binary columns");
+        return 0;
+    }
+
+    SQLLEN cbRead = 0;
+
+#if PY_VERSION_HEX >= 0x02060000
+    Py_buffer view;
+    if (PyObject_GetBuffer(b, &view, PyBUF_WRITABLE) == -1)
+        return 0;
+    bool success = (view.len == 0) || ReadChunk(self, (char*)view.buf, (SQLLEN)view.len, cbRead);
+    PyBuffer_Release(&view);
+#else
+    void* pv;
+    Py_ssize_t cb;
+    if (PyObject_AsWriteBuffer(b, &pv, &cb) == -1)
+        return 0;
+    bool success = (cb == 0) || ReadChunk(self, (char*)pv, (SQLLEN)cb, cbRead);
+#endif
+
+    if (!success)
+        return 0;
+
+    return PyInt_FromLong((long)cbRead);
+}
+
+
+static PyObject* LobReader_readable(PyObject* o, PyObject* args)
+{
+    UNUSED(o, args);
+    Py_RETURN_TRUE;
+}
+
+
+static char close_doc[] =
+    "close()\n" \
+    "\n" \
+    "Closes the reader.  The rest of the value is not read.";
+
+static PyObject* LobReader_close(PyObject* o, PyObject* args)
+{
+    UNUSED(args);
+    LobReader* self = (LobReader*)o;
+    Py_XDECREF(self->cur);
+    self->cur = 0;
+    Py_RETURN_NONE;
+}
+
+
+static PyObject* LobReader_getclosed(PyObject* o, void* closure)
+{
+    UNUSED(closure);
+    if (((LobReader*)o)->cur == 0)
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+
+static PyObject* LobReader_getlength(PyObject* o, void* closure)
+{
+    UNUSED(closure);
+    LobReader* self = (LobReader*)o;
+    if (self->length == SQL_NO_TOTAL)
+        Py_RETURN_NONE;
+    return PyInt_FromLong((long)(self->length / ElementSize(self)));
+}
+
+
+static void LobReader_dealloc(PyObject* o)
+{
+    LobReader* self = (LobReader*)o;
+    Py_XDECREF(self->cur);
+    PyObject_Del(o);
+}
+
+
+static PyMethodDef LobReader_methods[] =
+{
+    { "read",     LobReader_read,     METH_VARARGS, read_doc     },
+    { "readinto", LobReader_readinto, METH_VARARGS, readinto_doc },
+    { "readable", LobReader_readable, METH_NOARGS,  0            },
+    { "close",    LobReader_close,    METH_NOARGS,  close_doc    },
+    { 0, 0, 0, 0 }
+};
+
+
+static PyGetSetDef LobReader_getsetters[] =
+{
+    { "closed", LobReader_getclosed, 0, "True if the reader has been closed.", 0 },
+    { "length", LobReader_getlength, 0, "The length of the value in bytes or characters (UTF-16 code units for Unicode\n" \
+      "text), or None if the driver did not report it.", 0 },
+    { 0 }
+};
+
+
+static char lobreader_doc[] =
+    "A file-like object that reads a long text or binary value from the cursor's\n" \
+    "current row.  Returned for the last column of the results when the cursor's\n" \
+    "streamlobs attribute is True.  It can only be used until the cursor fetches\n" \
+    "another row, skips, executes, or is closed.";
+
+PyTypeObject LobReaderType =
+{
+    PyVarObject_HEAD_INIT(0, 0)
+    "pyodbc.LobReader",                                     // tp_name
+    sizeof(LobReader),                                      // tp_basicsize
+    0,                                                      // tp_itemsize
+    LobReader_dealloc,                                      // tp_dealloc
+    0,                                                      // tp_print
+    0,                                                      // tp_getattr
+    0,                                                      // tp_setattr
+    0,                                                      // tp_compare
+    0,                                                      // tp_repr
+    0,                                                      // tp_as_number
+    0,                                                      // tp_as_sequence
+    0,                                                      // tp_as_mapping
+    0,                                                      // tp_hash
+    0,                                                      // tp_call
+    0,                                                      // tp_str
+    0,                                                      // tp_getattro
+    0,                                                      // tp_setattro
+    0,                                                      // tp_as_buffer
+    Py_TPFLAGS_DEFAULT,                                     // tp_flags
+    lobreader_doc,                                          // tp_doc
+    0,                                                      // tp_traverse
+    0,                                                      // tp_clear
+    0,                                                      // tp_richcompare
+    0,                                                      // tp_weaklistoffset
+    0,                                                      // tp_iter
+    0,                                                      // tp_iternext
+    LobReader_methods,                                      // tp_methods
+    0,                                                      // tp_members
+    LobReader_getsetters,                                   // tp_getset
+};
@@ -0,0 +1,14 @@
+#ifndef _LOBREADER_H_
+#define _LOBREADER_H_
+
+struct Cursor;
+
+extern PyTypeObject LobReaderType;
+
+/**
+ * The ColumnReader used for a long text or binary column when Cursor.streamlobs is set.  Returns None if the value is
+ * NULL or a new LobReader that reads it with SQLGetData, or zero with an exception set.
+ */
+PyObject* GetDataLob(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow);
+
+#endif // _LOBREADER_H_
@@ -0,0 +1,419 @@
+// Cursor.fetchnumpy, which reads results into NumPy arrays.
+//
+// Numeric, bit, date, and timestamp values are copied from the fetch buffer (or read with SQLGetData) directly into a
+// C array for each column, so no Python objects are created for them.  Other columns are read with the column's reader
+// into object arrays.
+//
+// NumPy is imported when first needed, and the arrays are created using its Python API, so pyodbc does not need the
+// NumPy headers to build.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "npfetch.h"
+#include "cursor.h"
+#include "connection.h"
+#include "errors.h"
+#include "getdata.h"
+#include "stats.h"
+#include "wrapper.h"
+
+// The kind of array each column is read into.  The order matches NUMPY_DTYPES.
+enum
+{
+    NP_OBJECT,
+    NP_INT32,
+    NP_UINT32,
+    NP_INT64,
+    NP_UINT64,
+    NP_FLOAT64,
+    NP_BOOL,
+    NP_DATE,
+    NP_TIMESTAMP
+};
+
+static const char* NUMPY_DTYPES[] = { "O", "i4", "u4", "i8", "u8", "f8", "?", "M8[D]", "M8[us]" };
+
+// NumPy's NaT, used for NULL dates and timestamps.
+static const INT64 NAT = (INT64)((UINT64)1 << 63);
+
+struct NumPyColumn
+{
+    int kind;
+
+    // The C type values are read as, which is also the bound type if the column is bound (see GetBindInfo), and the
+    // size of each element in `values`.
+    SQLSMALLINT c_type;
+    size_t itemsize;
+
+    // The values read so far, one per row, and a byte per row that is 1 if the value is NULL.  NP_OBJECT values are
+    // PyObject pointers.
+    char* values;
+    char* mask;
+};
+
+
+static int GetNumPyKind(Cursor* cur, ColumnInfo* pinfo, SQLSMALLINT& c_type, size_t& itemsize)
+{
+    // Returns the kind of array a column is read into and the C type used to read it.
+
+    // User-defined conversions are given the column's raw value, so they have to be called.
+    if (GetUserConvIndex(cur, pinfo->sql_type) != -1)
+        return NP_OBJECT;
+
+    int kind = NP_OBJECT;
+
+    switch (pinfo->sql_type)
+    {
+    case SQL_TINYINT:
+    case SQL_SMALLINT:
+    case SQL_INTEGER:
+        kind     = pinfo->is_unsigned ? NP_UINT32 : NP_INT32;
+        c_type   = pinfo->is_unsigned ? SQL_C_ULONG : SQL_C_LONG;
+        itemsize = sizeof(SQLINTEGER);
+        break;
+
+    case SQL_BIGINT:
+        kind     = pinfo->is_unsigned ? NP_UINT64 : NP_INT64;
+        c_type   = pinfo->is_unsigned ? SQL_C_UBIGINT : SQL_C_SBIGINT;
+        itemsize = sizeof(SQLBIGINT);
+        break;
+
+    case SQL_REAL:
+    case SQL_FLOAT:
+    case SQL_DOUBLE:
+        kind     = NP_FLOAT64;
+        c_type   = SQL_C_DOUBLE;
+        itemsize = sizeof(double);
+        break;
+
+    case SQL_BIT:
+        kind     = NP_BOOL;
+        c_type   = SQL_C_BIT;
+        itemsize = sizeof(SQLCHAR);
+        break;
+
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIMESTAMP:
+        kind     = (pinfo->sql_type == SQL_TYPE_DATE) ? NP_DATE : NP_TIMESTAMP;
+        c_type   = SQL_C_TYPE_TIMESTAMP;
+        itemsize = sizeof(INT64);
+        break;
+    }
+
+    // A bound column must be read from the fetch buffer as the type it was bound as.
+    if (kind != NP_OBJECT && pinfo->data != 0 && pinfo->c_type != c_type)
+        kind = NP_OBJECT;
+
+    if (kind == NP_OBJECT)
+        itemsize = sizeof(PyObject*);
+
+    return kind;
+}
+
+
+static void StoreValue(NumPyColumn& col, char* dst, const void* src, SQLLEN ind)
+{
+    // Stores a value read as col.c_type, or the NULL value for the column's dtype if ind is SQL_NULL_DATA.  The mask
+    // is the authority on NULLs, but NaN and NaT are friendlier than zeros.
+
+    if (ind == SQL_NULL_DATA)
+    {
+        if (col.kind == NP_FLOAT64)
+        {
+            double nan = Py_HUGE_VAL * 0;
+            memcpy(dst, &nan, sizeof(double));
+        }
+        else if (col.kind == NP_DATE || col.kind == NP_TIMESTAMP)
+            memcpy(dst, &NAT, sizeof(INT64));
+        else
+            memset(dst, 0, col.itemsize);
+        return;
+    }
+
+    if (col.kind == NP_DATE || col.kind == NP_TIMESTAMP)
+    {
+        const TIMESTAMP_STRUCT* ts = (const TIMESTAMP_STRUCT*)src;
+        INT64 value = DaysFromCivil(ts->year, ts->month, ts->day);
+        if (col.kind == NP_TIMESTAMP)
+        {
+            value = ((value * 24 + ts->hour) * 60 + ts->minute) * 60 + ts->second;
+            value = value * 1000000 + ts->fraction / 1000;
+        }
+        memcpy(dst, &value, sizeof(INT64));
+        return;
+    }
+
+    memcpy(dst, src, col.itemsize);
+}
+
+
+static bool ReadValue(Cursor* cur, Py_ssize_t iCol, SQLULEN iRow, NumPyColumn& col, Py_ssize_t iValue)
+{
+    char* dst = col.values + col.itemsize * iValue;
+    ColumnInfo* pinfo = &cur->colinfos[iCol];
+
+    if (col.kind == NP_OBJECT)
+    {
+        PyObject* value = pinfo->reader(cur, iCol, iRow);
+        if (!value)
+            return false;
+        *(PyObject**)dst = value;
+        col.mask[iValue] = (value == Py_None);
+        return true;
+    }
+
+    if (pinfo->data != 0)
+    {
+        SQLLEN ind = pinfo->lengths[iRow];
+        StoreValue(col, dst, pinfo->data + iRow * pinfo->buffer_length, ind);
+        col.mask[iValue] = (ind == SQL_NULL_DATA);
+        return true;
+    }
+
+    union
+    {
+        SQLINTEGER l;
+        SQLBIGINT ll;
+        double d;
+        SQLCHAR bit;
+        TIMESTAMP_STRUCT ts;
+    } value;
+
+    SQLLEN ind;
+    SQLRETURN ret;
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetData(cur->hstmt, (SQLUSMALLINT)(iCol + 1), col.c_type, &value, sizeof(value), &ind);
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_GETDATA, start);
+    Trace_Call(TRACE_SQLGETDATA, cur->hstmt, ret, start);
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        RaiseErrorFromHandle("SQLGetData", cur->cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+    StoreValue(col, dst, &value, ind);
+    col.mask[iValue] = (ind == SQL_NULL_DATA);
+    return true;
+}
+
+
+static void FreeColumns(NumPyColumn* cols, Py_ssize_t cCols, Py_ssize_t cValues)
+{
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        if (cols[i].kind == NP_OBJECT && cols[i].values)
+        {
+            PyObject** values = (PyObject**)cols[i].values;
+            for (Py_ssize_t j = 0; j < cValues; j++)
+                Py_XDECREF(values[j]);
+        }
+        pyodbc_free(cols[i].values);
+        pyodbc_free(cols[i].mask);
+    }
+    pyodbc_free(cols);
+}
+
+
+static bool GrowColumns(NumPyColumn* cols, Py_ssize_t cCols, Py_ssize_t capacity)
+{
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        char* values = (char*)pyodbc_malloc(ALLOC_NUMPY, cols[i].itemsize * capacity);
+        char* mask   = (char*)pyodbc_malloc(ALLOC_NUMPY, capacity);
+        if (values == 0 || mask == 0)
+        {
+            pyodbc_free(values);
+            pyodbc_free(mask);
+            PyErr_NoMemory();
+            return false;
+        }
+
+        // Object columns are zeroed so FreeColumns can tell which values were read.
+        if (cols[i].kind == NP_OBJECT)
+            memset(values, 0, cols[i].itemsize * capacity);
+
+        // The capacity only doubles, so the old values always fit in the first half.
+        if (cols[i].values)
+        {
+            memcpy(values, cols[i].values, cols[i].itemsize * (capacity / 2));
+            memcpy(mask, cols[i].mask, capacity / 2);
+            pyodbc_free(cols[i].values);
+            pyodbc_free(cols[i].mask);
+        }
+
+        cols[i].values = values;
+        cols[i].mask   = mask;
+    }
+
+    return true;
+}
+
+
+static char* GetArrayData(PyObject* array)
+{
+    // Returns the address of a NumPy array's data from its __array_interface__, which is available without the C API.
+
+    Object iface(PyObject_GetAttrString(array, "__array_interface__"));
+    if (!iface)
+        return 0;
+
+    PyObject* data = PyDict_GetItemString(iface, "data");
+    if (data == 0 || !PyTuple_Check(data) || PyTuple_GET_SIZE(data) < 1)
+    {
+        PyErr_SetString(PyExc_TypeError, "Unexpected NumPy __array_interface__");
+        return 0;
+    }
+
+    return (char*)PyLong_AsVoidPtr(PyTuple_GET_ITEM(data, 0));
+}
+
+
+static PyObject* MakeArray(PyObject* numpy, const char* dtype, char* values, size_t itemsize, Py_ssize_t count, bool objects)
+{
+    // Creates a NumPy array of `count` values.  Object values are moved into the array (the references are stolen
+    // and the pointers zeroed).
+
+    Object array(PyObject_CallMethod(numpy, "empty", "(ls)", (long)count, dtype));
+    if (!array)
+        return 0;
+
+    if (count == 0)
+        return array.Detach();
+
+    char* data = GetArrayData(array);
+    if (data == 0)
+        return 0;
+
+    if (objects)
+    {
+        // numpy.empty fills object arrays with references to None.
+        PyObject** slots = (PyObject**)data;
+        PyObject** src   = (PyObject**)values;
+        for (Py_ssize_t i = 0; i < count; i++)
+        {
+            PyObject* old = slots[i];
+            slots[i] = src[i];
+            src[i] = 0;
+            Py_XDECREF(old);
+        }
+    }
+    else
+    {
+        memcpy(data, values, itemsize * count);
+    }
+
+    return array.Detach();
+}
+
+
+PyObject* FetchNumPy(Cursor* cur, Py_ssize_t max)
+{
+    Object numpy(PyImport_ImportModule("numpy"));
+    if (!numpy)
+        return 0;
+
+    Object ma(PyObject_GetAttrString(numpy, "ma"));
+    Object masked_array(ma ? PyObject_GetAttrString(ma, "masked_array") : 0);
+    if (!masked_array)
+        return 0;
+
+    Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+
+    NumPyColumn* cols = (NumPyColumn*)pyodbc_malloc(ALLOC_NUMPY, sizeof(NumPyColumn) * cCols);
+    if (cols == 0)
+        return PyErr_NoMemory();
+
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        cols[i].c_type   = 0;
+        cols[i].itemsize = 0;
+        cols[i].kind     = GetNumPyKind(cur, &cur->colinfos[i], cols[i].c_type, cols[i].itemsize);
+        cols[i].values   = 0;
+        cols[i].mask     = 0;
+    }
+
+    Py_ssize_t count = 0;
+    Py_ssize_t capacity = 0;
+
+    while (max == -1 || count < max)
+    {
+        SQLULEN iRow;
+        if (!Cursor_FetchRow(cur, &iRow))
+        {
+            if (PyErr_Occurred())
+            {
+                FreeColumns(cols, cCols, count);
+                return 0;
+            }
+            break;
+        }
+
+        INT64 start = Stats_Start(cur);
+        INT64 odbc_ns = cur->odbc_ns;
+
+        if (count == capacity)
+        {
+            capacity = capacity ? (capacity * 2) : 1024;
+            if (!GrowColumns(cols, cCols, capacity))
+            {
+                FreeColumns(cols, cCols, count);
+                return 0;
+            }
+        }
+
+        for (Py_ssize_t i = 0; i < cCols; i++)
+        {
+            if (!ReadValue(cur, i, iRow, cols[i], count))
+            {
+                // Object values for this row have already been stored in the earlier columns.
+                FreeColumns(cols, cCols, count + 1);
+                return 0;
+            }
+        }
+
+        Stats_EndRows(cur, start, odbc_ns);
+        count++;
+    }
+
+    Object result(PyDict_New());
+    Object kwargs(PyDict_New());
+    if (!result || !kwargs)
+    {
+        FreeColumns(cols, cCols, count);
+        return 0;
+    }
+
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        Object data(MakeArray(numpy, NUMPY_DTYPES[cols[i].kind], cols[i].values, cols[i].itemsize, count, cols[i].kind == NP_OBJECT));
+        Object mask(data ? MakeArray(numpy, "?", cols[i].mask, 1, count, false) : 0);
+        if (!mask || PyDict_SetItemString(kwargs, "mask", mask) == -1)
+        {
+            FreeColumns(cols, cCols, count);
+            return 0;
+        }
+
+        Object args(PyTuple_Pack(1, data.Get()));
+        Object array(args ? PyObject_Call(masked_array, args, kwargs) : 0);
+        PyObject* name = PyTuple_GET_ITEM(PyTuple_GET_ITEM(cur->description, i), 0);
+        if (!array || PyDict_SetItem(result, name, array) == -1)
+        {
+            FreeColumns(cols, cCols, count);
+            return 0;
+        }
+    }
+
+    FreeColumns(cols, cCols, count);
+
+    return result.Detach();
+}
@@ -0,0 +1,12 @@
+#ifndef _NPFETCH_H_
+#define _NPFETCH_H_
+
+struct Cursor;
+
+/**
+ * Implements Cursor.fetchnumpy: fetches up to `max` rows (all of them if -1) into a NumPy masked array for each
+ * column, returned in a dictionary keyed by column name.
+ */
+PyObject* FetchNumPy(Cursor* cur, Py_ssize_t max);
+
+#endif // _NPFETCH_H_
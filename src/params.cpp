@@ -9,6 +9,9 @@
 #include "errors.h"
 #include "dbspecific.h"
 #include "sqlwchar.h"
+#include "row.h"
+#include "stmtcache.h"
+#include "stats.h"
 #include <datetime.h>
 
 
@@ -21,13 +24,17 @@ static bool GetParamType(Cursor* cur, Py_ssize_t iParam, SQLSMALLINT& type);
 
 static void FreeInfos(ParamInfo* a, Py_ssize_t count)
 {
+    // Releases the parameter objects and buffer views.  The infos and any buffers they point to are in the cursor's
+    // arena.
+
     for (Py_ssize_t i = 0; i < count; i++)
     {
-        if (a[i].allocated)
-            pyodbc_free(a[i].ParameterValuePtr);
+#if PY_VERSION_HEX >= 0x02060000
+        if (a[i].pView)
+            PyBuffer_Release(a[i].pView);
+#endif
         Py_XDECREF(a[i].pParam);
     }
-    pyodbc_free(a);
 }
 
 #define _MAKESTR(n) case n: return #n
@@ -196,10 +203,9 @@ static bool GetUnicodeInfo(Cursor* cur, Py_ssize_t index, PyObject* param, Param
             // SQLWCHAR and Py_UNICODE are not the same size, so we need to allocate and copy a buffer.
             if (len > 0)
             {
-                info.ParameterValuePtr = SQLWCHAR_FromUnicode(pch, len);
+                info.ParameterValuePtr = SQLWCHAR_FromUnicode(cur->arena, pch, len);
                 if (info.ParameterValuePtr == 0)
                     return false;
-                info.allocated = true;
             }
             else
             {
@@ -338,9 +344,247 @@ static bool GetFloatInfo(Cursor* cur, Py_ssize_t index, PyObject* param, ParamIn
     return true;
 }
 
-static char* CreateDecimalString(long sign, PyObject* digits, long exp)
+//
+// Decimals
+//
+// Decimal parameters are bound as strings (see GetDecimalInfo), which are built from the sign, digits, and exponent.
+// Decimal.as_tuple would return these, but it creates a tuple and an integer object for every digit.  Instead, the pure
+// Python implementation of the decimal module (Python 2 and Python 3 before 3.3) keeps the digits in a string
+// attribute that is used directly, and the C implementation formats a string with str() that is parsed in place.
+// Either way, no object is created for each digit and the string that is bound comes from the cursor's arena.
+
+// The names of the pure Python Decimal attributes, or zero if Decimal is the C implementation.  Set by Params_init.
+static PyObject* decimal_sign_name;
+static PyObject* decimal_int_name;
+static PyObject* decimal_exp_name;
+
+struct DecimalParts
+{
+    bool negative;
+
+    // The ASCII digits without leading zeros (except for a single zero), which are not zero terminated.  They point
+    // into `owner` or the cursor's arena.
+    const char* digits;
+    long count;
+
+    long exp;
+
+    Object owner;
+};
+
+static bool RaiseDecimalError()
+{
+    // Only NaN and infinity have no digits.
+    PyErr_SetString(PyExc_ValueError, "Decimal parameters cannot be NaN or infinity.");
+    return false;
+}
+
+static bool GetAsciiChars(Cursor* cur, PyObject* s, const char*& pch, Py_ssize_t& cch)
+{
+    // Returns the characters of a bytes or Unicode object holding only ASCII characters.  Only Unicode objects that
+    // don't store their characters as bytes are copied (into the cursor's arena).  Returns false for other objects or
+    // characters with an exception set.
+
+    if (PyBytes_Check(s))
+    {
+        pch = PyBytes_AS_STRING(s);
+        cch = PyBytes_GET_SIZE(s);
+        return true;
+    }
+
+    if (PyUnicode_Check(s))
+    {
+#if PY_VERSION_HEX >= 0x03030000
+        if (PyUnicode_READY(s) == -1)
+            return false;
+
+        if (PyUnicode_IS_ASCII(s))
+        {
+            pch = (const char*)PyUnicode_DATA(s);
+            cch = PyUnicode_GET_LENGTH(s);
+            return true;
+        }
+#else
+        const Py_UNICODE* pU = PyUnicode_AS_UNICODE(s);
+        cch = PyUnicode_GET_SIZE(s);
+
+        char* p = (char*)Arena_Alloc(cur->arena, (size_t)cch + 1);
+        if (p == 0)
+        {
+            PyErr_NoMemory();
+            return false;
+        }
+
+        for (Py_ssize_t i = 0; i < cch; i++)
+        {
+            if (pU[i] >= 0x80)
+            {
+                PyErr_SetString(PyExc_ValueError, "Unexpected character in a Decimal.");
+                return false;
+            }
+            p[i] = (char)pU[i];
+        }
+
+        pch = p;
+        return true;
+#endif
+    }
+
+    PyErr_SetString(PyExc_ValueError, "Unexpected character in a Decimal.");
+    return false;
+}
+
+inline bool IsDigit(char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+static bool ParseDecimalString(Cursor* cur, const char* pch, Py_ssize_t cch, DecimalParts& parts)
+{
+    // Parses the str() of a Decimal: an optional sign, digits with an optional decimal point, and an optional exponent.
+    // The digits are copied into the arena without the decimal point if it is between two of them.
+
+    const char* p   = pch;
+    const char* end = pch + cch;
+
+    parts.negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        parts.negative = (*p++ == '-');
+
+    const char* first = p;
+    const char* point = 0;
+    for (; p < end; p++)
+    {
+        if (*p == '.' && point == 0)
+            point = p;
+        else if (!IsDigit(*p))
+            break;
+    }
+    const char* last = p;
+
+    long count = (long)(last - first) - (point ? 1 : 0);
+    if (count == 0)
+        return RaiseDecimalError();
+
+    long exp = 0;
+    if (p < end && (*p == 'E' || *p == 'e'))
+    {
+        p++;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative = (*p++ == '-');
+        if (p == end)
+            return RaiseDecimalError();
+
+        for (; p < end && IsDigit(*p); p++)
+        {
+            if (exp > 100000000)
+            {
+                PyErr_SetString(PyExc_OverflowError, "The Decimal's exponent is too large to bind.");
+                return false;
+            }
+            exp = exp * 10 + (*p - '0');
+        }
+
+        if (negative)
+            exp = -exp;
+    }
+
+    if (p != end)
+        return RaiseDecimalError();
+
+    if (point)
+        exp -= (long)(last - point - 1);
+
+    // Skip leading zeros, and the decimal point after them, keeping at least one digit.
+    while (count > 1 && (*first == '0' || *first == '.'))
+    {
+        if (*first == '0')
+            count--;
+        first++;
+    }
+
+    if (point && point >= first)
+    {
+        char* digits = (char*)Arena_Alloc(cur->arena, (size_t)count);
+        if (digits == 0)
+        {
+            PyErr_NoMemory();
+            return false;
+        }
+
+        char* d = digits;
+        for (p = first; p < last; p++)
+        {
+            if (*p != '.')
+                *d++ = *p;
+        }
+
+        parts.digits = digits;
+    }
+    else
+    {
+        parts.digits = first;
+    }
+
+    parts.count = count;
+    parts.exp   = exp;
+    return true;
+}
+
+static bool GetDecimalParts(Cursor* cur, PyObject* param, DecimalParts& parts)
+{
+    if (decimal_int_name)
+    {
+        // The pure Python implementation: _sign is 0 or 1, _int is a string of digits (a tuple of integers before
+        // Python 2.6, which is handled by the string), and _exp is an integer or a string for NaN and infinity.
+
+        Object sign(PyObject_GetAttr(param, decimal_sign_name));
+        Object exp(PyObject_GetAttr(param, decimal_exp_name));
+        parts.owner = PyObject_GetAttr(param, decimal_int_name);
+        if (!sign || !exp || !parts.owner)
+            return false;
+
+        if (PyBytes_Check(parts.owner) || PyUnicode_Check(parts.owner))
+        {
+#if PY_MAJOR_VERSION < 3
+            if (!PyInt_Check(exp) && !PyLong_Check(exp))
+#else
+            if (!PyLong_Check(exp))
+#endif
+                return RaiseDecimalError();
+
+            const char* pch;
+            Py_ssize_t  cch;
+            if (!GetAsciiChars(cur, parts.owner, pch, cch))
+                return false;
+
+            parts.negative = PyObject_IsTrue(sign) == 1;
+            parts.digits   = pch;
+            parts.count    = (long)cch;
+            parts.exp      = PyInt_AsLong(exp);
+            return !(parts.exp == -1 && PyErr_Occurred());
+        }
+    }
+
+    parts.owner = PyObject_Str(param);
+    if (!parts.owner)
+        return false;
+
+    const char* pch;
+    Py_ssize_t  cch;
+    if (!GetAsciiChars(cur, parts.owner, pch, cch))
+        return false;
+
+    return ParseDecimalString(cur, pch, cch, parts);
+}
+
+static char* CreateDecimalString(Cursor* cur, const DecimalParts& parts)
 {
-    long count = (long)PyTuple_GET_SIZE(digits);
+    long        sign   = parts.negative ? 1 : 0;
+    const char* digits = parts.digits;
+    long        count  = parts.count;
+    long        exp    = parts.exp;
 
     char* pch;
     int len;
@@ -350,16 +594,16 @@ static char* CreateDecimalString(long sign, PyObject* digits, long exp)
         // (1 2 3) exp = 2 --> '12300'
 
         len = sign + count + exp + 1; // 1: NULL
-        pch = (char*)pyodbc_malloc((size_t)len);
+        pch = (char*)Arena_Alloc(cur->arena, (size_t)len);
         if (pch)
         {
             char* p = pch;
             if (sign)
                 *p++ = '-';
-            for (long i = 0; i < count; i++)
-                *p++ = (char)('0' + PyInt_AS_LONG(PyTuple_GET_ITEM(digits, i)));
-            for (long i = 0; i < exp; i++)
-                *p++ = '0';
+            memcpy(p, digits, (size_t)count);
+            p += count;
+            memset(p, '0', (size_t)exp);
+            p += exp;
             *p = 0;
         }
     }
@@ -368,18 +612,17 @@ static char* CreateDecimalString(long sign, PyObject* digits, long exp)
         // (1 2 3) exp = -2 --> 1.23 : prec = 3, scale = 2
 
         len = sign + count + 2; // 2: decimal + NULL
-        pch = (char*)pyodbc_malloc((size_t)len);
+        pch = (char*)Arena_Alloc(cur->arena, (size_t)len);
         if (pch)
         {
             char* p = pch;
             if (sign)
                 *p++ = '-';
-            int i = 0;
-            for (; i < (count + exp); i++)
-                *p++ = (char)('0' + PyInt_AS_LONG(PyTuple_GET_ITEM(digits, i)));
+            memcpy(p, digits, (size_t)(count + exp));
+            p += count + exp;
             *p++ = '.';
-            for (; i < count; i++)
-                *p++ = (char)('0' + PyInt_AS_LONG(PyTuple_GET_ITEM(digits, i)));
+            memcpy(p, &digits[count + exp], (size_t)-exp);
+            p += -exp;
             *p++ = 0;
         }
     }
@@ -389,7 +632,7 @@ static char* CreateDecimalString(long sign, PyObject* digits, long exp)
 
         len = sign + -exp + 3; // 3: leading zero + decimal + NULL
 
-        pch = (char*)pyodbc_malloc((size_t)len);
+        pch = (char*)Arena_Alloc(cur->arena, (size_t)len);
         if (pch)
         {
             char* p = pch;
@@ -397,12 +640,10 @@ static char* CreateDecimalString(long sign, PyObject* digits, long exp)
                 *p++ = '-';
             *p++ = '0';
             *p++ = '.';
-
-            for (int i = 0; i < -(exp + count); i++)
-                *p++ = '0';
-
-            for (int i = 0; i < count; i++)
-                *p++ = (char)('0' + PyInt_AS_LONG(PyTuple_GET_ITEM(digits, i)));
+            memset(p, '0', (size_t)-(exp + count));
+            p += -(exp + count);
+            memcpy(p, digits, (size_t)count);
+            p += count;
             *p++ = 0;
         }
     }
@@ -418,15 +659,12 @@ static bool GetDecimalInfo(Cursor* cur, Py_ssize_t index, PyObject* param, Param
     // string.  Unfortunately, the Decimal class doesn't seem to have a way to force it to return a string without
     // exponents, so we'll have to build it ourselves.
 
-    Object t = PyObject_CallMethod(param, "as_tuple", 0);
-    if (!t)
+    DecimalParts parts;
+    if (!GetDecimalParts(cur, param, parts))
         return false;
 
-    long       sign   = PyInt_AsLong(PyTuple_GET_ITEM(t.Get(), 0));
-    PyObject*  digits = PyTuple_GET_ITEM(t.Get(), 1);
-    long       exp    = PyInt_AsLong(PyTuple_GET_ITEM(t.Get(), 2));
-
-    Py_ssize_t count = PyTuple_GET_SIZE(digits);
+    long count = parts.count;
+    long exp   = parts.exp;
 
     info.ValueType     = SQL_C_CHAR;
     info.ParameterType = SQL_NUMERIC;
@@ -454,13 +692,12 @@ static bool GetDecimalInfo(Cursor* cur, Py_ssize_t index, PyObject* param, Param
 
     I(info.ColumnSize >= (SQLULEN)info.DecimalDigits);
 
-    info.ParameterValuePtr = CreateDecimalString(sign, digits, exp);
+    info.ParameterValuePtr = CreateDecimalString(cur, parts);
     if (!info.ParameterValuePtr)
     {
         PyErr_NoMemory();
         return false;
     }
-    info.allocated = true;
 
     info.StrLen_or_Ind = (SQLINTEGER)strlen((char*)info.ParameterValuePtr);
 
@@ -528,6 +765,71 @@ static bool GetByteArrayInfo(Cursor* cur, Py_ssize_t index, PyObject* param, Par
 }
 #endif
 
+#if PY_VERSION_HEX >= 0x02060000
+static bool GetBufferViewInfo(Cursor* cur, Py_ssize_t index, PyObject* param, ParamInfo& info)
+{
+    // Objects that export the buffer protocol, such as memoryview, array.array, mmap, and numpy arrays.  The exported
+    // memory is never copied: it is bound directly or, if it is too long, sent from at execution time.  Only
+    // contiguous memory can be bound, which is checked here so the error is raised before anything is executed.
+
+    Py_buffer* view = (Py_buffer*)Arena_Alloc(cur->arena, sizeof(Py_buffer));
+    if (view == 0)
+    {
+        PyErr_NoMemory();
+        return false;
+    }
+
+    if (PyObject_GetBuffer(param, view, PyBUF_SIMPLE) == -1)
+        return false;
+
+    info.pView = view;
+
+    Py_ssize_t cb = view->len;
+
+    info.ValueType  = SQL_C_BINARY;
+    info.ColumnSize = (SQLUINTEGER)max(cb, 1);
+
+    if (cb <= cur->cnxn->binary_maxlength)
+    {
+        // An empty view may not have an address, which drivers reject even for zero bytes.
+        info.ParameterType     = SQL_VARBINARY;
+        info.ParameterValuePtr = view->buf ? view->buf : (SQLPOINTER)"";
+        info.BufferLength      = cb;
+        info.StrLen_or_Ind     = cb;
+    }
+    else
+    {
+        info.ParameterType     = SQL_LONGVARBINARY;
+        info.ParameterValuePtr = param;
+        info.BufferLength      = sizeof(PyObject*); // How big is ParameterValuePtr; ODBC copies it and gives it back in SQLParamData
+        info.StrLen_or_Ind     = SQL_LEN_DATA_AT_EXEC(cb);
+    }
+
+    return true;
+}
+#endif
+
+inline bool IsStream(PyObject* param)
+{
+    // File-like objects and iterators (such as generators) of bytes.  These are checked after every other type, since
+    // they aren't types but protocols.
+    return PyObject_HasAttrString(param, "read") || PyIter_Check(param);
+}
+
+static bool GetStreamInfo(Cursor* cur, Py_ssize_t index, PyObject* param, ParamInfo& info)
+{
+    // The data is read and sent in chunks at execution time (see PutParameterData in cursor.cpp), so its length isn't
+    // known and it is passed as SQL_DATA_AT_EXEC with no column size.
+
+    info.ValueType         = SQL_C_BINARY;
+    info.ParameterType     = SQL_LONGVARBINARY;
+    info.ParameterValuePtr = param;
+    info.ColumnSize        = 0;
+    info.BufferLength      = sizeof(PyObject*);
+    info.StrLen_or_Ind     = SQL_DATA_AT_EXEC;
+    return true;
+}
+
 static bool GetParameterInfo(Cursor* cur, Py_ssize_t index, PyObject* param, ParamInfo& info)
 {
     // Determines the type of SQL parameter that will be used for this parameter based on the Python data type.
@@ -583,6 +885,14 @@ static bool GetParameterInfo(Cursor* cur, Py_ssize_t index, PyObject* param, Par
         return GetBufferInfo(cur, index, param, info);
 #endif
 
+#if PY_VERSION_HEX >= 0x02060000
+    if (PyObject_CheckBuffer(param))
+        return GetBufferViewInfo(cur, index, param, info);
+#endif
+
+    if (IsStream(param))
+        return GetStreamInfo(cur, index, param, info);
+
     RaiseErrorV("HY105", ProgrammingError, "Invalid parameter type.  param-index=%zd param-type=%s", index, Py_TYPE(param)->tp_name);
     return false;
 }
@@ -617,7 +927,8 @@ bool BindParameter(Cursor* cur, Py_ssize_t index, ParamInfo& info)
 
 void FreeParameterData(Cursor* cur)
 {
-    // Unbinds the parameters and frees the parameter buffer.
+    // Unbinds the parameters and releases the parameter objects.  The parameter buffers are freed with the rest of the
+    // arena once there are no results using it.
 
     if (cur->paramInfos)
     {
@@ -632,6 +943,9 @@ void FreeParameterData(Cursor* cur)
         FreeInfos(cur->paramInfos, cur->paramcount);
         cur->paramInfos = 0;
     }
+
+    if (cur->colinfos == 0)
+        Arena_Reset(cur->arena);
 }
 
 void FreeParameterInfo(Cursor* cur)
@@ -646,8 +960,10 @@ void FreeParameterInfo(Cursor* cur)
     cur->paramcount   = 0;
 }
 
-bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool skip_first)
+static bool Prepare(Cursor* cur, PyObject* pSql)
 {
+    // Prepares the SQL if it is not already the prepared statement, setting pPreparedSQL and paramcount.
+
 #if PY_MAJOR_VERSION >= 3
     if (!PyUnicode_Check(pSql))
     {
@@ -656,22 +972,17 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
     }
 #endif
 
-    //
-    // Normalize the parameter variables.
-    //
-
-    // Since we may replace parameters (we replace objects with Py_True/Py_False when writing to a bit/bool column),
-    // allocate an array and use it instead of the original sequence
-
-    int        params_offset = skip_first ? 1 : 0;
-    Py_ssize_t cParams       = original_params == 0 ? 0 : PySequence_Length(original_params) - params_offset;
-
-    //
-    // Prepare the SQL if necessary.
-    //
-
     if (pSql != cur->pPreparedSQL)
     {
+        if (cur->cnxn->stmtcache_capacity != 0)
+        {
+            int result = StatementCache_Swap(cur, pSql);
+            if (result == STMTCACHE_ERROR)
+                return false;
+            if (result == STMTCACHE_HIT)
+                return true;
+        }
+
         FreeParameterInfo(cur);
 
         SQLRETURN ret = 0;
@@ -681,6 +992,7 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
         if (PyUnicode_Check(pSql))
         {
             SQLWChar sql(pSql);
+            INT64 start = Stats_Start(cur);
             Py_BEGIN_ALLOW_THREADS
             ret = SQLPrepareW(cur->hstmt, sql, SQL_NTS);
             if (SQL_SUCCEEDED(ret))
@@ -689,11 +1001,14 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
                 ret = SQLNumParams(cur->hstmt, &cParamsT);
             }
             Py_END_ALLOW_THREADS
+            Stats_EndCall(cur, STATS_PREPARE, start);
+            Trace_Call(TRACE_SQLPREPARE, cur->hstmt, ret, start);
         }
 #if PY_MAJOR_VERSION < 3
         else
         {
             TRACE("SQLPrepare(%s)\n", PyString_AS_STRING(pSql));
+            INT64 start = Stats_Start(cur);
             Py_BEGIN_ALLOW_THREADS
             ret = SQLPrepare(cur->hstmt, (SQLCHAR*)PyString_AS_STRING(pSql), SQL_NTS);
             if (SQL_SUCCEEDED(ret))
@@ -702,6 +1017,8 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
                 ret = SQLNumParams(cur->hstmt, &cParamsT);
             }
             Py_END_ALLOW_THREADS
+            Stats_EndCall(cur, STATS_PREPARE, start);
+            Trace_Call(TRACE_SQLPREPARE, cur->hstmt, ret, start);
         }
 #endif
 
@@ -724,6 +1041,56 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
         Py_INCREF(cur->pPreparedSQL);
     }
 
+    return true;
+}
+
+static bool SaveBoundTypes(Cursor* cur, Py_ssize_t cParams)
+{
+    // Records the ValueType and ParameterType of each parameter in cur->bound_types so PrepareResults can tell whether
+    // the cached results of the statement were described with parameters of the same types.
+
+    if (cParams > cur->bound_types_capacity)
+    {
+        SQLSMALLINT* pTypes = (SQLSMALLINT*)pyodbc_malloc(ALLOC_PARAMS, sizeof(SQLSMALLINT) * 2 * cParams);
+        if (pTypes == 0)
+        {
+            PyErr_NoMemory();
+            return false;
+        }
+        pyodbc_free(cur->bound_types);
+        cur->bound_types          = pTypes;
+        cur->bound_types_capacity = (int)cParams;
+    }
+
+    for (Py_ssize_t i = 0; i < cParams; i++)
+    {
+        cur->bound_types[i * 2]     = cur->paramInfos[i].ValueType;
+        cur->bound_types[i * 2 + 1] = cur->paramInfos[i].ParameterType;
+    }
+
+    cur->bound_types_count = (int)cParams;
+    return true;
+}
+
+bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool skip_first)
+{
+    //
+    // Normalize the parameter variables.
+    //
+
+    // Since we may replace parameters (we replace objects with Py_True/Py_False when writing to a bit/bool column),
+    // allocate an array and use it instead of the original sequence
+
+    int        params_offset = skip_first ? 1 : 0;
+    Py_ssize_t cParams       = original_params == 0 ? 0 : PySequence_Length(original_params) - params_offset;
+
+    //
+    // Prepare the SQL if necessary.
+    //
+
+    if (!Prepare(cur, pSql))
+        return false;
+
     if (cParams != cur->paramcount)
     {
         RaiseErrorV(0, ProgrammingError, "The SQL contains %d parameter markers, but %d parameters were supplied",
@@ -731,7 +1098,7 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
         return false;
     }
 
-    cur->paramInfos = (ParamInfo*)pyodbc_malloc(sizeof(ParamInfo) * cParams);
+    cur->paramInfos = (ParamInfo*)Arena_Alloc(cur->arena, sizeof(ParamInfo) * cParams);
     if (cur->paramInfos == 0)
     {
         PyErr_NoMemory();
@@ -756,6 +1123,13 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
         }
     }
 
+    if (!SaveBoundTypes(cur, cParams))
+    {
+        FreeInfos(cur->paramInfos, cParams);
+        cur->paramInfos = 0;
+        return false;
+    }
+
     for (Py_ssize_t i = 0; i < cParams; i++)
     {
         if (!BindParameter(cur, i, cur->paramInfos[i]))
@@ -769,6 +1143,361 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* original_params, bool
     return true;
 }
 
+//
+// Parameter Arrays
+//
+
+struct ParamArrayColumn
+{
+    // The SQLBindParameter values used for the entire column.
+    SQLSMALLINT ValueType;
+    SQLSMALLINT ParameterType;
+    SQLULEN     ColumnSize;
+    SQLSMALLINT DecimalDigits;
+
+    // The number of bytes each row uses in `data`.  This is also passed as the BufferLength.
+    SQLLEN cbElement;
+
+    // The column-wise value and length / indicator arrays.  Both point into the buffer allocated by
+    // ExecuteParamArray.
+    char*   data;
+    SQLLEN* lengths;
+};
+
+static SQLLEN FixedParamSize(SQLSMALLINT ValueType)
+{
+    // Returns the size of the fixed-length C types that GetParameterInfo creates or zero for other types.
+
+    switch (ValueType)
+    {
+    case SQL_C_BIT:
+        return sizeof(unsigned char);
+    case SQL_C_LONG:
+        return sizeof(long);
+    case SQL_C_SBIGINT:
+        return sizeof(INT64);
+    case SQL_C_DOUBLE:
+        return sizeof(double);
+    case SQL_C_TIMESTAMP:
+        return sizeof(TIMESTAMP_STRUCT);
+    case SQL_C_TYPE_DATE:
+        return sizeof(DATE_STRUCT);
+    case SQL_C_TYPE_TIME:
+        return sizeof(TIME_STRUCT);
+    }
+    return 0;
+}
+
+inline bool IsVariableParamType(SQLSMALLINT ValueType)
+{
+    return ValueType == SQL_C_CHAR || ValueType == SQL_C_WCHAR || ValueType == SQL_C_BINARY;
+}
+
+inline size_t AlignParamArray(size_t cb)
+{
+    // Keeps each array in the buffer aligned for the SQLLEN and structure types stored in it.
+    return (cb + 7) & ~(size_t)7;
+}
+
+static bool DescribeParamArray(ParamInfo* infos, Py_ssize_t cRows, Py_ssize_t cParams, Py_ssize_t iCol, ParamArrayColumn& col)
+{
+    // Determines the binding for a column of parameters from the ParamInfos of each row.  Returns false if the
+    // column cannot be bound as an array because the values are not all the same type or some must be sent at
+    // execution time.
+    //
+    // NULLs take the type of the other values.  The column size and decimal digits are large enough for every value
+    // so that decimals with different scales can share a binding.
+
+    const ParamInfo* first = 0;
+    SQLULEN     cchInteger = 0;
+    SQLSMALLINT cchScale   = 0;
+    SQLLEN      cbMax      = 0;
+
+    for (Py_ssize_t iRow = 0; iRow < cRows; iRow++)
+    {
+        const ParamInfo& info = infos[iRow * cParams + iCol];
+
+        if (info.StrLen_or_Ind == SQL_NULL_DATA)
+            continue;
+
+        if (info.StrLen_or_Ind < SQL_NULL_DATA)
+            return false;           // data-at-execution
+
+        if (first == 0)
+            first = &info;
+        else if (info.ValueType != first->ValueType || info.ParameterType != first->ParameterType)
+            return false;
+
+        I(info.ColumnSize >= (SQLULEN)info.DecimalDigits);
+        cchInteger = max(cchInteger, info.ColumnSize - (SQLULEN)info.DecimalDigits);
+        cchScale   = max(cchScale, info.DecimalDigits);
+        cbMax      = max(cbMax, info.StrLen_or_Ind);
+    }
+
+    if (first == 0)
+    {
+        // Every value is NULL, so use the type the first row would have been bound with.
+        col.ValueType     = infos[iCol].ValueType;
+        col.ParameterType = infos[iCol].ParameterType;
+        col.ColumnSize    = infos[iCol].ColumnSize;
+        col.DecimalDigits = 0;
+        col.cbElement     = 1;
+        return true;
+    }
+
+    col.ValueType     = first->ValueType;
+    col.ParameterType = first->ParameterType;
+    col.ColumnSize    = cchInteger + (SQLULEN)cchScale;
+    col.DecimalDigits = cchScale;
+
+    if (IsVariableParamType(col.ValueType))
+    {
+        // Never zero and keeps SQLWCHAR elements aligned.
+        col.cbElement = max(cbMax, (SQLLEN)sizeof(SQLWCHAR));
+    }
+    else
+    {
+        col.cbElement = FixedParamSize(col.ValueType);
+        if (col.cbElement == 0)
+            return false;
+    }
+
+    return true;
+}
+
+static void FreeParamArray(Cursor* cur)
+{
+    // Restores the single row parameter binding after ExecuteParamArray.
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+        return;
+
+    Py_BEGIN_ALLOW_THREADS
+    SQLFreeStmt(cur->hstmt, SQL_CLOSE);
+    SQLFreeStmt(cur->hstmt, SQL_RESET_PARAMS);
+    SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)1, 0);
+    SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAM_STATUS_PTR, 0, 0);
+    SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, 0, 0);
+    Py_END_ALLOW_THREADS
+}
+
+int ExecuteParamArray(Cursor* cur, PyObject* pSql, PyObject* param_seq, Py_ssize_t iFirst, Py_ssize_t cRows)
+{
+    // Executes the rows [iFirst, iFirst + cRows) of param_seq with a single SQLExecute by binding an array of values
+    // for each parameter.
+    //
+    // Each row is converted using GetParameterInfo, just like PrepareAndBind, then the values of each parameter are
+    // copied into a contiguous array with a parallel length / indicator array.  This requires every value of a
+    // parameter to have the same C and SQL type (except NULLs), so if the rows are heterogeneous, some values are too
+    // long to be sent without data-at-execution, or the driver does not support parameter arrays,
+    // PARAMARRAY_UNSUPPORTED is returned without executing anything.  The caller should then execute the rows one at
+    // a time, which also reports errors such as the wrong number of parameters.
+    //
+    // The status of each row is read from SQL_ATTR_PARAM_STATUS_PTR so that an error names the row that failed.
+
+    I(cRows > 1);
+
+    if (!Prepare(cur, pSql))
+        return PARAMARRAY_ERROR;
+
+    Py_ssize_t cParams = cur->paramcount;
+    if (cParams == 0)
+        return PARAMARRAY_UNSUPPORTED;
+
+    SQLRETURN ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)SQL_PARAM_BIND_BY_COLUMN, 0);
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)(SQLULEN)cRows, 0);
+    Py_END_ALLOW_THREADS
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return PARAMARRAY_ERROR;
+    }
+
+    if (ret != SQL_SUCCESS)
+    {
+        // Either parameter arrays are not supported or the driver changed the size (01S02).
+        FreeParamArray(cur);
+        return PARAMARRAY_UNSUPPORTED;
+    }
+
+    //
+    // Convert every value, exactly as PrepareAndBind does.
+    //
+
+    // The infos, conversion buffers, and parameter arrays are only needed until this returns.
+    ArenaScope scope(cur->arena);
+
+    Py_ssize_t cInfos = cRows * cParams;
+    ParamInfo* infos = (ParamInfo*)Arena_Alloc(cur->arena, sizeof(ParamInfo) * cInfos);
+    if (infos == 0)
+    {
+        FreeParamArray(cur);
+        PyErr_NoMemory();
+        return PARAMARRAY_ERROR;
+    }
+    memset(infos, 0, sizeof(ParamInfo) * cInfos);
+
+    for (Py_ssize_t iRow = 0; iRow < cRows; iRow++)
+    {
+        Object row = PySequence_GetItem(param_seq, iFirst + iRow);
+        if (!row)
+        {
+            FreeInfos(infos, cInfos);
+            FreeParamArray(cur);
+            return PARAMARRAY_ERROR;
+        }
+
+        if ((!PyTuple_Check(row) && !PyList_Check(row) && !Row_Check(row)) || PySequence_Length(row) != cParams)
+        {
+            FreeInfos(infos, cInfos);
+            FreeParamArray(cur);
+            return PARAMARRAY_UNSUPPORTED;
+        }
+
+        for (Py_ssize_t i = 0; i < cParams; i++)
+        {
+            // GetParameterInfo takes ownership of the new reference.
+            PyObject* param = PySequence_GetItem(row, i);
+            if (!GetParameterInfo(cur, i, param, infos[iRow * cParams + i]))
+            {
+                FreeInfos(infos, cInfos);
+                FreeParamArray(cur);
+                return PARAMARRAY_ERROR;
+            }
+        }
+    }
+
+    //
+    // Lay out the buffer: the row status array followed by the lengths and values of each parameter.
+    //
+
+    ParamArrayColumn* cols = (ParamArrayColumn*)Arena_Alloc(cur->arena, sizeof(ParamArrayColumn) * cParams);
+    if (cols == 0)
+    {
+        FreeInfos(infos, cInfos);
+        FreeParamArray(cur);
+        PyErr_NoMemory();
+        return PARAMARRAY_ERROR;
+    }
+
+    size_t cbBuffer = AlignParamArray(sizeof(SQLUSMALLINT) * cRows);
+
+    for (Py_ssize_t i = 0; i < cParams; i++)
+    {
+        if (!DescribeParamArray(infos, cRows, cParams, i, cols[i]))
+        {
+            FreeInfos(infos, cInfos);
+            FreeParamArray(cur);
+            return PARAMARRAY_UNSUPPORTED;
+        }
+
+        cbBuffer += AlignParamArray(sizeof(SQLLEN) * cRows) + AlignParamArray((size_t)cols[i].cbElement * cRows);
+    }
+
+    char* buffer = (char*)Arena_Alloc(cur->arena, cbBuffer);
+    if (buffer == 0)
+    {
+        FreeInfos(infos, cInfos);
+        FreeParamArray(cur);
+        PyErr_NoMemory();
+        return PARAMARRAY_ERROR;
+    }
+
+    SQLUSMALLINT* status = (SQLUSMALLINT*)buffer;
+    size_t offset = AlignParamArray(sizeof(SQLUSMALLINT) * cRows);
+
+    for (Py_ssize_t i = 0; i < cParams; i++)
+    {
+        ParamArrayColumn& col = cols[i];
+
+        col.lengths = (SQLLEN*)&buffer[offset];
+        offset += AlignParamArray(sizeof(SQLLEN) * cRows);
+        col.data = &buffer[offset];
+        offset += AlignParamArray((size_t)col.cbElement * cRows);
+
+        bool variable = IsVariableParamType(col.ValueType);
+
+        for (Py_ssize_t iRow = 0; iRow < cRows; iRow++)
+        {
+            const ParamInfo& info = infos[iRow * cParams + i];
+            col.lengths[iRow] = info.StrLen_or_Ind;
+            if (info.StrLen_or_Ind != SQL_NULL_DATA)
+                memcpy(&col.data[iRow * col.cbElement], info.ParameterValuePtr, variable ? info.StrLen_or_Ind : col.cbElement);
+        }
+    }
+
+    // All of the values have been copied, so the Python objects are no longer needed.
+    FreeInfos(infos, cInfos);
+
+    //
+    // Bind and execute.
+    //
+
+    SQLULEN cProcessed = 0;
+    const char* szErrorFunc = "SQLSetStmtAttr";
+
+    INT64 start = Stats_Start(cur);
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAM_STATUS_PTR, status, 0);
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &cProcessed, 0);
+    for (Py_ssize_t i = 0; i < cParams && SQL_SUCCEEDED(ret); i++)
+    {
+        szErrorFunc = "SQLBindParameter";
+        ret = SQLBindParameter(cur->hstmt, (SQLUSMALLINT)(i + 1), SQL_PARAM_INPUT, cols[i].ValueType, cols[i].ParameterType,
+                               cols[i].ColumnSize, cols[i].DecimalDigits, cols[i].data, cols[i].cbElement, cols[i].lengths);
+    }
+    if (SQL_SUCCEEDED(ret))
+    {
+        szErrorFunc = "SQLExecute";
+        ret = SQLExecute(cur->hstmt);
+    }
+    Py_END_ALLOW_THREADS
+    Stats_EndCall(cur, STATS_EXECUTE, start);
+    Trace_Call(TRACE_SQLEXECUTE, cur->hstmt, ret, start, (INT64)cProcessed);
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return PARAMARRAY_ERROR;
+    }
+
+    // Some drivers report failed rows only in the status array, so check it even if SQLExecute succeeded.
+
+    Py_ssize_t iFailed = -1;
+    for (SQLULEN iRow = 0; iRow < cProcessed && iRow < (SQLULEN)cRows; iRow++)
+    {
+        if (status[iRow] == SQL_PARAM_ERROR)
+        {
+            iFailed = (Py_ssize_t)iRow;
+            break;
+        }
+    }
+
+    if ((!SQL_SUCCEEDED(ret) && ret != SQL_NO_DATA) || iFailed != -1)
+    {
+        // Read the diagnostics before FreeParamArray clears them.
+        char szFunc[60];
+        if (iFailed != -1)
+        {
+            sprintf(szFunc, "SQLExecute, executemany row %ld", (long)(iFirst + iFailed));
+            szErrorFunc = szFunc;
+        }
+        RaiseErrorFromHandle(szErrorFunc, cur->cnxn->hdbc, cur->hstmt);
+        FreeParamArray(cur);
+        return PARAMARRAY_ERROR;
+    }
+
+    FreeParamArray(cur);
+    return PARAMARRAY_EXECUTED;
+}
+
 static bool GetParamType(Cursor* cur, Py_ssize_t index, SQLSMALLINT& type)
 {
     // Returns the ODBC type of the of given parameter.
@@ -788,7 +1517,7 @@ static bool GetParamType(Cursor* cur, Py_ssize_t index, SQLSMALLINT& type)
 
     if (cur->paramtypes == 0)
     {
-        cur->paramtypes = reinterpret_cast<SQLSMALLINT*>(pyodbc_malloc(sizeof(SQLSMALLINT) * cur->paramcount));
+        cur->paramtypes = reinterpret_cast<SQLSMALLINT*>(pyodbc_malloc(ALLOC_PARAMS, sizeof(SQLSMALLINT) * cur->paramcount));
         if (cur->paramtypes == 0)
         {
             PyErr_NoMemory();
@@ -864,6 +1593,15 @@ bool Params_init()
 
     PyDateTime_IMPORT;
 
+    if (PyObject_HasAttrString(decimal_type, "_int"))
+    {
+        decimal_sign_name = PyString_InternFromString("_sign");
+        decimal_int_name  = PyString_InternFromString("_int");
+        decimal_exp_name  = PyString_InternFromString("_exp");
+        if (!decimal_sign_name || !decimal_int_name || !decimal_exp_name)
+            return false;
+    }
+
     return true;
 }
 
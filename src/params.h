@@ -10,4 +10,14 @@ bool PrepareAndBind(Cursor* cur, PyObject* pSql, PyObject* params, bool skip_fir
 void FreeParameterData(Cursor* cur);
 void FreeParameterInfo(Cursor* cur);
 
+// The results of ExecuteParamArray.
+enum
+{
+    PARAMARRAY_ERROR,           // An exception has been set.
+    PARAMARRAY_EXECUTED,        // All rows were executed.
+    PARAMARRAY_UNSUPPORTED      // Nothing was executed.  The rows must be executed one at a time.
+};
+
+int ExecuteParamArray(Cursor* cur, PyObject* pSql, PyObject* param_seq, Py_ssize_t iFirst, Py_ssize_t cRows);
+
 #endif
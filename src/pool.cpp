@@ -0,0 +1,555 @@
+// A pool of connections, created by pyodbc.Pool.
+//
+// The driver manager's pooling (see the module's pooling attribute) has no limits and no way to tell how it is doing.
+// This pool keeps connected HDBCs itself.  Pool.connect wraps an idle HDBC in a new Connection object and closing that
+// connection gives the HDBC back, so connections are checked in and out without any round trips to the server.  The
+// pool's state is only modified while holding the GIL, so it doesn't need a lock of its own.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "pool.h"
+#include "connection.h"
+#include "cnxninfo.h"
+#include "errors.h"
+#include "wrapper.h"
+#include "cursor.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// SQL_ATTR_CONNECTION_DEAD is from ODBC 3.5, which some driver manager headers do not define yet.
+#ifndef SQL_ATTR_CONNECTION_DEAD
+#define SQL_ATTR_CONNECTION_DEAD 1209
+#endif
+#ifndef SQL_CD_TRUE
+#define SQL_CD_TRUE 1L
+#endif
+
+// How long Pool.connect sleeps between checks for a returned connection when the pool is full.
+static const int WAIT_INTERVAL_MS = 2;
+
+
+static double PoolClock()
+{
+    // Returns the current time in seconds.  Only differences are used, so this uses the monotonic clock behind
+    // pyodbc.Stats: changes to the system time must not expire idle connections or end waits early.  (GetTickCount
+    // also wrapped after 49.7 days.)
+
+    return (double)Stats_Now() / 1000000000.0;
+}
+
+
+static void PoolSleep()
+{
+    Py_BEGIN_ALLOW_THREADS
+#ifdef _WIN32
+    Sleep(WAIT_INTERVAL_MS);
+#else
+    usleep(WAIT_INTERVAL_MS * 1000);
+#endif
+    Py_END_ALLOW_THREADS
+}
+
+
+static void Disconnect(HDBC hdbc)
+{
+    // Idle connections have no transaction, so they are just disconnected.
+
+    Py_BEGIN_ALLOW_THREADS
+    SQLDisconnect(hdbc);
+    SQLFreeHandle(SQL_HANDLE_DBC, hdbc);
+    Py_END_ALLOW_THREADS
+}
+
+
+static bool IsDead(HDBC hdbc)
+{
+    // Asks the driver if it already knows the connection has been lost.  This does not contact the server.  Drivers
+    // that don't support the attribute are assumed to be alive.
+
+    SQLUINTEGER dead = 0;
+    SQLRETURN ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLGetConnectAttr(hdbc, SQL_ATTR_CONNECTION_DEAD, &dead, SQL_IS_UINTEGER, 0);
+    Py_END_ALLOW_THREADS
+    return SQL_SUCCEEDED(ret) && dead == SQL_CD_TRUE;
+}
+
+
+static void CloseIdle(Pool* pool, double now)
+{
+    // Closes connections that have been idle longer than idle_timeout, oldest first, as long as at least minsize
+    // connections remain.
+    //
+    // Each connection is removed from the list before the GIL is released to disconnect it.
+
+    if (pool->idle_timeout == 0)
+        return;
+
+    while (pool->idle_count != 0 && (now - pool->idle[0].returned) > pool->idle_timeout &&
+           pool->idle_count + pool->active_count > pool->minsize)
+    {
+        HDBC hdbc = pool->idle[0].hdbc;
+        pool->idle_count--;
+        memmove(&pool->idle[0], &pool->idle[1], sizeof(IdleConnection) * pool->idle_count);
+        Disconnect(hdbc);
+    }
+}
+
+
+static void CloseAllIdle(Pool* pool)
+{
+    while (pool->idle_count != 0)
+    {
+        pool->idle_count--;
+        Disconnect(pool->idle[pool->idle_count].hdbc);
+    }
+}
+
+
+static bool ResetConnection(Pool* pool, Connection* cnxn)
+{
+    // Puts the connection back in the state a new connection from the pool would be in.  Returns false if the state
+    // cannot be reset and the connection must be closed.
+
+    SQLRETURN ret = SQL_SUCCESS;
+    HDBC hdbc = cnxn->hdbc;
+    uintptr_t nAutoCommit = pool->fAutoCommit ? SQL_AUTOCOMMIT_ON : SQL_AUTOCOMMIT_OFF;
+
+    Py_BEGIN_ALLOW_THREADS
+    if (cnxn->nAutoCommit == SQL_AUTOCOMMIT_OFF)
+        ret = SQLEndTran(SQL_HANDLE_DBC, hdbc, SQL_ROLLBACK);
+    if (SQL_SUCCEEDED(ret) && cnxn->nAutoCommit != nAutoCommit)
+        ret = SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)nAutoCommit, SQL_IS_UINTEGER);
+    if (SQL_SUCCEEDED(ret) && cnxn->timeout != 0)
+        ret = SQLSetConnectAttr(hdbc, SQL_ATTR_CONNECTION_TIMEOUT, (SQLPOINTER)0, SQL_IS_UINTEGER);
+    Py_END_ALLOW_THREADS
+
+    return SQL_SUCCEEDED(ret);
+}
+
+
+bool Pool_Return(Pool* pool, Connection* cnxn)
+{
+    I(cnxn->hdbc != SQL_NULL_HANDLE);
+
+    if (pool->closed || !ResetConnection(pool, cnxn))
+    {
+        pool->active_count--;
+        return false;
+    }
+
+    if (pool->idle_count == pool->idle_capacity)
+    {
+        int newcapacity = pool->idle_capacity ? (pool->idle_capacity * 2) : 4;
+        IdleConnection* newidle = (IdleConnection*)pyodbc_malloc(ALLOC_OTHER, sizeof(IdleConnection) * newcapacity);
+        if (newidle == 0)
+        {
+            // Closing the connection is better than raising from a close or dealloc.
+            pool->active_count--;
+            return false;
+        }
+
+        if (pool->idle_count)
+            memcpy(newidle, pool->idle, sizeof(IdleConnection) * pool->idle_count);
+        pyodbc_free(pool->idle);
+        pool->idle          = newidle;
+        pool->idle_capacity = newcapacity;
+    }
+
+    double now = PoolClock();
+
+    IdleConnection& entry = pool->idle[pool->idle_count++];
+    entry.hdbc     = cnxn->hdbc;
+    entry.returned = now;
+
+    cnxn->hdbc = SQL_NULL_HANDLE;
+    pool->active_count--;
+
+    TRACE("pool.return pool=%p hdbc=%d\n", pool, entry.hdbc);
+
+    CloseIdle(pool, now);
+
+    return true;
+}
+
+
+static Connection* Connect(Pool* pool)
+{
+    // Makes a new connection.  The caller has already counted it in active_count.
+
+    Object cnxn(Connection_New(pool->pConnectString, pool->fAutoCommit, pool->fAnsi, pool->fUnicodeResults,
+                               pool->timeout, pool->fReadOnly));
+    if (!cnxn)
+        return 0;
+
+    if (pool->info == 0)
+    {
+        PyObject* info = GetConnectionInfo(pool->pConnectString, (Connection*)cnxn.Get());
+        if (!info)
+            return 0;
+        pool->info = (CnxnInfo*)info;
+    }
+
+    pool->connects++;
+
+    return (Connection*)cnxn.Detach();
+}
+
+
+static char connect_doc[] =
+    "connect() --> Connection\n"
+    "\n"
+    "Returns a connection from the pool, connecting a new one if no connections are\n"
+    "idle.  Closing the connection (or deleting it) returns it to the pool.  The\n"
+    "pool rolls back any open transaction and resets the autocommit and timeout\n"
+    "attributes when it is returned.\n"
+    "\n"
+    "If maxsize connections are already checked out, waits up to wait_timeout\n"
+    "seconds for one to be returned before raising OperationalError.\n"
+    "\n"
+    "A connection with cursors that are still open when it is closed is not\n"
+    "returned to the pool since the cursors' statements belong to it.";
+
+static PyObject* Pool_connect(PyObject* self, PyObject* args)
+{
+    UNUSED(args);
+
+    Pool* pool = (Pool*)self;
+
+    if (pool->closed)
+    {
+        PyErr_SetString(ProgrammingError, "Attempt to use a closed pool.");
+        return 0;
+    }
+
+    double start = PoolClock();
+    bool waited = false;
+    Connection* cnxn = 0;
+
+    for (;;)
+    {
+        CloseIdle(pool, PoolClock());
+
+        while (cnxn == 0 && pool->idle_count != 0)
+        {
+            // Remove it from the list before the GIL is released.
+            HDBC hdbc = pool->idle[--pool->idle_count].hdbc;
+            pool->active_count++;
+
+            if (IsDead(hdbc))
+            {
+                pool->active_count--;
+                Disconnect(hdbc);
+                continue;
+            }
+
+            cnxn = Connection_Attach(hdbc, pool->fAutoCommit, pool->fUnicodeResults, pool->info);
+            if (cnxn == 0)
+            {
+                pool->active_count--;
+                Disconnect(hdbc);
+                return PyErr_NoMemory();
+            }
+        }
+
+        if (cnxn == 0 && (pool->maxsize == 0 || pool->active_count < pool->maxsize))
+        {
+            pool->active_count++;
+            cnxn = Connect(pool);
+            if (cnxn == 0)
+            {
+                pool->active_count--;
+                return 0;
+            }
+        }
+
+        if (cnxn != 0)
+            break;
+
+        if (pool->closed)
+        {
+            PyErr_SetString(ProgrammingError, "Attempt to use a closed pool.");
+            return 0;
+        }
+
+        if (PoolClock() - start >= pool->wait_timeout)
+            return RaiseErrorV(0, OperationalError, "The connection pool is exhausted (maxsize=%d).", pool->maxsize);
+
+        waited = true;
+        PoolSleep();
+    }
+
+    cnxn->pool = pool;
+    Py_INCREF(pool);
+
+    double elapsed = PoolClock() - start;
+    pool->checkouts++;
+    if (waited)
+        pool->waits++;
+    pool->wait_time += elapsed;
+    if (elapsed > pool->max_wait_time)
+        pool->max_wait_time = elapsed;
+
+    return (PyObject*)cnxn;
+}
+
+
+static char close_doc[] =
+    "close() --> None\n"
+    "\n"
+    "Closes the idle connections.  Connections that are checked out are closed when\n"
+    "they are returned.  The pool cannot be used after this.";
+
+static PyObject* Pool_close(PyObject* self, PyObject* args)
+{
+    UNUSED(args);
+
+    Pool* pool = (Pool*)self;
+    pool->closed = true;
+    CloseAllIdle(pool);
+
+    Py_RETURN_NONE;
+}
+
+
+static void Pool_dealloc(PyObject* self)
+{
+    // Checked out connections hold a reference to the pool, so there are only idle connections left.
+
+    Pool* pool = (Pool*)self;
+    CloseAllIdle(pool);
+    pyodbc_free(pool->idle);
+    Py_XDECREF(pool->pConnectString);
+    Py_XDECREF(pool->info);
+    PyObject_Del(self);
+}
+
+
+static PyObject* Pool_new(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    static char* kwnames[] = { "connstring", "minsize", "maxsize", "idle_timeout", "wait_timeout", "autocommit", "ansi",
+                               "timeout", "readonly", "unicode_results", 0 };
+
+    PyObject* pConnectString = 0;
+    int minsize = 0;
+    int maxsize = 0;
+    double idle_timeout = 0;
+    double wait_timeout = 0;
+    PyObject* autocommit = Py_False;
+    PyObject* ansi = Py_False;
+    long timeout = 0;
+    PyObject* readonly = Py_False;
+    PyObject* unicode_results = Py_False;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|iiddOOlOO", kwnames, &pConnectString, &minsize, &maxsize,
+                                     &idle_timeout, &wait_timeout, &autocommit, &ansi, &timeout, &readonly,
+                                     &unicode_results))
+        return 0;
+
+    if (!PyString_Check(pConnectString) && !PyUnicode_Check(pConnectString))
+        return PyErr_Format(PyExc_TypeError, "argument 1 must be a string or unicode object");
+
+    if (minsize < 0 || maxsize < 0 || (maxsize != 0 && minsize > maxsize))
+        return PyErr_Format(PyExc_ValueError, "minsize and maxsize cannot be negative and minsize cannot exceed maxsize");
+
+    if (idle_timeout < 0 || wait_timeout < 0)
+        return PyErr_Format(PyExc_ValueError, "idle_timeout and wait_timeout cannot be negative");
+
+    if (henv == SQL_NULL_HANDLE && !AllocateEnv())
+        return 0;
+
+    Object connstring(PyUnicode_FromObject(pConnectString));
+    if (!connstring)
+        return 0;
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4365)
+#endif
+    Pool* pool = PyObject_NEW(Pool, type);
+#ifdef _MSC_VER
+#pragma warning(default : 4365)
+#endif
+    if (pool == 0)
+        return 0;
+
+    pool->pConnectString  = connstring.Detach();
+    pool->fAutoCommit     = PyObject_IsTrue(autocommit) == 1;
+    pool->fAnsi           = PyObject_IsTrue(ansi) == 1;
+    pool->fUnicodeResults = PyObject_IsTrue(unicode_results) == 1;
+    pool->fReadOnly       = PyObject_IsTrue(readonly) == 1;
+    pool->timeout         = timeout;
+    pool->info            = 0;
+    pool->minsize         = minsize;
+    pool->maxsize         = maxsize;
+    pool->idle_timeout    = idle_timeout;
+    pool->wait_timeout    = wait_timeout;
+    pool->idle            = 0;
+    pool->idle_count      = 0;
+    pool->idle_capacity   = 0;
+    pool->active_count    = 0;
+    pool->closed          = false;
+    pool->checkouts       = 0;
+    pool->connects        = 0;
+    pool->waits           = 0;
+    pool->wait_time       = 0;
+    pool->max_wait_time   = 0;
+
+    // Warm the pool by making minsize connections and returning them.
+
+    for (int i = 0; i < minsize; i++)
+    {
+        pool->active_count++;
+        Connection* cnxn = Connect(pool);
+        if (cnxn == 0)
+        {
+            pool->active_count--;
+            Py_DECREF(pool);
+            return 0;
+        }
+
+        cnxn->pool = pool;
+        Py_INCREF(pool);
+        Py_DECREF(cnxn);
+    }
+
+    return (PyObject*)pool;
+}
+
+
+static PyObject* Pool_getsize(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+    Pool* pool = (Pool*)self;
+    return PyInt_FromLong(pool->idle_count + pool->active_count);
+}
+
+static PyObject* Pool_getidle(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+    return PyInt_FromLong(((Pool*)self)->idle_count);
+}
+
+static PyObject* Pool_getactive(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+    return PyInt_FromLong(((Pool*)self)->active_count);
+}
+
+static PyObject* Pool_getclosed(PyObject* self, void* closure)
+{
+    UNUSED(closure);
+    PyObject* result = ((Pool*)self)->closed ? Py_True : Py_False;
+    Py_INCREF(result);
+    return result;
+}
+
+static PyMemberDef Pool_members[] =
+{
+    { "minsize",       T_INT,    offsetof(Pool, minsize),       READONLY, "Idle connections are not closed if it would leave fewer connections than this." },
+    { "maxsize",       T_INT,    offsetof(Pool, maxsize),       READONLY, "The maximum number of connections, or zero for no limit." },
+    { "idle_timeout",  T_DOUBLE, offsetof(Pool, idle_timeout),  READONLY, "Seconds an idle connection is kept, or zero to keep them forever." },
+    { "wait_timeout",  T_DOUBLE, offsetof(Pool, wait_timeout),  READONLY, "Seconds connect() waits when maxsize connections are checked out." },
+    { "checkouts",     T_LONG,   offsetof(Pool, checkouts),     READONLY, "The number of connections returned by connect()." },
+    { "connects",      T_LONG,   offsetof(Pool, connects),      READONLY, "The number of new connections made." },
+    { "waits",         T_LONG,   offsetof(Pool, waits),         READONLY, "The number of checkouts that waited for a connection to be returned." },
+    { "wait_time",     T_DOUBLE, offsetof(Pool, wait_time),     READONLY, "Total seconds spent in connect(), including making new connections." },
+    { "max_wait_time", T_DOUBLE, offsetof(Pool, max_wait_time), READONLY, "The longest time in seconds a single call to connect() took." },
+    { 0 }
+};
+
+static PyGetSetDef Pool_getseters[] =
+{
+    { "size",   Pool_getsize,   0, "The number of connections, idle and checked out.", 0 },
+    { "idle",   Pool_getidle,   0, "The number of idle connections.", 0 },
+    { "active", Pool_getactive, 0, "The number of connections checked out.", 0 },
+    { "closed", Pool_getclosed, 0, "True if close() has been called.", 0 },
+    { 0 }
+};
+
+static struct PyMethodDef Pool_methods[] =
+{
+    { "connect", Pool_connect, METH_NOARGS, connect_doc },
+    { "close",   Pool_close,   METH_NOARGS, close_doc   },
+    { 0, 0, 0, 0 }
+};
+
+static char pool_doc[] =
+    "Pool(connstring, minsize=0, maxsize=0, idle_timeout=0, wait_timeout=0,\n"
+    "     autocommit=False, ansi=False, timeout=0, readonly=False,\n"
+    "     unicode_results=False) --> Pool\n"
+    "\n"
+    "A pool of connections to the same database.  Use connect() to check out a\n"
+    "connection and close it to return it to the pool.\n"
+    "\n"
+    "The connection options are the same as for pyodbc.connect, except that the\n"
+    "connection string must be complete since keywords are not added to it.\n"
+    "\n"
+    "minsize\n"
+    "  The number of connections made when the pool is created.  Idle connections\n"
+    "  are not closed if it would leave fewer connections than this.\n"
+    "\n"
+    "maxsize\n"
+    "  The maximum number of connections, idle and checked out.  Zero, the default,\n"
+    "  means no limit.\n"
+    "\n"
+    "idle_timeout\n"
+    "  Idle connections are closed after this many seconds.  Zero, the default,\n"
+    "  means they are kept until the pool is closed.\n"
+    "\n"
+    "wait_timeout\n"
+    "  When maxsize connections are checked out, connect() waits up to this many\n"
+    "  seconds for one to be returned.";
+
+PyTypeObject PoolType =
+{
+    PyVarObject_HEAD_INIT(0, 0)
+    "pyodbc.Pool",              // tp_name
+    sizeof(Pool),               // tp_basicsize
+    0,                          // tp_itemsize
+    Pool_dealloc,               // destructor tp_dealloc
+    0,                          // tp_print
+    0,                          // tp_getattr
+    0,                          // tp_setattr
+    0,                          // tp_compare
+    0,                          // tp_repr
+    0,                          // tp_as_number
+    0,                          // tp_as_sequence
+    0,                          // tp_as_mapping
+    0,                          // tp_hash
+    0,                          // tp_call
+    0,                          // tp_str
+    0,                          // tp_getattro
+    0,                          // tp_setattro
+    0,                          // tp_as_buffer
+    Py_TPFLAGS_DEFAULT,         // tp_flags
+    pool_doc,                   // tp_doc
+    0,                          // tp_traverse
+    0,                          // tp_clear
+    0,                          // tp_richcompare
+    0,                          // tp_weaklistoffset
+    0,                          // tp_iter
+    0,                          // tp_iternext
+    Pool_methods,               // tp_methods
+    Pool_members,               // tp_members
+    Pool_getseters,             // tp_getset
+    0,                          // tp_base
+    0,                          // tp_dict
+    0,                          // tp_descr_get
+    0,                          // tp_descr_set
+    0,                          // tp_dictoffset
+    0,                          // tp_init
+    0,                          // tp_alloc
+    Pool_new,                   // tp_new
+    0,                          // tp_free
+    0,                          // tp_is_gc
+    0,                          // tp_bases
+    0,                          // tp_mro
+    0,                          // tp_cache
+    0,                          // tp_subclasses
+    0,                          // tp_weaklist
+};
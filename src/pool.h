@@ -0,0 +1,67 @@
+#ifndef _POOL_H_
+#define _POOL_H_
+
+struct Connection;
+struct CnxnInfo;
+
+extern PyTypeObject PoolType;
+
+// An idle connection, kept by a pool until it is checked out again.
+struct IdleConnection
+{
+    HDBC hdbc;
+    double returned;            // When it was returned to the pool, from PoolClock.
+};
+
+struct Pool
+{
+    PyObject_HEAD
+
+    // The options every connection in the pool is created with.  See mod_connect.
+
+    PyObject* pConnectString;
+    bool fAutoCommit;
+    bool fAnsi;
+    bool fUnicodeResults;
+    bool fReadOnly;
+    long timeout;
+
+    // The CnxnInfo shared by all of the pool's connections.  Zero until the first connection is made.
+    CnxnInfo* info;
+
+    int minsize;                // Idle connections are not closed if it would leave fewer connections than this.
+    int maxsize;                // The maximum number of connections, idle and checked out.  Zero means no limit.
+    double idle_timeout;        // Seconds a connection may be idle before it is closed.  Zero means forever.
+    double wait_timeout;        // Seconds Pool.connect waits when maxsize connections are checked out.
+
+    // Idle connections, ordered from the least to the most recently returned.  Connections are checked out from the
+    // end, which keeps the fewest connections busy, and idle ones are closed from the front.
+
+    IdleConnection* idle;
+    int idle_count;
+    int idle_capacity;
+
+    int active_count;           // The number of connections checked out (or being connected).
+    bool closed;                // Set by Pool.close.  Connections returned after this are closed.
+
+    // Statistics.
+
+    long checkouts;             // Calls to Pool.connect that returned a connection.
+    long connects;              // New connections made.
+    long waits;                 // Checkouts that had to wait for another thread to return a connection.
+    double wait_time;           // Total seconds spent in Pool.connect, including connecting.
+    double max_wait_time;
+};
+
+#define Pool_Check(op) PyObject_TypeCheck(op, &PoolType)
+
+/**
+ * Called when a pooled connection is closed.  If the pool is still open and the connection's state can be reset, its
+ * HDBC is added to the idle connections, cnxn->hdbc is set to SQL_NULL_HANDLE, and true is returned.  Otherwise the
+ * caller must disconnect it.
+ *
+ * Either way, the connection no longer counts as checked out.
+ */
+bool Pool_Return(Pool* pool, Connection* cnxn);
+
+#endif // _POOL_H_
@@ -0,0 +1,412 @@
+// Prefetching for block fetches, enabled by setting Cursor.prefetch.
+//
+// Without prefetching, the driver sits idle while Python converts a rowset and Python waits while the driver reads the
+// next one.  A prefetching cursor's fetch buffer holds several rowsets laid out identically.  A native thread fetches
+// into the free rowsets (using SQL_ATTR_ROW_BIND_OFFSET_PTR to move the bindings) without holding the GIL, and
+// Prefetch_Next hands them to the cursor in order by pointing the ColumnInfos at the next one.
+//
+// The thread only calls SQLFetch and never touches Python objects.  It stops after the first fetch that doesn't return
+// SQL_SUCCESS so warnings, errors, and row errors are reported with their diagnostics intact; the cursor then fetches
+// any remaining rows itself.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "prefetch.h"
+#include "cursor.h"
+#include "connection.h"
+#include "errors.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+// The result of fetching one rowset.
+struct Rowset
+{
+    SQLRETURN ret;
+    SQLULEN rows_fetched;
+};
+
+struct Prefetcher
+{
+    Cursor* cur;
+    HSTMT hstmt;
+    int cCols;
+
+    // The fetch buffer holds `count` rowsets of cbRowset bytes.  The cursor is reading rowset `current`, and `ready`
+    // rowsets after it have been fetched and are waiting.  The thread fetches ahead until all of the others are full.
+    int count;
+    size_t cbRowset;
+    Rowset* rowsets;
+    int current;
+    int ready;
+
+    bool stop;                  // Set to ask the thread to exit.
+    bool finished;              // Set by the thread when it exits, after which only the cursor uses the HSTMT.
+    bool started;               // True if the thread was started and hasn't been joined.
+
+    // The driver writes to these during a fetch (SQL_ATTR_ROW_BIND_OFFSET_PTR, SQL_ATTR_ROWS_FETCHED_PTR, and
+    // SQL_ATTR_ROW_STATUS_PTR).  The row statuses are copied into the rowset afterwards.
+    SQLLEN bind_offset;
+    SQLULEN rows_fetched;
+    SQLUSMALLINT* row_status;
+
+    // The prefetchers of the connection's other cursors.
+    Prefetcher* next;
+
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE changed;
+    HANDLE thread;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    pthread_t thread;
+#endif
+};
+
+
+//
+// Threading
+//
+// Both threads wait on the same condition, which is signaled whenever `ready`, `current`, `stop`, or `finished`
+// changes.
+//
+
+static void Lock(Prefetcher* p)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&p->lock);
+#else
+    pthread_mutex_lock(&p->lock);
+#endif
+}
+
+static void Unlock(Prefetcher* p)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&p->lock);
+#else
+    pthread_mutex_unlock(&p->lock);
+#endif
+}
+
+static void Wait(Prefetcher* p)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(&p->changed, &p->lock, INFINITE);
+#else
+    pthread_cond_wait(&p->changed, &p->lock);
+#endif
+}
+
+static void Signal(Prefetcher* p)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(&p->changed);
+#else
+    pthread_cond_broadcast(&p->changed);
+#endif
+}
+
+
+static SQLRETURN FetchRowset(Prefetcher* p, int index)
+{
+    // Fetches the next rowset into rowset `index`.  Called by the thread or, after it has finished, by the cursor.
+
+    SQLULEN cRows = p->cur->rowset_size;
+    SQLUSMALLINT* status = (SQLUSMALLINT*)(p->cur->fetch_buffer + p->cbRowset * index);
+
+    p->bind_offset = (SQLLEN)(p->cbRowset * index);
+    INT64 start = Trace_Start();
+    SQLRETURN ret = SQLFetch(p->hstmt);
+
+    Rowset& rowset = p->rowsets[index];
+    rowset.ret = ret;
+    rowset.rows_fetched = SQL_SUCCEEDED(ret) ? min(p->rows_fetched, cRows) : 0;
+    Trace_Call(TRACE_SQLFETCH, p->hstmt, ret, start, (INT64)rowset.rows_fetched);
+    memcpy(status, p->row_status, sizeof(SQLUSMALLINT) * rowset.rows_fetched);
+
+    return ret;
+}
+
+
+static void RunThread(Prefetcher* p)
+{
+    Lock(p);
+
+    for (;;)
+    {
+        while (!p->stop && p->ready == p->count - 1)
+            Wait(p);
+
+        if (p->stop)
+            break;
+
+        int index = (p->current + 1 + p->ready) % p->count;
+        Unlock(p);
+
+        SQLRETURN ret = FetchRowset(p, index);
+
+        Lock(p);
+        p->ready++;
+        Signal(p);
+
+        if (ret != SQL_SUCCESS)
+            break;
+    }
+
+    p->finished = true;
+    Signal(p);
+    Unlock(p);
+}
+
+#ifdef _WIN32
+static unsigned __stdcall ThreadProc(void* arg)
+{
+    RunThread((Prefetcher*)arg);
+    return 0;
+}
+#else
+static void* ThreadProc(void* arg)
+{
+    RunThread((Prefetcher*)arg);
+    return 0;
+}
+#endif
+
+
+static void StopThread(Prefetcher* p)
+{
+    if (!p->started)
+        return;
+
+    Py_BEGIN_ALLOW_THREADS
+    Lock(p);
+    p->stop = true;
+    Signal(p);
+    Unlock(p);
+
+#ifdef _WIN32
+    WaitForSingleObject(p->thread, INFINITE);
+    CloseHandle(p->thread);
+#else
+    pthread_join(p->thread, 0);
+#endif
+    Py_END_ALLOW_THREADS
+
+    p->started = false;
+}
+
+
+static void FreePrefetcher(Prefetcher* p)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(&p->lock);
+#else
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->changed);
+#endif
+    pyodbc_free(p->rowsets);
+    pyodbc_free(p->row_status);
+    pyodbc_free(p);
+}
+
+
+static void MoveRowset(Cursor* cur, int cCols, SQLLEN offset)
+{
+    // Points the cursor's row status and bound columns at the same locations `offset` bytes away.
+
+    cur->row_status = (SQLUSMALLINT*)((char*)cur->row_status + offset);
+
+    for (int i = 0; i < cCols; i++)
+    {
+        ColumnInfo* pinfo = &cur->colinfos[i];
+        pinfo->data    += offset;
+        pinfo->lengths  = (SQLLEN*)((char*)pinfo->lengths + offset);
+    }
+}
+
+
+bool Prefetch_Start(Cursor* cur, int cCols, size_t cbRowset)
+{
+    I(cur->prefetcher == 0 && cur->prefetch > 0 && cur->fetch_buffer != 0);
+
+    int count = cur->prefetch + 1;
+
+    Prefetcher* p = (Prefetcher*)pyodbc_malloc(ALLOC_FETCH, sizeof(Prefetcher));
+    Rowset* rowsets = (Rowset*)pyodbc_malloc(ALLOC_FETCH, sizeof(Rowset) * count);
+    SQLUSMALLINT* row_status = (SQLUSMALLINT*)pyodbc_malloc(ALLOC_FETCH, sizeof(SQLUSMALLINT) * cur->rowset_size);
+
+    if (!p || !rowsets || !row_status)
+    {
+        pyodbc_free(p);
+        pyodbc_free(rowsets);
+        pyodbc_free(row_status);
+        PyErr_NoMemory();
+        return false;
+    }
+
+    p->cur          = cur;
+    p->hstmt        = cur->hstmt;
+    p->cCols        = cCols;
+    p->count        = count;
+    p->cbRowset     = cbRowset;
+    p->rowsets      = rowsets;
+    p->current      = 0;
+    p->ready        = 0;
+    p->stop         = false;
+    p->finished     = false;
+    p->started      = false;
+    p->bind_offset  = 0;
+    p->rows_fetched = 0;
+    p->row_status   = row_status;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&p->lock);
+    InitializeConditionVariable(&p->changed);
+#else
+    pthread_mutex_init(&p->lock, 0);
+    pthread_cond_init(&p->changed, 0);
+#endif
+
+    // The columns were bound to the first rowset by BindResults.  The offset moves all of the bindings at once.
+
+    SQLRETURN ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_BIND_OFFSET_PTR, &p->bind_offset, 0);
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &p->rows_fetched, 0);
+    if (SQL_SUCCEEDED(ret))
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_STATUS_PTR, p->row_status, 0);
+    Py_END_ALLOW_THREADS
+
+    if (cur->cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        FreePrefetcher(p);
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        FreePrefetcher(p);
+        RaiseErrorFromHandle("SQLSetStmtAttr", cur->cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+#ifdef _WIN32
+    p->thread = (HANDLE)_beginthreadex(0, 0, ThreadProc, p, 0, 0);
+    p->started = (p->thread != 0);
+#else
+    p->started = (pthread_create(&p->thread, 0, ThreadProc, p) == 0);
+#endif
+
+    if (!p->started)
+    {
+        FreePrefetcher(p);
+        PyErr_SetString(PyExc_RuntimeError, "Unable to start the prefetch thread");
+        return false;
+    }
+
+    cur->prefetcher = p;
+    p->next = cur->cnxn->prefetchers;
+    cur->cnxn->prefetchers = p;
+
+    return true;
+}
+
+
+bool Prefetch_Next(Cursor* cur, SQLRETURN& ret)
+{
+    Prefetcher* p = cur->prefetcher;
+    int previous = p->current;
+    bool fStopped;
+
+    Py_BEGIN_ALLOW_THREADS
+    Lock(p);
+    while (p->ready == 0 && !p->finished)
+        Wait(p);
+
+    fStopped = p->stop;
+
+    if (p->ready != 0)
+    {
+        p->current = (p->current + 1) % p->count;
+        p->ready--;
+        Signal(p);
+        Unlock(p);
+    }
+    else
+    {
+        // The thread has exited, so fetch the rest of the rows here.
+        Unlock(p);
+        if (!fStopped)
+        {
+            p->current = (p->current + 1) % p->count;
+            FetchRowset(p, p->current);
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (fStopped && p->current == previous)
+    {
+        // Prefetch_StopAll was called by another thread closing the connection.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    MoveRowset(cur, p->cCols, (SQLLEN)p->cbRowset * (p->current - previous));
+
+    const Rowset& rowset = p->rowsets[p->current];
+    cur->rows_fetched = rowset.rows_fetched;
+    ret = rowset.ret;
+
+    return true;
+}
+
+
+static void Unlink(Prefetcher* p)
+{
+    Prefetcher** pp = &p->cur->cnxn->prefetchers;
+    while (*pp != p)
+        pp = &(*pp)->next;
+    *pp = p->next;
+}
+
+
+void Prefetch_Stop(Cursor* cur)
+{
+    Prefetcher* p = cur->prefetcher;
+    if (p == 0)
+        return;
+
+    StopThread(p);
+    Unlink(p);
+    cur->prefetcher = 0;
+
+    if (cur->cnxn->hdbc != SQL_NULL_HANDLE)
+    {
+        // Don't leave the driver pointers to the prefetcher.  free_results removes the rest of the block fetching
+        // attributes.
+        Py_BEGIN_ALLOW_THREADS
+        SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_BIND_OFFSET_PTR, 0, 0);
+        SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROWS_FETCHED_PTR, 0, 0);
+        SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_STATUS_PTR, 0, 0);
+        Py_END_ALLOW_THREADS
+    }
+
+    FreePrefetcher(p);
+}
+
+
+void Prefetch_StopAll(Connection* cnxn)
+{
+    for (Prefetcher* p = cnxn->prefetchers; p != 0; p = p->next)
+        StopThread(p);
+}
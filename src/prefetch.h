@@ -0,0 +1,35 @@
+#ifndef _PREFETCH_H_
+#define _PREFETCH_H_
+
+struct Connection;
+struct Cursor;
+struct Prefetcher;
+
+/**
+ * Called by BindResults after all `cCols` result columns have been bound to the first of cur->prefetch + 1 rowsets of
+ * `cbRowset` bytes each in the fetch buffer.  Starts a thread that fetches into the other rowsets while the cursor
+ * reads the current one.  Returns false with an exception set if the thread can't be started.
+ */
+bool Prefetch_Start(Cursor* cur, int cCols, size_t cbRowset);
+
+/**
+ * Called by Cursor_FetchRow instead of SQLFetch when cur->prefetcher is set.  Waits for the next rowset, makes it the
+ * cursor's current rowset, and sets `ret` to the result of the SQLFetch that read it.  Returns false with an exception
+ * set if the connection was closed while waiting.
+ */
+bool Prefetch_Next(Cursor* cur, SQLRETURN& ret);
+
+/**
+ * Stops the cursor's prefetch thread, waiting for any SQLFetch it is running, and frees the prefetcher.  The fetch
+ * buffer is left for free_results.  Must be called before anything else uses the HSTMT.  Does nothing if the cursor
+ * is not prefetching.
+ */
+void Prefetch_Stop(Cursor* cur);
+
+/**
+ * Stops the prefetch threads of every cursor on the connection.  Called before the connection is closed, since the
+ * threads' HSTMTs are freed with it.
+ */
+void Prefetch_StopAll(Connection* cnxn);
+
+#endif // _PREFETCH_H_
@@ -116,19 +116,11 @@ inline void DebugTrace(const char* szFmt, ...) { UNUSED(szFmt); }
 #endif
 #define TRACE DebugTrace
 
-#ifdef PYODBC_LEAK_CHECK
-#define pyodbc_malloc(len) _pyodbc_malloc(__FILE__, __LINE__, len)
-void* _pyodbc_malloc(const char* filename, int lineno, size_t len);
-void pyodbc_free(void* p);
-void pyodbc_leak_check();
-#else
-#define pyodbc_malloc malloc
-#define pyodbc_free free
-#endif
-
 void PrintBytes(void* p, size_t len);
 
 #include "pyodbccompat.h"
+#include "alloc.h"
+#include "arena.h"
 
 #define HERE printf("%s(%d)\n", __FILE__, __LINE__)
 
@@ -15,6 +15,9 @@
 #ifndef Py_TYPE
 #define Py_TYPE(ob) (((PyObject*)(ob))->ob_type)
 #endif
+#ifndef Py_SIZE
+#define Py_SIZE(ob) (((PyVarObject*)(ob))->ob_size)
+#endif
 
 // Macros were introduced in 2.6 to map "bytes" to "str" in Python 2.  Back port to 2.5.
 #if PY_VERSION_HEX >= 0x02060000
@@ -34,6 +37,7 @@
 #if PY_MAJOR_VERSION >= 3
   #define PyString_FromString PyUnicode_FromString
   #define PyString_FromStringAndSize PyUnicode_FromStringAndSize
+  #define PyString_InternFromString PyUnicode_InternFromString
   #define PyString_Check PyUnicode_Check
   #define PyString_Type PyUnicode_Type
   #define PyString_Size PyUnicode_Size
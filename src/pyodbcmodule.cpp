@@ -14,12 +14,17 @@
 #include "connection.h"
 #include "cursor.h"
 #include "row.h"
+#include "colmap.h"
+#include "lobreader.h"
 #include "wrapper.h"
 #include "errors.h"
 #include "getdata.h"
 #include "cnxninfo.h"
 #include "params.h"
 #include "dbspecific.h"
+#include "pool.h"
+#include "stats.h"
+#include "trace.h"
 #include <datetime.h>
 
 #include <time.h>
@@ -57,7 +62,7 @@ static char module_doc[] =
     "  A Boolean indicating whether connection pooling is enabled.  This is a\n"
     "  global (HENV) setting, so it can only be modified before the first\n"
     "  connection is made.  The default is True, which enables ODBC connection\n"
-    "  pooling.\n"
+    "  pooling.  See the Pool class for a pool with size limits and statistics.\n"
     "\n"
     "threadsafety\n"
     "  The integer 1, indicating that threads may share the module but not\n"
@@ -177,8 +182,6 @@ static bool import_types()
     Cursor_init();
     CnxnInfo_init();
     GetData_init();
-    if (!Params_init())
-        return false;
 
     PyObject* decimalmod = PyImport_ImportModule("decimal");
     if (!decimalmod)
@@ -191,13 +194,17 @@ static bool import_types()
     Py_DECREF(decimalmod);
 
     if (decimal_type == 0)
+    {
         PyErr_SetString(PyExc_RuntimeError, "Unable to import decimal.Decimal.");
+        return false;
+    }
 
-    return decimal_type != 0;
+    // Params_init looks at the Decimal type.
+    return Params_init();
 }
 
 
-static bool AllocateEnv()
+bool AllocateEnv()
 {
     PyObject* pooling = PyObject_GetAttrString(pModule, "pooling");
     bool bPooling = pooling == Py_True;
@@ -532,14 +539,66 @@ static char datasources_doc[] =
     "Returns a dictionary mapping available DSNs to their descriptions.";
 
 
-#ifdef PYODBC_LEAK_CHECK
-static PyObject* mod_leakcheck(PyObject* self, PyObject* args)
+static char enabletrace_doc[] =
+    "enabletrace() --> None\n"
+    "\n"
+    "Starts recording an event for each ODBC call that prepares, executes, fetches,\n"
+    "reads or writes data, connects, or commits or rolls back.  Each thread records\n"
+    "into its own buffer of 4096 events, so call draintrace regularly; events that\n"
+    "don't fit are dropped and counted.";
+
+static PyObject* mod_enabletrace(PyObject* self, PyObject* args)
 {
     UNUSED(self, args);
-    pyodbc_leak_check();
-    Py_RETURN_NONE;
+    return Trace_Enable();
+}
+
+static char disabletrace_doc[] =
+    "disabletrace() --> None\n"
+    "\n"
+    "Stops recording trace events.  Events already recorded are kept until they are\n"
+    "drained.";
+
+static PyObject* mod_disabletrace(PyObject* self, PyObject* args)
+{
+    UNUSED(self, args);
+    return Trace_Disable();
+}
+
+static char draintrace_doc[] =
+    "draintrace() --> ([ event, ... ], dropped)\n"
+    "\n"
+    "Removes the recorded trace events and returns them in the order the calls were\n"
+    "made, along with the number of events dropped since the last call because a\n"
+    "buffer was full.  Each event is a tuple:\n"
+    "\n"
+    "  (start_ns, duration_ns, thread, function, handle, return_code, rows)\n"
+    "\n"
+    "start_ns is from a monotonic clock, thread is the thread.get_ident() value of\n"
+    "the thread that made the call, function is the ODBC function name, and handle is\n"
+    "the HSTMT or HDBC.  rows is the number of rows fetched or counted by SQLFetch,\n"
+    "SQLFetchScroll, SQLRowCount, and SQLExecute of a parameter array, and -1 for\n"
+    "other calls.";
+
+static PyObject* mod_draintrace(PyObject* self, PyObject* args)
+{
+    UNUSED(self, args);
+    return Trace_Drain();
+}
+
+static char allocations_doc[] =
+    "allocations() --> { category : (bytes, blocks) }\n"
+    "\n"
+    "Returns the bytes and number of blocks of memory pyodbc currently has allocated\n"
+    "for each of its uses (such as 'arena', 'rows', 'fetch', and 'getdata').\n"
+    "Row objects are included, but other objects returned to Python, such as the\n"
+    "values in rows, are not.  Comparing the results over time shows memory growth.";
+
+static PyObject* mod_allocations(PyObject* self, PyObject* args)
+{
+    UNUSED(self, args);
+    return Alloc_GetCounts();
 }
-#endif
 
 #ifdef WINVER
 static char drivers_doc[] = "drivers() -> [ driver, ... ]\n\nReturns a list of installed drivers";
@@ -586,14 +645,15 @@ static PyMethodDef pyodbc_methods[] =
     { "DateFromTicks",      (PyCFunction)mod_datefromticks,      METH_VARARGS,               datefromticks_doc },
     { "TimestampFromTicks", (PyCFunction)mod_timestampfromticks, METH_VARARGS,               timestampfromticks_doc },
     { "dataSources",        (PyCFunction)mod_datasources,        METH_NOARGS,                datasources_doc },
+    { "enabletrace",        (PyCFunction)mod_enabletrace,        METH_NOARGS,                enabletrace_doc },
+    { "disabletrace",       (PyCFunction)mod_disabletrace,       METH_NOARGS,                disabletrace_doc },
+    { "draintrace",         (PyCFunction)mod_draintrace,         METH_NOARGS,                draintrace_doc },
+    { "allocations",        (PyCFunction)mod_allocations,        METH_NOARGS,                allocations_doc },
 
 #ifdef WINVER
     { "drivers", (PyCFunction)mod_drivers, METH_NOARGS, drivers_doc },
 #endif
 
-#ifdef PYODBC_LEAK_CHECK
-    { "leakcheck", (PyCFunction)mod_leakcheck, METH_NOARGS, 0 },
-#endif
 
     { 0, 0, 0, 0 }
 };
@@ -917,7 +977,9 @@ initpyodbc(void)
 {
     ErrorInit();
 
-    if (PyType_Ready(&ConnectionType) < 0 || PyType_Ready(&CursorType) < 0 || PyType_Ready(&RowType) < 0 || PyType_Ready(&CnxnInfoType) < 0)
+    if (PyType_Ready(&ConnectionType) < 0 || PyType_Ready(&CursorType) < 0 || PyType_Ready(&RowType) < 0 || PyType_Ready(&CnxnInfoType) < 0 ||
+        PyType_Ready(&PoolType) < 0 || PyType_Ready(&StatsType) < 0 || PyType_Ready(&ColumnMapType) < 0 ||
+        PyType_Ready(&LobReaderType) < 0)
         return MODRETURN(0);
 
     Object module;
@@ -934,6 +996,7 @@ initpyodbc(void)
         return MODRETURN(0);
 
     init_locale_info();
+    Trace_Init();
 
     const char* szVersion = TOSTRING(PYODBC_VERSION);
     PyModule_AddStringConstant(module, "version", (char*)szVersion);
@@ -952,6 +1015,13 @@ initpyodbc(void)
     Py_INCREF((PyObject*)&CursorType);
     PyModule_AddObject(module, "Row", (PyObject*)&RowType);
     Py_INCREF((PyObject*)&RowType);
+    PyModule_AddObject(module, "Pool", (PyObject*)&PoolType);
+    Py_INCREF((PyObject*)&PoolType);
+    PyModule_AddObject(module, "Stats", (PyObject*)&StatsType);
+    Py_INCREF((PyObject*)&StatsType);
+
+    PyModule_AddObject(module, "LobReader", (PyObject*)&LobReaderType);
+    Py_INCREF((PyObject*)&LobReaderType);
 
     // Add the SQL_XXX defines from ODBC.
     for (unsigned int i = 0; i < _countof(aConstants); i++)
@@ -35,6 +35,9 @@ inline bool PyDecimal_Check(PyObject* p)
 }
 extern HENV henv;
 
+// Allocates henv if it has not been allocated yet, which must happen before the first connection is made.
+bool AllocateEnv();
+
 extern PyTypeObject RowType;
 extern PyTypeObject CursorType;
 extern PyTypeObject ConnectionType;
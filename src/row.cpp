@@ -12,39 +12,30 @@
 #include "pyodbc.h"
 #include "pyodbcmodule.h"
 #include "row.h"
+#include "colmap.h"
+#include "rowblock.h"
 #include "wrapper.h"
 
-struct Row
-{
-    // A Row must act like a sequence (a tuple of results) to meet the DB API specification, but we also allow values
-    // to be accessed via lowercased column names.  We also supply a `columns` attribute which returns the list of
-    // column names.
-
-    PyObject_HEAD
+// Rows are allocated with pyodbc_malloc, like tuples with the values in the object, so creating one is a single
+// allocation.  Since fetching creates and releases many rows with the same number of columns, deallocated rows with
+// fewer than FREE_ROWS_COLUMNS values are kept on a free list for each number of values.  The lists are only used
+// with the GIL held.
+//
+// The rows on the free lists are counted in the "freerows" allocation category instead of "rows", so the latter is
+// always the number of rows in use.
 
-    // cursor.description, accessed as _description
-    PyObject* description;
+static const Py_ssize_t FREE_ROWS_COLUMNS = 32;
 
-    // A Python dictionary mapping from column name to a PyInteger, used to access columns by name.
-    PyObject* map_name_to_index;
+// The most rows kept on each free list.
+static const int FREE_ROWS_MAX = 256;
 
-    // The number of values in apValues.
-    Py_ssize_t cValues;
-    // The column values, stored as an array.
-    PyObject** apValues;
-};
+// The free lists, linked through each row's `description`, and their lengths.
+static Row* free_rows[FREE_ROWS_COLUMNS];
+static int free_rows_count[FREE_ROWS_COLUMNS];
 
-#define Row_Check(op) PyObject_TypeCheck(op, &RowType)
-#define Row_CheckExact(op) (Py_TYPE(op) == &RowType)
-
-void FreeRowValues(Py_ssize_t cValues, PyObject** apValues)
+inline size_t RowSize(Py_ssize_t cValues)
 {
-    if (apValues)
-    {
-        for (Py_ssize_t i = 0; i < cValues; i++)
-            Py_XDECREF(apValues[i]);
-        pyodbc_free(apValues);
-    }
+    return offsetof(Row, apValues) + sizeof(PyObject*) * (size_t)cValues;
 }
 
 static void Row_dealloc(PyObject* o)
@@ -52,57 +43,131 @@ static void Row_dealloc(PyObject* o)
     // Note: Now that __newobj__ is available, our variables could be zero...
 
     Row* self = (Row*)o;
+    Py_ssize_t cValues = Py_SIZE(self);
 
     Py_XDECREF(self->description);
     Py_XDECREF(self->map_name_to_index);
-    FreeRowValues(self->cValues, self->apValues);
-    PyObject_Del(self);
+    for (Py_ssize_t i = 0; i < cValues; i++)
+        Py_XDECREF(self->apValues[i]);
+    if (self->block)
+        RowBlock_Release(self->block);
+
+    if (cValues < FREE_ROWS_COLUMNS && free_rows_count[cValues] < FREE_ROWS_MAX)
+    {
+        self->description = (PyObject*)free_rows[cValues];
+        free_rows[cValues] = self;
+        free_rows_count[cValues]++;
+        pyodbc_setcategory(self, ALLOC_FREEROWS);
+        return;
+    }
+
+    pyodbc_free(self);
 }
 
 
-Row* Row_New(PyObject* description, PyObject* map_name_to_index, Py_ssize_t cValues, PyObject** apValues)
+Row* Row_New(PyObject* description, PyObject* map_name_to_index, Py_ssize_t cValues)
 {
-    // Called by other modules to create rows.  Takes ownership of apValues.
+    // Called by other modules to create rows.
 
-#ifdef _MSC_VER
-#pragma warning(disable : 4365)
-#endif
-    Row* row = PyObject_NEW(Row, &RowType);
-#ifdef _MSC_VER
-#pragma warning(default : 4365)
-#endif
+    Row* row;
 
-    if (row)
+    if (cValues < FREE_ROWS_COLUMNS && free_rows[cValues] != 0)
     {
-        Py_INCREF(description);
-        row->description = description;
-        Py_INCREF(map_name_to_index);
-        row->map_name_to_index = map_name_to_index;
-        row->apValues          = apValues;
-        row->cValues           = cValues;
+        row = free_rows[cValues];
+        free_rows[cValues] = (Row*)row->description;
+        free_rows_count[cValues]--;
+        pyodbc_setcategory(row, ALLOC_ROWS);
     }
     else
     {
-        FreeRowValues(cValues, apValues);
+        row = (Row*)pyodbc_malloc(ALLOC_ROWS, RowSize(cValues));
+        if (row == 0)
+        {
+            PyErr_NoMemory();
+            return 0;
+        }
     }
 
+    PyObject_INIT_VAR(row, &RowType, cValues);
+
+    Py_INCREF(description);
+    row->description = description;
+    Py_INCREF(map_name_to_index);
+    row->map_name_to_index = map_name_to_index;
+    row->block             = 0;
+    row->iRow              = 0;
+    memset(row->apValues, 0, sizeof(PyObject*) * (size_t)cValues);
+
     return row;
 }
 
 
+PyObject* Row_ConvertValue(Row* row, Py_ssize_t i)
+{
+    // Called by Row_GetValue to convert a lazy row's value the first time it is read.
+
+    I(row->block != 0 && row->apValues[i] == 0);
+
+    PyObject* value = RowBlock_GetValue(row->block, i, row->iRow);
+    if (value == 0)
+        return 0;
+
+    row->apValues[i] = value;
+
+    if (i == Py_SIZE(row) - 1)
+    {
+        // Values are usually read in order, so when the last one is read, release the rowset if they all have been.
+        Py_ssize_t iPending = 0;
+        while (iPending < i && row->apValues[iPending] != 0)
+            iPending++;
+        if (iPending == i)
+        {
+            RowBlock_Release(row->block);
+            row->block = 0;
+        }
+    }
+
+    return value;
+}
+
+
+static bool ConvertAll(Row* row)
+{
+    // Converts all of a lazy row's values, for the functions that use all of them, and releases its rowset.  Does
+    // nothing if the row isn't lazy.
+
+    if (row->block == 0)
+        return true;
+
+    for (Py_ssize_t i = 0; i < Py_SIZE(row); i++)
+    {
+        if (Row_GetValue(row, i) == 0)
+            return false;
+    }
+
+    // Converting the last value may have released it already.
+    if (row->block)
+    {
+        RowBlock_Release(row->block);
+        row->block = 0;
+    }
+    return true;
+}
+
+
 static PyObject* Row_getattro(PyObject* o, PyObject* name)
 {
     // Called to handle 'row.colname'.
 
     Row* self = (Row*)o;
 
-    PyObject* index = PyDict_GetItem(self->map_name_to_index, name);
+    Py_ssize_t i = ColumnMap_Lookup(self->map_name_to_index, name);
 
-    if (index)
+    if (i != -1)
     {
-        Py_ssize_t i = PyNumber_AsSsize_t(index, 0);
-        Py_INCREF(self->apValues[i]);
-        return self->apValues[i];
+        PyObject* value = Row_GetValue(self, i);
+        Py_XINCREF(value);
+        return value;
     }
 
     return PyObject_GenericGetAttr(o, name);
@@ -111,7 +176,7 @@ static PyObject* Row_getattro(PyObject* o, PyObject* name)
 
 static Py_ssize_t Row_length(PyObject* self)
 {
-    return ((Row*)self)->cValues;
+    return Py_SIZE(self);
 }
 
 
@@ -122,9 +187,12 @@ static int Row_contains(PyObject* o, PyObject* el)
 
     Row* self = (Row*)o;
 
+    if (!ConvertAll(self))
+        return -1;
+
     int cmp = 0;
 
-    for (Py_ssize_t i = 0, c = self->cValues ; cmp == 0 && i < c; ++i)
+    for (Py_ssize_t i = 0, c = Py_SIZE(self) ; cmp == 0 && i < c; ++i)
         cmp = PyObject_RichCompareBool(el, self->apValues[i], Py_EQ);
 
     return cmp;
@@ -137,14 +205,15 @@ static PyObject* Row_item(PyObject* o, Py_ssize_t i)
 
     Row* self = (Row*)o;
 
-    if (i < 0 || i >= self->cValues)
+    if (i < 0 || i >= Py_SIZE(self))
     {
         PyErr_SetString(PyExc_IndexError, "tuple index out of range");
         return NULL;
     }
 
-    Py_INCREF(self->apValues[i]);
-    return self->apValues[i];
+    PyObject* value = Row_GetValue(self, i);
+    Py_XINCREF(value);
+    return value;
 }
 
 
@@ -154,7 +223,7 @@ static int Row_ass_item(PyObject* o, Py_ssize_t i, PyObject* v)
 
     Row* self = (Row*)o;
 
-    if (i < 0 || i >= self->cValues)
+    if (i < 0 || i >= Py_SIZE(self))
     {
         PyErr_SetString(PyExc_IndexError, "Row assignment index out of range");
         return -1;
@@ -172,10 +241,10 @@ static int Row_setattro(PyObject* o, PyObject *name, PyObject* v)
 {
     Row* self = (Row*)o;
 
-    PyObject* index = PyDict_GetItem(self->map_name_to_index, name);
+    Py_ssize_t i = ColumnMap_Lookup(self->map_name_to_index, name);
 
-    if (index)
-        return Row_ass_item(o, PyNumber_AsSsize_t(index, 0), v);
+    if (i != -1)
+        return Row_ass_item(o, i, v);
 
     return PyObject_GenericSetAttr(o, name, v);
 }
@@ -185,16 +254,19 @@ static PyObject* Row_repr(PyObject* o)
 {
     Row* self = (Row*)o;
 
-    if (self->cValues == 0)
+    if (Py_SIZE(self) == 0)
         return PyString_FromString("()");
 
-    Object pieces(PyTuple_New(self->cValues));
+    if (!ConvertAll(self))
+        return 0;
+
+    Object pieces(PyTuple_New(Py_SIZE(self)));
     if (!pieces)
         return 0;
 
-    Py_ssize_t length = 2 + (2 * (self->cValues-1)); // parens + ', ' separators
+    Py_ssize_t length = 2 + (2 * (Py_SIZE(self)-1)); // parens + ', ' separators
 
-    for (Py_ssize_t i = 0; i < self->cValues; i++)
+    for (Py_ssize_t i = 0; i < Py_SIZE(self); i++)
     {
         PyObject* piece = PyObject_Repr(self->apValues[i]);
         if (!piece)
@@ -205,7 +277,7 @@ static PyObject* Row_repr(PyObject* o)
         PyTuple_SET_ITEM(pieces.Get(), i, piece);
     }
 
-    if (self->cValues == 1)
+    if (Py_SIZE(self) == 1)
     {
         // Need a trailing comma: (value,)
         length += 2;
@@ -217,13 +289,13 @@ static PyObject* Row_repr(PyObject* o)
     TEXT_T* buffer = Text_Buffer(result);
     Py_ssize_t offset = 0;
     buffer[offset++] = '(';
-    for (Py_ssize_t i = 0; i < self->cValues; i++)
+    for (Py_ssize_t i = 0; i < Py_SIZE(self); i++)
     {
         PyObject* item = PyTuple_GET_ITEM(pieces.Get(), i);
         memcpy(&buffer[offset], Text_Buffer(item), Text_Size(item) * sizeof(TEXT_T));
         offset += Text_Size(item);
 
-        if (i != self->cValues-1 || self->cValues == 1)
+        if (i != Py_SIZE(self)-1 || Py_SIZE(self) == 1)
         {
             buffer[offset++] = ',';
             buffer[offset++] = ' ';
@@ -248,18 +320,18 @@ static PyObject* Row_richcompare(PyObject* olhs, PyObject* orhs, int op)
     Row* lhs = (Row*)olhs;
     Row* rhs = (Row*)orhs;
 
-    if (lhs->cValues != rhs->cValues)
+    if (Py_SIZE(lhs) != Py_SIZE(rhs))
     {
         // Different sizes, so use the same rules as the tuple class.
         bool result;
         switch (op)
         {
-        case Py_EQ: result = (lhs->cValues == rhs->cValues); break;
-        case Py_GE: result = (lhs->cValues >= rhs->cValues); break;
-        case Py_GT: result = (lhs->cValues >  rhs->cValues); break;
-        case Py_LE: result = (lhs->cValues <= rhs->cValues); break;
-        case Py_LT: result = (lhs->cValues <  rhs->cValues); break;
-        case Py_NE: result = (lhs->cValues != rhs->cValues); break;
+        case Py_EQ: result = (Py_SIZE(lhs) == Py_SIZE(rhs)); break;
+        case Py_GE: result = (Py_SIZE(lhs) >= Py_SIZE(rhs)); break;
+        case Py_GT: result = (Py_SIZE(lhs) >  Py_SIZE(rhs)); break;
+        case Py_LE: result = (Py_SIZE(lhs) <= Py_SIZE(rhs)); break;
+        case Py_LT: result = (Py_SIZE(lhs) <  Py_SIZE(rhs)); break;
+        case Py_NE: result = (Py_SIZE(lhs) != Py_SIZE(rhs)); break;
         default:
             // Can't get here, but don't have a cross-compiler way to silence this.
             result = false;
@@ -269,7 +341,10 @@ static PyObject* Row_richcompare(PyObject* olhs, PyObject* orhs, int op)
         return p;
     }
 
-    for (Py_ssize_t i = 0, c = lhs->cValues; i < c; i++)
+    if (!ConvertAll(lhs) || !ConvertAll(rhs))
+        return 0;
+
+    for (Py_ssize_t i = 0, c = Py_SIZE(lhs); i < c; i++)
         if (!PyObject_RichCompareBool(lhs->apValues[i], rhs->apValues[i], Py_EQ))
             return PyObject_RichCompare(lhs->apValues[i], rhs->apValues[i], op);
 
@@ -301,30 +376,31 @@ static PyObject* Row_subscript(PyObject* o, PyObject* key)
         if (i == -1 && PyErr_Occurred())
             return 0;
         if (i < 0)
-            i += row->cValues;
+            i += Py_SIZE(row);
 
-        if (i < 0 || i >= row->cValues)
-            return PyErr_Format(PyExc_IndexError, "row index out of range index=%d len=%d", (int)i, (int)row->cValues);
+        if (i < 0 || i >= Py_SIZE(row))
+            return PyErr_Format(PyExc_IndexError, "row index out of range index=%d len=%d", (int)i, (int)Py_SIZE(row));
 
-        Py_INCREF(row->apValues[i]);
-        return row->apValues[i];
+        PyObject* value = Row_GetValue(row, i);
+        Py_XINCREF(value);
+        return value;
     }
 
     if (PySlice_Check(key))
     {
         Py_ssize_t start, stop, step, slicelength;
 #if PY_VERSION_HEX >= 0x03020000
-        if (PySlice_GetIndicesEx(key, row->cValues, &start, &stop, &step, &slicelength) < 0)
+        if (PySlice_GetIndicesEx(key, Py_SIZE(row), &start, &stop, &step, &slicelength) < 0)
             return 0;
 #else
-        if (PySlice_GetIndicesEx((PySliceObject*)key, row->cValues, &start, &stop, &step, &slicelength) < 0)
+        if (PySlice_GetIndicesEx((PySliceObject*)key, Py_SIZE(row), &start, &stop, &step, &slicelength) < 0)
             return 0;
 #endif
 
         if (slicelength <= 0)
             return PyTuple_New(0);
 
-        if (start == 0 && step == 1 && slicelength == row->cValues)
+        if (start == 0 && step == 1 && slicelength == Py_SIZE(row))
         {
             Py_INCREF(o);
             return o;
@@ -335,8 +411,11 @@ static PyObject* Row_subscript(PyObject* o, PyObject* key)
             return 0;
         for (Py_ssize_t i = 0, index = start; i < slicelength; i++, index += step)
         {
-            PyTuple_SET_ITEM(result.Get(), i, row->apValues[index]);
-            Py_INCREF(row->apValues[index]);
+            PyObject* value = Row_GetValue(row, index);
+            if (!value)
+                return 0;
+            PyTuple_SET_ITEM(result.Get(), i, value);
+            Py_INCREF(value);
         }
         return result.Detach();
     }
@@ -403,8 +482,8 @@ PyTypeObject RowType =
 {
     PyVarObject_HEAD_INIT(NULL, 0)
     "pyodbc.Row",                                           // tp_name
-    sizeof(Row),                                            // tp_basicsize
-    0,                                                      // tp_itemsize
+    sizeof(Row) - sizeof(PyObject*),                        // tp_basicsize
+    sizeof(PyObject*),                                      // tp_itemsize
     Row_dealloc,                                            // tp_dealloc
     0,                                                      // tp_print
     0,                                                      // tp_getattr
@@ -14,21 +14,51 @@
 #ifndef ROW_H
 #define ROW_H
 
-struct Row;
+struct RowBlock;
+
+struct Row
+{
+    // A Row must act like a sequence (a tuple of results) to meet the DB API specification, but we also allow values
+    // to be accessed via lowercased column names.  We also supply a `columns` attribute which returns the list of
+    // column names.
+
+    // ob_size is the number of values.
+    PyObject_VAR_HEAD
+
+    // cursor.description, accessed as _description
+    PyObject* description;
+
+    // The cursor's ColumnMap, used to access columns by name.
+    PyObject* map_name_to_index;
+
+    // If this is a lazy row, the rowset its values are read from and the row's index in it.  Otherwise zero.
+    RowBlock* block;
+    SQLULEN iRow;
+
+    // The column values.  Like a tuple's, they are stored in the object, which is allocated with room for ob_size of
+    // them.  In a lazy row, the values that haven't been read yet are zero.  Use Row_GetValue to read them.
+    PyObject* apValues[1];
+};
 
 /*
- * Used to make a new row from an array of column values.
+ * Used to make a new row with room for `cValues` column values.  The values are all zero and must be set by the
+ * caller before the row is used.  (It is safe to release the row before they are all set.)
  */
-Row* Row_New(PyObject* description, PyObject* map_name_to_index, Py_ssize_t cValues, PyObject** apValues);
+Row* Row_New(PyObject* description, PyObject* map_name_to_index, Py_ssize_t cValues);
+
+PyObject* Row_ConvertValue(Row* row, Py_ssize_t i);
 
 /*
- * Dereferences each object in apValues and frees apValue.  This is the internal format used by rows.
- *
- * cValues: The number of items to free in apValues.
- *
- * apValues: The array of values.  This can be NULL.
+ * Returns a borrowed reference to value `i`, converting it first if the row is lazy and it hasn't been read.  Returns
+ * zero with an exception set if the conversion fails.
  */
-void FreeRowValues(Py_ssize_t cValues, PyObject** apValues);
+inline PyObject* Row_GetValue(Row* row, Py_ssize_t i)
+{
+    PyObject* value = row->apValues[i];
+    if (value == 0)
+        value = Row_ConvertValue(row, i);
+    return value;
+}
 
 extern PyTypeObject RowType;
 #define Row_Check(op) PyObject_TypeCheck(op, &RowType)
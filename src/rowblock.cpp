@@ -0,0 +1,208 @@
+// The rowsets used by lazy rows, enabled by setting Cursor.lazyrows.
+//
+// When every result column is bound, a lazy row doesn't convert its values when it is fetched.  It keeps a reference
+// to the RowBlock of the rowset it came from and the row's index in it, and each value is converted by the column's
+// BoundReader the first time it is read.  Rows that are only partly read never create objects for the other columns.
+//
+// A block starts out reading the cursor's fetch buffer directly.  Before the cursor overwrites the rowset (by fetching
+// the next one) or frees it, it detaches the block.  If rows still use the block, the block takes the fetch buffer and
+// the cursor binds its columns to a new one, so the rowset is never copied; otherwise the block is freed.  The only
+// exception is a prefetching cursor, whose fetch buffer also holds the rowsets being fetched by its thread, so the
+// block copies its rowset instead.  A block is freed when the last row using it is deallocated.
+//
+// Blocks are only used with the GIL held, so the reference counts aren't atomic.
+
+#include "pyodbc.h"
+#include "cursor.h"
+#include "rowblock.h"
+#include "getdata.h"
+
+struct RowBlock
+{
+    // The number of rows using the block, plus one while it is the cursor's row_block.
+    Py_ssize_t refcount;
+
+    // The memory holding the rowset after the block was detached while rows still used it: the cursor's fetch buffer or,
+    // when prefetching, a copy of the rowset.  The block's ColumnInfos point into it.
+    char* rowset;
+
+    // Set if the rowset needed to be copied but there wasn't enough memory.
+    bool discarded;
+
+    // A reference to the cursor's overflow_values for the rowset, if it had any.
+    PyObject* overflow_values;
+
+    Py_ssize_t cCols;
+
+    // The cursor's ColumnInfos, allocated with room for all of the columns.  The `data` and `lengths` pointers point
+    // into the cursor's rowset, then into `rowset`.
+    ColumnInfo colinfos[1];
+};
+
+
+RowBlock* RowBlock_Get(Cursor* cur)
+{
+    RowBlock* block = cur->row_block;
+
+    if (block == 0)
+    {
+        Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+        block = (RowBlock*)pyodbc_malloc(ALLOC_ROWBLOCKS, offsetof(RowBlock, colinfos) + sizeof(ColumnInfo) * (size_t)cCols);
+        if (block == 0)
+        {
+            PyErr_NoMemory();
+            return 0;
+        }
+
+        block->refcount  = 1;
+        block->rowset    = 0;
+        block->discarded = false;
+        block->cCols     = cCols;
+        block->overflow_values = cur->overflow_values;
+        Py_XINCREF(block->overflow_values);
+        memcpy(block->colinfos, cur->colinfos, sizeof(ColumnInfo) * (size_t)cCols);
+
+        cur->row_block = block;
+    }
+
+    block->refcount++;
+    return block;
+}
+
+
+static SQLRETURN BindRowset(Cursor* cur, char* pb)
+{
+    // Binds the row status array and columns to the same locations in `pb` that they have in the fetch buffer.  Called
+    // without the GIL.
+
+    SQLRETURN ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_ROW_STATUS_PTR, pb + ((char*)cur->row_status - cur->fetch_buffer), 0);
+
+    Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+    for (Py_ssize_t i = 0; i < cCols && SQL_SUCCEEDED(ret); i++)
+    {
+        const ColumnInfo* pinfo = &cur->colinfos[i];
+        ret = SQLBindCol(cur->hstmt, (SQLUSMALLINT)(i + 1), pinfo->c_type, pb + (pinfo->data - cur->fetch_buffer),
+                         pinfo->buffer_length, (SQLLEN*)(pb + ((char*)pinfo->lengths - cur->fetch_buffer)));
+    }
+
+    return ret;
+}
+
+
+static bool ReplaceFetchBuffer(Cursor* cur, RowBlock* block)
+{
+    // Gives the cursor's fetch buffer to the block and binds the cursor's columns to a new one.  Returns false, leaving
+    // the cursor unchanged, if a new buffer couldn't be allocated or bound.
+
+    I(cur->prefetcher == 0 && (char*)cur->row_status == cur->fetch_buffer);
+
+    char* pbOld = cur->fetch_buffer;
+    char* pbNew = (char*)pyodbc_malloc(ALLOC_FETCH, cur->rowset_bytes);
+    if (pbNew == 0)
+        return false;
+
+    SQLRETURN ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = BindRowset(cur, pbNew);
+    if (!SQL_SUCCEEDED(ret))
+        BindRowset(cur, pbOld);
+    Py_END_ALLOW_THREADS
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        pyodbc_free(pbNew);
+        return false;
+    }
+
+    Py_ssize_t cCols = PyTuple_GET_SIZE(cur->description);
+    for (Py_ssize_t i = 0; i < cCols; i++)
+    {
+        ColumnInfo* pinfo = &cur->colinfos[i];
+        pinfo->data    = pbNew + (pinfo->data - pbOld);
+        pinfo->lengths = (SQLLEN*)(pbNew + ((char*)pinfo->lengths - pbOld));
+    }
+
+    cur->fetch_buffer = pbNew;
+    cur->row_status   = (SQLUSMALLINT*)pbNew;
+    block->rowset     = pbOld;
+    return true;
+}
+
+
+static void CopyRowset(Cursor* cur, RowBlock* block)
+{
+    // The rowset starts with the row status array, followed by the columns' lengths and data.
+    char* rowset = (char*)cur->row_status;
+
+    block->rowset = (char*)pyodbc_malloc(ALLOC_ROWBLOCKS, cur->rowset_bytes);
+    if (block->rowset == 0)
+    {
+        // We can't fail here, so the values that haven't been read are lost.
+        block->discarded = true;
+        return;
+    }
+
+    memcpy(block->rowset, rowset, cur->rowset_bytes);
+
+    for (Py_ssize_t i = 0; i < block->cCols; i++)
+    {
+        ColumnInfo* pinfo = &block->colinfos[i];
+        pinfo->data    = block->rowset + (pinfo->data - rowset);
+        pinfo->lengths = (SQLLEN*)(block->rowset + ((char*)pinfo->lengths - rowset));
+    }
+}
+
+
+void RowBlock_Detach(Cursor* cur, bool fFreeing)
+{
+    RowBlock* block = cur->row_block;
+    if (block == 0)
+        return;
+
+    cur->row_block = 0;
+
+    if (block->refcount > 1)
+    {
+        if (fFreeing)
+        {
+            // The cursor is done with the fetch buffer, so the block keeps it.  (If the cursor was prefetching, this
+            // includes the other rowsets, which are freed with the block.)
+            block->rowset = cur->fetch_buffer;
+            cur->fetch_buffer = 0;
+        }
+        else if (cur->prefetcher != 0 || !ReplaceFetchBuffer(cur, block))
+        {
+            CopyRowset(cur, block);
+        }
+    }
+
+    RowBlock_Release(block);
+}
+
+
+void RowBlock_Release(RowBlock* block)
+{
+    if (--block->refcount == 0)
+    {
+        Py_XDECREF(block->overflow_values);
+        pyodbc_free(block->rowset);
+        pyodbc_free(block);
+    }
+}
+
+
+PyObject* RowBlock_GetValue(RowBlock* block, Py_ssize_t iCol, SQLULEN iRow)
+{
+    if (block->discarded)
+        return PyErr_NoMemory();
+
+    if (block->overflow_values)
+    {
+        PyObject* value = GetData_GetOverflow(block->overflow_values, block->cCols, iCol, iRow);
+        if (value || PyErr_Occurred())
+            return value;
+    }
+
+    const ColumnInfo* pinfo = &block->colinfos[iCol];
+    return pinfo->bound_reader(pinfo, iCol, iRow);
+}
@@ -0,0 +1,31 @@
+#ifndef _ROWBLOCK_H_
+#define _ROWBLOCK_H_
+
+struct Cursor;
+struct RowBlock;
+
+/**
+ * Returns the cursor's RowBlock for its current rowset, creating it if necessary, with a new reference for a lazy row.
+ * Returns zero with an exception set if there isn't enough memory.
+ */
+RowBlock* RowBlock_Get(Cursor* cur);
+
+/**
+ * Releases the cursor's RowBlock, if it has one.  Must be called before the rowset in the fetch buffer is overwritten
+ * or freed.  If lazy rows still use the block, it takes the cursor's fetch buffer.  If `fFreeing` is true, the cursor
+ * is about to free its results and fetch_buffer is set to zero; otherwise the columns are bound to a new fetch buffer.
+ */
+void RowBlock_Detach(Cursor* cur, bool fFreeing);
+
+/**
+ * Releases a lazy row's reference.
+ */
+void RowBlock_Release(RowBlock* block);
+
+/**
+ * Converts the value of column `iCol` in row `iRow` of the block's rowset.  Returns a new reference, or zero with an
+ * exception set.
+ */
+PyObject* RowBlock_GetValue(RowBlock* block, Py_ssize_t iCol, SQLULEN iRow);
+
+#endif // _ROWBLOCK_H_
@@ -107,7 +107,7 @@ bool SQLWChar::Convert(PyObject* o)
     }
     else
     {
-        SQLWCHAR* pchT = (SQLWCHAR*)pyodbc_malloc(sizeof(SQLWCHAR) * (lenT + 1));
+        SQLWCHAR* pchT = (SQLWCHAR*)pyodbc_malloc(ALLOC_SQLWCHAR, sizeof(SQLWCHAR) * (lenT + 1));
         if (pchT == 0)
         {
             PyErr_NoMemory();
@@ -127,10 +127,114 @@ bool SQLWChar::Convert(PyObject* o)
     }
 }
 
+#if PY_VERSION_HEX >= 0x03030000
+
+// Python 3.3+ (PEP 393) stores each string as 1, 2, or 4 bytes per character depending on its largest character.
+// Creating one from Py_UNICODE makes Python scan and copy it again, so UTF-16 is decoded directly into a string of the
+// right kind instead.
+
+inline bool IsHighSurrogate(unsigned int ch) { return ch >= 0xD800 && ch <= 0xDBFF; }
+inline bool IsLowSurrogate(unsigned int ch)  { return ch >= 0xDC00 && ch <= 0xDFFF; }
+
+static unsigned int OrUTF16(const SQLWCHAR* sz, Py_ssize_t cch)
+{
+    // Returns all of the characters or'd together.  If the result is less than 0x80 the text is ASCII, and if it is less
+    // than 0x100 it is Latin-1.  Four characters are tested at a time, which is where most of the time goes since
+    // most text is ASCII.
+
+    UINT64 bits = 0;
+    Py_ssize_t i = 0;
+
+    for (; i + 4 <= cch; i += 4)
+    {
+        UINT64 chunk;
+        memcpy(&chunk, &sz[i], sizeof(chunk));
+        bits |= chunk;
+    }
+
+    // Fold the four 16-bit lanes.
+    unsigned int result = (unsigned int)((bits | (bits >> 16) | (bits >> 32) | (bits >> 48)) & 0xFFFF);
+
+    for (; i < cch; i++)
+        result |= (unsigned int)sz[i];
+
+    return result;
+}
+
+static PyObject* PyUnicode_FromUTF16(const SQLWCHAR* sz, Py_ssize_t cch)
+{
+    // Lone surrogates are kept as they are, like PyUnicode_FromWideChar does on Windows.
+
+    unsigned int bits = OrUTF16(sz, cch);
+
+    if (bits < 0x100)
+    {
+        PyObject* result = PyUnicode_New(cch, (bits < 0x80) ? 0x7F : 0xFF);
+        if (result == 0)
+            return 0;
+        Py_UCS1* p = PyUnicode_1BYTE_DATA(result);
+        for (Py_ssize_t i = 0; i < cch; i++)
+            p[i] = (Py_UCS1)sz[i];
+        return result;
+    }
+
+    // Find the largest character and the number of surrogate pairs, which need the 4-byte kind.
+
+    Py_UCS4 maxchar = 0;
+    Py_ssize_t pairs = 0;
+
+    for (Py_ssize_t i = 0; i < cch; i++)
+    {
+        Py_UCS4 ch = (Py_UCS4)sz[i];
+        if (IsHighSurrogate(ch) && i + 1 < cch && IsLowSurrogate(sz[i + 1]))
+        {
+            ch = 0x10000 + (((ch - 0xD800) << 10) | ((Py_UCS4)sz[i + 1] - 0xDC00));
+            pairs++;
+            i++;
+        }
+        if (ch > maxchar)
+            maxchar = ch;
+    }
+
+    PyObject* result = PyUnicode_New(cch - pairs, maxchar);
+    if (result == 0)
+        return 0;
+
+    if (pairs == 0)
+    {
+        Py_UCS2* p = PyUnicode_2BYTE_DATA(result);
+        for (Py_ssize_t i = 0; i < cch; i++)
+            p[i] = (Py_UCS2)sz[i];
+        return result;
+    }
+
+    Py_UCS4* p = PyUnicode_4BYTE_DATA(result);
+    for (Py_ssize_t i = 0; i < cch; i++)
+    {
+        Py_UCS4 ch = (Py_UCS4)sz[i];
+        if (IsHighSurrogate(ch) && i + 1 < cch && IsLowSurrogate(sz[i + 1]))
+        {
+            ch = 0x10000 + (((ch - 0xD800) << 10) | ((Py_UCS4)sz[i + 1] - 0xDC00));
+            i++;
+        }
+        *p++ = ch;
+    }
+    return result;
+}
+
+#endif
+
 PyObject* PyUnicode_FromSQLWCHAR(const SQLWCHAR* sz, Py_ssize_t cch)
 {
     // Create a Python Unicode object from a zero-terminated SQLWCHAR.
 
+#if PY_VERSION_HEX >= 0x03030000
+    if (SQLWCHAR_SIZE == 2)
+        return PyUnicode_FromUTF16(sz, cch);
+    if (SQLWCHAR_SIZE == 4)
+        return PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, sz, cch);
+#endif
+
     if (SQLWCHAR_SIZE == Py_UNICODE_SIZE)
     {
         // The ODBC Unicode and Python Unicode types are the same size.  Cast the ODBC type to the Python type and use
@@ -207,16 +311,15 @@ void SQLWChar::dump()
 }
 
 
-SQLWCHAR* SQLWCHAR_FromUnicode(const Py_UNICODE* pch, Py_ssize_t len)
+SQLWCHAR* SQLWCHAR_FromUnicode(Arena& arena, const Py_UNICODE* pch, Py_ssize_t len)
 {
-    SQLWCHAR* p = (SQLWCHAR*)pyodbc_malloc(sizeof(SQLWCHAR) * (len+1));
-    if (p != 0)
+    SQLWCHAR* p = (SQLWCHAR*)Arena_Alloc(arena, sizeof(SQLWCHAR) * (len+1));
+    if (p == 0)
     {
-        if (!sqlwchar_copy(p, pch, len))
-        {
-            pyodbc_free(p);
-            p = 0;
-        }
+        PyErr_NoMemory();
+        return 0;
     }
+    if (!sqlwchar_copy(p, pch, len))
+        return 0;
     return p;
 }
@@ -57,6 +57,8 @@ extern Py_ssize_t SQLWCHAR_SIZE;
 // Allocate a new Unicode object, initialized from the given SQLWCHAR string.
 PyObject* PyUnicode_FromSQLWCHAR(const SQLWCHAR* sz, Py_ssize_t cch);
 
-SQLWCHAR* SQLWCHAR_FromUnicode(const Py_UNICODE* pch, Py_ssize_t len);
+// Copies a Unicode string, including its NULL terminator, to a SQLWCHAR buffer allocated from `arena`.  Returns zero with
+// an exception set if there isn't enough memory or a character can't be converted.
+SQLWCHAR* SQLWCHAR_FromUnicode(Arena& arena, const Py_UNICODE* pch, Py_ssize_t len);
 
 #endif // _PYODBCSQLWCHAR_H
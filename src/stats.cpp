@@ -0,0 +1,265 @@
+// Statistics about where the time goes when executing and fetching, created by pyodbc.Stats.
+//
+// Collecting them is opt-in: a Stats object only counts anything once it is assigned to Connection.stats or
+// Cursor.stats.  A cursor records into its own Stats object and its connection's, so one object can be shared by many
+// connections to aggregate them.  Each ODBC call that is counted is timed from just before its Py_BEGIN_ALLOW_THREADS
+// to just after its Py_END_ALLOW_THREADS.  The counters are only updated while holding the GIL, so they don't need a
+// lock.
+//
+// When no Stats object is assigned, the cost is a test of two pointers around each of those calls.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "cursor.h"
+#include "connection.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+
+INT64 Stats_Now()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // Split the conversion so the multiplication doesn't overflow.
+    return (counter.QuadPart / frequency.QuadPart) * 1000000000 +
+        (counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+    return (INT64)(mach_absolute_time() * timebase.numer / timebase.denom);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (INT64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+
+void Stats_AddCalls(Cursor* cur, StatsCall call, INT64 start, INT64 count)
+{
+    INT64 ns = Stats_Now() - start;
+
+    cur->odbc_ns += ns;
+
+    Stats* stats[2] = { cur->stats, cur->cnxn->stats };
+    for (int i = 0; i < 2; i++)
+    {
+        if (stats[i] != 0 && (i == 0 || stats[i] != stats[0]))
+        {
+            stats[i]->calls[call] += count;
+            stats[i]->ns[call]    += ns;
+        }
+    }
+}
+
+
+void Stats_AddRows(Cursor* cur, INT64 start, INT64 odbc_ns, INT64 count)
+{
+    INT64 ns = Stats_Now() - start - (cur->odbc_ns - odbc_ns);
+
+    Stats* stats[2] = { cur->stats, cur->cnxn->stats };
+    for (int i = 0; i < 2; i++)
+    {
+        if (stats[i] != 0 && (i == 0 || stats[i] != stats[0]))
+        {
+            stats[i]->rows       += count;
+            stats[i]->convert_ns += ns;
+        }
+    }
+}
+
+
+void Stats_AddBytes(Cursor* cur, INT64 count)
+{
+    Stats* stats[2] = { cur->stats, cur->cnxn->stats };
+    for (int i = 0; i < 2; i++)
+    {
+        if (stats[i] != 0 && (i == 0 || stats[i] != stats[0]))
+            stats[i]->bytes += count;
+    }
+}
+
+
+PyObject* Stats_Get(Stats* stats)
+{
+    PyObject* result = stats ? (PyObject*)stats : Py_None;
+    Py_INCREF(result);
+    return result;
+}
+
+
+int Stats_Set(Stats*& stats, PyObject* value)
+{
+    if (value == 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the stats attribute");
+        return -1;
+    }
+
+    if (value != Py_None && !Stats_Check(value))
+    {
+        PyErr_SetString(PyExc_TypeError, "stats must be a pyodbc.Stats object or None");
+        return -1;
+    }
+
+    Stats* old = stats;
+    if (value == Py_None)
+    {
+        stats = 0;
+    }
+    else
+    {
+        Py_INCREF(value);
+        stats = (Stats*)value;
+    }
+    Py_XDECREF(old);
+    return 0;
+}
+
+
+static PyObject* Stats_new(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    if (!PyArg_ParseTuple(args, ":Stats") || (kwargs && PyDict_Size(kwargs) != 0))
+    {
+        if (!PyErr_Occurred())
+            PyErr_SetString(PyExc_TypeError, "Stats() takes no arguments");
+        return 0;
+    }
+
+    // tp_alloc zeros the counters.
+    return type->tp_alloc(type, 0);
+}
+
+
+static void Stats_dealloc(PyObject* self)
+{
+    Py_TYPE(self)->tp_free(self);
+}
+
+
+static char reset_doc[] =
+    "reset() --> None\n"
+    "\n"
+    "Sets all of the counters to zero.";
+
+static PyObject* Stats_reset(PyObject* self, PyObject* args)
+{
+    UNUSED(args);
+
+    Stats* stats = (Stats*)self;
+    for (int i = 0; i < STATS_CALL_COUNT; i++)
+    {
+        stats->calls[i] = 0;
+        stats->ns[i]    = 0;
+    }
+    stats->rows       = 0;
+    stats->bytes      = 0;
+    stats->convert_ns = 0;
+
+    Py_RETURN_NONE;
+}
+
+
+#define CALL_MEMBERS(name, call)                                                                            \
+    { name "_calls", T_LONGLONG, offsetof(Stats, calls) + call * sizeof(INT64), READONLY,                   \
+      "The number of " name " calls." },                                                                    \
+    { name "_ns",    T_LONGLONG, offsetof(Stats, ns) + call * sizeof(INT64), READONLY,                      \
+      "Nanoseconds spent in " name " calls." }
+
+static PyMemberDef Stats_members[] =
+{
+    CALL_MEMBERS("prepare", STATS_PREPARE),
+    CALL_MEMBERS("execute", STATS_EXECUTE),
+    CALL_MEMBERS("fetch",   STATS_FETCH),
+    CALL_MEMBERS("getdata", STATS_GETDATA),
+    CALL_MEMBERS("putdata", STATS_PUTDATA),
+    { "rows",       T_LONGLONG, offsetof(Stats, rows),       READONLY, "The number of rows fetched and converted." },
+    { "bytes",      T_LONGLONG, offsetof(Stats, bytes),      READONLY, "Bytes of character and binary data converted to Python objects." },
+    { "convert_ns", T_LONGLONG, offsetof(Stats, convert_ns), READONLY, "Nanoseconds spent converting fetched rows, not including the ODBC calls." },
+    { 0 }
+};
+
+static struct PyMethodDef Stats_methods[] =
+{
+    { "reset", Stats_reset, METH_NOARGS, reset_doc },
+    { 0, 0, 0, 0 }
+};
+
+static char stats_doc[] =
+    "Stats() --> Stats\n"
+    "\n"
+    "Counters describing where time is spent executing statements and fetching\n"
+    "results.  They are only collected after the object is assigned to a\n"
+    "connection's or cursor's stats attribute, and a cursor updates both its own\n"
+    "and its connection's.  The same object can be assigned to many connections.\n"
+    "\n"
+    "For each of the ODBC calls prepare, execute, fetch, getdata, and putdata there\n"
+    "is a count (such as fetch_calls) and the nanoseconds spent in the driver (such\n"
+    "as fetch_ns).  When a cursor's results are prefetched, fetch_ns is the time\n"
+    "spent waiting for the prefetch thread.\n"
+    "\n"
+    "rows, bytes, and convert_ns count the rows converted to Row objects (or\n"
+    "arrays by fetchnumpy and fetcharrow), the character and binary data converted,\n"
+    "and the nanoseconds spent converting, excluding the ODBC calls made while\n"
+    "doing so.";
+
+PyTypeObject StatsType =
+{
+    PyVarObject_HEAD_INIT(0, 0)
+    "pyodbc.Stats",             // tp_name
+    sizeof(Stats),              // tp_basicsize
+    0,                          // tp_itemsize
+    Stats_dealloc,              // destructor tp_dealloc
+    0,                          // tp_print
+    0,                          // tp_getattr
+    0,                          // tp_setattr
+    0,                          // tp_compare
+    0,                          // tp_repr
+    0,                          // tp_as_number
+    0,                          // tp_as_sequence
+    0,                          // tp_as_mapping
+    0,                          // tp_hash
+    0,                          // tp_call
+    0,                          // tp_str
+    0,                          // tp_getattro
+    0,                          // tp_setattro
+    0,                          // tp_as_buffer
+    Py_TPFLAGS_DEFAULT,         // tp_flags
+    stats_doc,                  // tp_doc
+    0,                          // tp_traverse
+    0,                          // tp_clear
+    0,                          // tp_richcompare
+    0,                          // tp_weaklistoffset
+    0,                          // tp_iter
+    0,                          // tp_iternext
+    Stats_methods,              // tp_methods
+    Stats_members,              // tp_members
+    0,                          // tp_getset
+    0,                          // tp_base
+    0,                          // tp_dict
+    0,                          // tp_descr_get
+    0,                          // tp_descr_set
+    0,                          // tp_dictoffset
+    0,                          // tp_init
+    0,                          // tp_alloc
+    Stats_new,                  // tp_new
+    0,                          // tp_free
+    0,                          // tp_is_gc
+    0,                          // tp_bases
+    0,                          // tp_mro
+    0,                          // tp_cache
+    0,                          // tp_subclasses
+    0,                          // tp_weaklist
+};
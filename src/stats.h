@@ -0,0 +1,106 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+// Statistics collected by cursors when a Stats object has been assigned to Cursor.stats or Connection.stats.  See
+// stats.cpp.
+//
+// The inline functions below use the Cursor and Connection structures, so include this after cursor.h and
+// connection.h.
+
+#include "trace.h"
+
+extern PyTypeObject StatsType;
+
+// The ODBC calls that are counted and timed.
+enum StatsCall
+{
+    STATS_PREPARE,
+    STATS_EXECUTE,
+    STATS_FETCH,
+    STATS_GETDATA,
+    STATS_PUTDATA,
+    STATS_CALL_COUNT
+};
+
+struct Stats
+{
+    PyObject_HEAD
+
+    INT64 calls[STATS_CALL_COUNT];
+    INT64 ns[STATS_CALL_COUNT]; // Nanoseconds spent in the calls, which are made without the GIL.
+
+    INT64 rows;                 // Rows fetched and converted.
+    INT64 bytes;                // Bytes of character and binary data converted to Python objects.
+    INT64 convert_ns;           // Nanoseconds spent converting rows, not counting the ODBC calls made while doing so.
+};
+
+#define Stats_Check(op) PyObject_TypeCheck(op, &StatsType)
+
+/**
+ * Returns a monotonic clock in nanoseconds.  Only differences are used.
+ */
+INT64 Stats_Now();
+
+/**
+ * Returns the Connection.stats or Cursor.stats attribute: a new reference to the Stats object or None.
+ */
+PyObject* Stats_Get(Stats* stats);
+
+/**
+ * Implements setting Connection.stats or Cursor.stats to a Stats object or None.  Returns 0, or -1 with an exception
+ * set.
+ */
+int Stats_Set(Stats*& stats, PyObject* value);
+
+void Stats_AddCalls(Cursor* cur, StatsCall call, INT64 start, INT64 count);
+void Stats_AddRows(Cursor* cur, INT64 start, INT64 odbc_ns, INT64 count);
+void Stats_AddBytes(Cursor* cur, INT64 count);
+
+inline bool Stats_Enabled(Cursor* cur)
+{
+    return cur->stats != 0 || cur->cnxn->stats != 0;
+}
+
+/**
+ * Returns the start time to pass to Stats_EndCall, Stats_EndRows, or Trace_Call, or zero if neither statistics nor a
+ * trace are being collected.
+ */
+inline INT64 Stats_Start(Cursor* cur)
+{
+    return (trace_enabled || Stats_Enabled(cur)) ? Stats_Now() : 0;
+}
+
+/**
+ * Returns the start time to pass to Trace_Call for calls that aren't made by a cursor, or zero if tracing is off.
+ */
+inline INT64 Trace_Start()
+{
+    return trace_enabled ? Stats_Now() : 0;
+}
+
+/**
+ * Adds `count` calls that ran from `start` until now.  Does nothing if `start` is zero.
+ */
+inline void Stats_EndCall(Cursor* cur, StatsCall call, INT64 start, INT64 count = 1)
+{
+    if (start != 0 && Stats_Enabled(cur))
+        Stats_AddCalls(cur, call, start, count);
+}
+
+/**
+ * Adds `count` rows that were converted from `start` until now.  `odbc_ns` must be the value of cur->odbc_ns at
+ * `start` so the time spent in ODBC calls can be subtracted.  Does nothing if `start` is zero.
+ */
+inline void Stats_EndRows(Cursor* cur, INT64 start, INT64 odbc_ns, INT64 count = 1)
+{
+    if (start != 0 && Stats_Enabled(cur))
+        Stats_AddRows(cur, start, odbc_ns, count);
+}
+
+inline void Stats_Bytes(Cursor* cur, SQLLEN cb)
+{
+    if (Stats_Enabled(cur))
+        Stats_AddBytes(cur, cb);
+}
+
+#endif // _STATS_H_
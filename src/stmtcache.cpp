@@ -0,0 +1,327 @@
+// A per-connection cache of prepared statements, enabled by setting Connection.statement_cache_size.
+//
+// A cursor only avoids preparing SQL again when the same SQL object is executed on it twice in a row.  Applications
+// that alternate between statements, or that use Connection.execute which creates a new cursor for every call, prepare
+// the same SQL over and over.  With the cache enabled, a cursor that moves on to different SQL or is closed gives its
+// prepared HSTMT to the connection, and cursors look in the cache before preparing.
+//
+// The cache is an array ordered from the most to the least recently used statement.  It is expected to be small, so
+// it is searched linearly.  Each statement records its query timeout and noscan attributes, which are changed to the
+// connection's current timeout and the receiving cursor's noscan setting when another cursor reuses it.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "stmtcache.h"
+#include "cursor.h"
+#include "connection.h"
+#include "errors.h"
+#include "params.h"
+
+static bool SameSQL(PyObject* a, PyObject* b)
+{
+    if (a == b)
+        return true;
+
+    if (Py_TYPE(a) != Py_TYPE(b) || PyObject_Hash(a) != PyObject_Hash(b))
+        return false;
+
+    int result = PyObject_RichCompareBool(a, b, Py_EQ);
+    if (result == -1)
+    {
+        PyErr_Clear();
+        return false;
+    }
+    return result == 1;
+}
+
+
+static int FindStatement(Connection* cnxn, PyObject* pSql)
+{
+    for (int i = 0; i < cnxn->stmtcache_count; i++)
+        if (SameSQL(cnxn->stmtcache[i].sql, pSql))
+            return i;
+    return -1;
+}
+
+
+static void RemoveStatement(Connection* cnxn, int i, CachedStatement& entry)
+{
+    entry = cnxn->stmtcache[i];
+    memmove(&cnxn->stmtcache[i], &cnxn->stmtcache[i + 1], sizeof(CachedStatement) * (cnxn->stmtcache_count - i - 1));
+    cnxn->stmtcache_count--;
+}
+
+
+static void PushStatement(Connection* cnxn, Cursor* cur)
+{
+    // Moves the cursor's prepared statement to the front of the cache.  The caller must make sure there is room.
+
+    I(cnxn->stmtcache_count < cnxn->stmtcache_capacity);
+
+    memmove(&cnxn->stmtcache[1], &cnxn->stmtcache[0], sizeof(CachedStatement) * cnxn->stmtcache_count);
+    cnxn->stmtcache_count++;
+
+    CachedStatement& entry = cnxn->stmtcache[0];
+    entry.sql        = cur->pPreparedSQL;
+    entry.hstmt      = cur->hstmt;
+    entry.paramcount = cur->paramcount;
+    entry.paramtypes = cur->paramtypes;
+    entry.timeout    = cur->timeout;
+    entry.noscan     = cur->noscan;
+
+    cur->pPreparedSQL = 0;
+    cur->hstmt        = SQL_NULL_HANDLE;
+    cur->paramcount   = 0;
+    cur->paramtypes   = 0;
+}
+
+
+static void EvictStatement(Connection* cnxn, CachedStatement& entry)
+{
+    // Makes room for one statement.  If the least recently used statement had to be removed, `entry` is set to it and
+    // the caller must reuse or free its HSTMT.  Otherwise entry.hstmt is set to SQL_NULL_HANDLE.
+
+    entry.hstmt = SQL_NULL_HANDLE;
+
+    if (cnxn->stmtcache_count < cnxn->stmtcache_capacity)
+        return;
+
+    RemoveStatement(cnxn, cnxn->stmtcache_count - 1, entry);
+    Py_DECREF(entry.sql);
+    pyodbc_free(entry.paramtypes);
+    entry.sql        = 0;
+    entry.paramtypes = 0;
+}
+
+
+static void FreeStatement(HSTMT hstmt)
+{
+    Py_BEGIN_ALLOW_THREADS
+    SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+    Py_END_ALLOW_THREADS
+}
+
+
+static bool CloseStatement(Cursor* cur)
+{
+    // Closes the cursor's statement and unbinds its parameters so the HSTMT can be put in the cache.  Column bindings
+    // have already been removed by free_results.
+    //
+    // Returns false if the connection was closed by another thread while the GIL was released.
+
+    Py_BEGIN_ALLOW_THREADS
+    SQLFreeStmt(cur->hstmt, SQL_CLOSE);
+    SQLFreeStmt(cur->hstmt, SQL_RESET_PARAMS);
+    Py_END_ALLOW_THREADS
+
+    return cur->cnxn->hdbc != SQL_NULL_HANDLE;
+}
+
+
+static bool SetAttributes(Cursor* cur, intptr_t timeout, bool noscan)
+{
+    // Gives the cursor's new HSTMT, whose query timeout and noscan attributes are `timeout` and `noscan`, the
+    // connection's current timeout and the cursor's noscan setting.
+
+    Connection* cnxn = cur->cnxn;
+    intptr_t timeoutNew = cnxn->timeout;
+    bool noscanNew = cur->noscan;
+
+    SQLRETURN ret = SQL_SUCCESS;
+    const char* szFunction = "";
+
+    Py_BEGIN_ALLOW_THREADS
+    if (timeout != timeoutNew)
+    {
+        szFunction = "SQLSetStmtAttr(SQL_ATTR_QUERY_TIMEOUT)";
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)timeoutNew, 0);
+    }
+    if (SQL_SUCCEEDED(ret) && noscan != noscanNew)
+    {
+        szFunction = "SQLSetStmtAttr(SQL_ATTR_NOSCAN)";
+        ret = SQLSetStmtAttr(cur->hstmt, SQL_ATTR_NOSCAN, (SQLPOINTER)(uintptr_t)(noscanNew ? SQL_NOSCAN_ON : SQL_NOSCAN_OFF), 0);
+    }
+    Py_END_ALLOW_THREADS
+
+    if (cnxn->hdbc == SQL_NULL_HANDLE)
+    {
+        // The connection was closed by another thread in the ALLOW_THREADS block above.
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return false;
+    }
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        RaiseErrorFromHandle(szFunction, cnxn->hdbc, cur->hstmt);
+        return false;
+    }
+
+    cur->timeout = timeoutNew;
+    return true;
+}
+
+
+static bool AllocStatement(Cursor* cur)
+{
+    // Allocates a new HSTMT for the cursor, initialized the same way as in Cursor_New.
+
+    Connection* cnxn = cur->cnxn;
+
+    SQLRETURN ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = SQLAllocHandle(SQL_HANDLE_STMT, cnxn->hdbc, &cur->hstmt);
+    Py_END_ALLOW_THREADS
+
+    if (!SQL_SUCCEEDED(ret))
+    {
+        cur->hstmt = SQL_NULL_HANDLE;
+        RaiseErrorFromHandle("SQLAllocHandle", cnxn->hdbc, SQL_NULL_HANDLE);
+        return false;
+    }
+
+    // A new handle has no timeout and noscan is off.
+    return SetAttributes(cur, 0, false);
+}
+
+
+int StatementCache_Swap(Cursor* cur, PyObject* pSql)
+{
+    Connection* cnxn = cur->cnxn;
+
+    I(cnxn->stmtcache_capacity > 0);
+    I(pSql != cur->pPreparedSQL);
+
+    bool fPrepared = (cur->pPreparedSQL != 0);
+    if (fPrepared && !CloseStatement(cur))
+    {
+        RaiseErrorV(0, ProgrammingError, "The cursor's connection was closed.");
+        return STMTCACHE_ERROR;
+    }
+
+    // Nothing below releases the GIL until the cache has been updated, so other threads using the connection always
+    // see a consistent cache.
+
+    CachedStatement hit;
+    int i = FindStatement(cnxn, pSql);
+    if (i != -1)
+        RemoveStatement(cnxn, i, hit);
+
+    CachedStatement spare;
+    spare.hstmt = SQL_NULL_HANDLE;
+    if (fPrepared)
+    {
+        EvictStatement(cnxn, spare);
+        PushStatement(cnxn, cur);
+    }
+    else
+    {
+        // free_results may have already released the SQL, but the parameter types can still be here.
+        FreeParameterInfo(cur);
+    }
+
+    if (i != -1)
+    {
+        // The cursor's old handle is only still here if it had no prepared statement, so nothing will miss it.
+
+        if (cur->hstmt != SQL_NULL_HANDLE)
+            FreeStatement(cur->hstmt);
+
+        cur->hstmt        = hit.hstmt;
+        cur->paramcount   = hit.paramcount;
+        cur->paramtypes   = hit.paramtypes;
+        cur->pPreparedSQL = pSql;
+        Py_INCREF(pSql);
+        Py_DECREF(hit.sql);
+
+        cnxn->stmtcache_hits++;
+
+        if (!SetAttributes(cur, hit.timeout, hit.noscan))
+            return STMTCACHE_ERROR;
+
+        return STMTCACHE_HIT;
+    }
+
+    cnxn->stmtcache_misses++;
+
+    if (cur->hstmt == SQL_NULL_HANDLE)
+    {
+        // The cursor's handle went into the cache, so prepare on the evicted statement's handle or a new one.
+        if (spare.hstmt == SQL_NULL_HANDLE)
+            return AllocStatement(cur) ? STMTCACHE_MISS : STMTCACHE_ERROR;
+
+        cur->hstmt = spare.hstmt;
+        if (!SetAttributes(cur, spare.timeout, spare.noscan))
+            return STMTCACHE_ERROR;
+    }
+
+    return STMTCACHE_MISS;
+}
+
+
+void StatementCache_Release(Cursor* cur)
+{
+    Connection* cnxn = cur->cnxn;
+
+    if (cnxn == 0 || cnxn->hdbc == SQL_NULL_HANDLE || cnxn->stmtcache_capacity == 0 || cur->pPreparedSQL == 0 ||
+        cur->hstmt == SQL_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (!CloseStatement(cur))
+        return;
+
+    CachedStatement evicted;
+    EvictStatement(cnxn, evicted);
+    PushStatement(cnxn, cur);
+
+    if (evicted.hstmt != SQL_NULL_HANDLE)
+        FreeStatement(evicted.hstmt);
+}
+
+
+bool StatementCache_Resize(Connection* cnxn, int capacity)
+{
+    I(capacity >= 0);
+
+    if (capacity == cnxn->stmtcache_capacity)
+        return true;
+
+    CachedStatement* newcache = 0;
+    if (capacity != 0)
+    {
+        newcache = (CachedStatement*)pyodbc_malloc(ALLOC_STMTCACHE, sizeof(CachedStatement) * capacity);
+        if (newcache == 0)
+        {
+            PyErr_NoMemory();
+            return false;
+        }
+    }
+
+    // Replace the cache before freeing the evicted statements, which releases the GIL.
+
+    CachedStatement* oldcache = cnxn->stmtcache;
+    int oldcount = cnxn->stmtcache_count;
+    int count    = min(oldcount, capacity);
+
+    if (count != 0)
+        memcpy(newcache, oldcache, sizeof(CachedStatement) * count);
+
+    cnxn->stmtcache          = newcache;
+    cnxn->stmtcache_count    = count;
+    cnxn->stmtcache_capacity = capacity;
+
+    for (int i = count; i < oldcount; i++)
+    {
+        Py_DECREF(oldcache[i].sql);
+        pyodbc_free(oldcache[i].paramtypes);
+
+        // MS ODBC will crash if we use an HSTMT after the HDBC has been freed.
+        if (cnxn->hdbc != SQL_NULL_HANDLE)
+            FreeStatement(oldcache[i].hstmt);
+    }
+
+    pyodbc_free(oldcache);
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef _STMTCACHE_H_
+#define _STMTCACHE_H_
+
+struct Connection;
+struct Cursor;
+
+// An HSTMT with a prepared statement, kept by the connection after the cursor that prepared it moved on to other SQL
+// or was closed.  The statement is closed and has no parameters or columns bound.
+struct CachedStatement
+{
+    PyObject* sql;              // The SQL the statement was prepared from.
+    HSTMT hstmt;
+    int paramcount;
+    SQLSMALLINT* paramtypes;    // The cursor's parameter type array (see GetParamType), which may be zero.
+    intptr_t timeout;           // The statement's query timeout and noscan attributes.
+    bool noscan;
+};
+
+// The results of StatementCache_Swap.
+enum
+{
+    STMTCACHE_ERROR,            // An exception has been set.
+    STMTCACHE_HIT,              // The cursor's HSTMT is now the cached statement.
+    STMTCACHE_MISS              // The caller must prepare the SQL on the cursor's HSTMT.
+};
+
+/**
+ * Called by Prepare when the connection's statement cache is enabled and `pSql` is not the cursor's prepared
+ * statement.  If the connection has a statement prepared from equal SQL, it becomes the cursor's HSTMT.  Otherwise the
+ * caller must prepare `pSql` on the cursor's HSTMT, which may now be a different handle.  Either way the cursor's
+ * previously prepared statement, if any, is moved into the cache.  A handle the cursor didn't have before is given the
+ * connection's timeout and the cursor's noscan setting.
+ */
+int StatementCache_Swap(Cursor* cur, PyObject* pSql);
+
+/**
+ * Called when a cursor is closed.  If the cursor has a prepared statement and the cache is enabled, its HSTMT is moved
+ * into the cache and the cursor's hstmt is set to SQL_NULL_HANDLE.
+ */
+void StatementCache_Release(Cursor* cur);
+
+/**
+ * Evicts statements until at most `capacity` remain, freeing their HSTMTs, and sets the connection's capacity.
+ * Returns false if memory could not be allocated.
+ */
+bool StatementCache_Resize(Connection* cnxn, int capacity);
+
+#endif // _STMTCACHE_H_
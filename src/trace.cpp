@@ -0,0 +1,284 @@
+// A binary trace of ODBC calls, turned on and off at runtime by pyodbc.enabletrace and disabletrace and read by
+// pyodbc.draintrace.
+//
+// Each thread that makes a traced call appends fixed-size events to its own ring buffer, found through a thread-local
+// storage slot, so recording an event takes no locks and never waits: if the ring is full because nobody has drained
+// it, the event is dropped and counted.  The calls are often made without the GIL (the prefetch threads never hold
+// it), so the rings only use memory barriers: the owning thread is the only writer of `head` and the drainer, which
+// holds the GIL, is the only writer of `tail`.
+//
+// When a thread exits its ring is released for the next new thread.  Rings are never freed, so there is one for each
+// thread that was running a traced call at the same time, and their events are kept until they are drained.
+
+#include "pyodbc.h"
+#include "pyodbcmodule.h"
+#include "cursor.h"
+#include "connection.h"
+#include "stats.h"
+#include "trace.h"
+#include "wrapper.h"
+#include <pythread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+int trace_enabled = 0;
+
+static const char* TRACE_FUNCTION_NAMES[TRACE_FUNCTION_COUNT] =
+{
+    "SQLDriverConnect",
+    "SQLEndTran",
+    "SQLPrepare",
+    "SQLExecute",
+    "SQLExecDirect",
+    "SQLRowCount",
+    "SQLFetch",
+    "SQLFetchScroll",
+    "SQLGetData",
+    "SQLPutData",
+};
+
+struct TraceEvent
+{
+    INT64 start;                // Stats_Now when the call was made
+    INT64 duration;             // nanoseconds
+    INT64 rows;                 // -1 if the function doesn't return rows
+    SQLHANDLE handle;
+    long thread;
+    short function;             // TraceFunction
+    short ret;                  // SQLRETURN
+};
+
+// The number of events in each ring.  Must be a power of two.
+static const unsigned int RING_SIZE = 4096;
+
+struct TraceRing
+{
+    TraceRing* next;            // The next ring in the `rings` list.
+    volatile long owned;        // 1 while a thread is using the ring.
+    long thread;                // The thread using the ring, recorded in each event.
+
+    // The events are at [tail, head), modulo RING_SIZE.  Both only increase and are allowed to wrap.
+    volatile unsigned int head;
+    volatile unsigned int tail;
+
+    volatile unsigned int dropped;  // Events dropped because the ring was full.  Only written by the owning thread.
+    unsigned int dropped_drained;   // The value of dropped when last drained.  Only written by the drainer.
+
+    TraceEvent events[RING_SIZE];
+};
+
+// Every ring that has been created.  Rings are only ever pushed onto the front.
+static TraceRing* volatile rings = 0;
+
+static bool initialized = false;
+
+#ifdef _WIN32
+
+static DWORD slot = FLS_OUT_OF_INDEXES;
+
+inline void Barrier() { MemoryBarrier(); }
+
+inline bool Claim(TraceRing* ring)
+{
+    return InterlockedCompareExchange(&ring->owned, 1, 0) == 0;
+}
+
+inline bool Push(TraceRing* ring)
+{
+    return InterlockedCompareExchangePointer((PVOID volatile*)&rings, ring, ring->next) == ring->next;
+}
+
+inline TraceRing* GetSlot() { return (TraceRing*)FlsGetValue(slot); }
+inline void SetSlot(TraceRing* ring) { FlsSetValue(slot, ring); }
+
+#else
+
+static pthread_key_t slot;
+
+inline void Barrier() { __sync_synchronize(); }
+
+inline bool Claim(TraceRing* ring)
+{
+    return __sync_bool_compare_and_swap(&ring->owned, 0, 1);
+}
+
+inline bool Push(TraceRing* ring)
+{
+    return __sync_bool_compare_and_swap(&rings, ring->next, ring);
+}
+
+inline TraceRing* GetSlot() { return (TraceRing*)pthread_getspecific(slot); }
+inline void SetSlot(TraceRing* ring) { pthread_setspecific(slot, ring); }
+
+#endif
+
+
+#ifdef _WIN32
+static void WINAPI ReleaseRing(void* p)
+#else
+static void ReleaseRing(void* p)
+#endif
+{
+    // Called when a thread that has a ring exits.  The unread events stay in the ring and are read along with the next
+    // owner's.
+
+    TraceRing* ring = (TraceRing*)p;
+    if (ring)
+    {
+        Barrier();
+        ring->owned = 0;
+    }
+}
+
+
+void Trace_Init()
+{
+#ifdef _WIN32
+    slot = FlsAlloc(ReleaseRing);
+    initialized = (slot != FLS_OUT_OF_INDEXES);
+#else
+    initialized = (pthread_key_create(&slot, ReleaseRing) == 0);
+#endif
+}
+
+
+static TraceRing* GetRing()
+{
+    // Returns the current thread's ring, claiming a free ring or creating a new one the first time it is called on a
+    // thread.  Returns zero if there isn't enough memory.
+
+    TraceRing* ring = GetSlot();
+    if (ring)
+        return ring;
+
+    for (ring = rings; ring != 0; ring = ring->next)
+    {
+        if (ring->owned == 0 && Claim(ring))
+            break;
+    }
+
+    if (ring == 0)
+    {
+        // The rings are never freed.
+        ring = (TraceRing*)pyodbc_malloc(ALLOC_TRACE, sizeof(TraceRing));
+        if (ring == 0)
+            return 0;
+        memset(ring, 0, offsetof(TraceRing, events));
+        ring->owned = 1;
+        do
+        {
+            ring->next = rings;
+        }
+        while (!Push(ring));
+    }
+
+    ring->thread = (long)PyThread_get_thread_ident();
+    SetSlot(ring);
+    return ring;
+}
+
+
+void Trace_Record(TraceFunction fn, SQLHANDLE handle, SQLRETURN ret, INT64 start, INT64 rows)
+{
+    INT64 end = Stats_Now();
+
+    TraceRing* ring = GetRing();
+    if (ring == 0)
+        return;
+
+    unsigned int head = ring->head;
+    if (head - ring->tail >= RING_SIZE)
+    {
+        ring->dropped++;
+        return;
+    }
+
+    TraceEvent& event = ring->events[head & (RING_SIZE - 1)];
+    event.start    = start;
+    event.duration = end - start;
+    event.rows     = rows;
+    event.handle   = handle;
+    event.thread   = ring->thread;
+    event.function = (short)fn;
+    event.ret      = (short)ret;
+
+    // Make sure the event is written before the drainer can see it.
+    Barrier();
+    ring->head = head + 1;
+}
+
+
+PyObject* Trace_Enable()
+{
+    if (!initialized)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Unable to allocate thread-local storage for the trace");
+        return 0;
+    }
+
+    trace_enabled = 1;
+    Py_RETURN_NONE;
+}
+
+
+PyObject* Trace_Disable()
+{
+    trace_enabled = 0;
+    Py_RETURN_NONE;
+}
+
+
+static PyObject* EventToTuple(const TraceEvent& event)
+{
+    return Py_BuildValue("(LLlsNiL)", event.start, event.duration, event.thread, TRACE_FUNCTION_NAMES[event.function],
+                         PyLong_FromVoidPtr(event.handle), (int)event.ret, event.rows);
+}
+
+
+PyObject* Trace_Drain()
+{
+    // Since this holds the GIL, it is the only drainer.
+
+    Object events(PyList_New(0));
+    if (!events)
+        return 0;
+
+    long dropped = 0;
+
+    for (TraceRing* ring = rings; ring != 0; ring = ring->next)
+    {
+        unsigned int head = ring->head;
+
+        // Make sure the events up to head are read after head.
+        Barrier();
+
+        for (unsigned int i = ring->tail; i != head; i++)
+        {
+            PyObject* item = EventToTuple(ring->events[i & (RING_SIZE - 1)]);
+            if (!item || PyList_Append(events, item) == -1)
+            {
+                Py_XDECREF(item);
+                return 0;
+            }
+            Py_DECREF(item);
+        }
+
+        // Make sure the events are copied before the owner can overwrite them.
+        Barrier();
+        ring->tail = head;
+
+        unsigned int count = ring->dropped;
+        dropped += (long)(count - ring->dropped_drained);
+        ring->dropped_drained = count;
+    }
+
+    // The tuples start with the start time, so this merges the threads' events in the order the calls were made.
+    if (PyList_Sort(events) == -1)
+        return 0;
+
+    return Py_BuildValue("(Ol)", events.Get(), dropped);
+}
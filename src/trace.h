@@ -0,0 +1,51 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+// A trace of ODBC calls that can be turned on at runtime with pyodbc.enabletrace.  See trace.cpp.
+//
+// Unlike TRACE (DebugTrace), which is compiled out unless PYODBC_TRACE is defined, this is always compiled in.  While
+// tracing is off, each traced call costs a test of trace_enabled.
+
+// The ODBC functions that are traced.  Keep TRACE_FUNCTION_NAMES in trace.cpp in the same order.
+enum TraceFunction
+{
+    TRACE_SQLDRIVERCONNECT,
+    TRACE_SQLENDTRAN,
+    TRACE_SQLPREPARE,
+    TRACE_SQLEXECUTE,
+    TRACE_SQLEXECDIRECT,
+    TRACE_SQLROWCOUNT,
+    TRACE_SQLFETCH,
+    TRACE_SQLFETCHSCROLL,
+    TRACE_SQLGETDATA,
+    TRACE_SQLPUTDATA,
+    TRACE_FUNCTION_COUNT
+};
+
+extern int trace_enabled;
+
+/**
+ * Creates the thread-local storage slot used to find each thread's ring buffer.  Called once when the module is
+ * initialized.
+ */
+void Trace_Init();
+
+/**
+ * Appends an event for a call that started at `start` (from Stats_Now) and just returned `ret`.  `rows` is the number
+ * of rows fetched or counted, or -1 if the function doesn't return rows.  May be called without the GIL.
+ */
+void Trace_Record(TraceFunction fn, SQLHANDLE handle, SQLRETURN ret, INT64 start, INT64 rows);
+
+inline void Trace_Call(TraceFunction fn, SQLHANDLE handle, SQLRETURN ret, INT64 start, INT64 rows = -1)
+{
+    // A zero start means tracing was turned on during the call.
+    if (trace_enabled && start != 0)
+        Trace_Record(fn, handle, ret, start, rows);
+}
+
+// The implementations of pyodbc.enabletrace, disabletrace, and draintrace.
+PyObject* Trace_Enable();
+PyObject* Trace_Disable();
+PyObject* Trace_Drain();
+
+#endif // _TRACE_H_
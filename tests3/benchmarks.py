@@ -0,0 +1,309 @@
+#!/usr/bin/python
+# -*- coding: latin-1 -*-
+
+usage = """\
+usage: %prog [options] [connection_string]
+
+Performance benchmarks using the SQLite ODBC driver from http://www.ch-werner.de/sqliteodbc
+
+Each benchmark is run several times and the fastest run is reported, along with the
+median, so that noise from other processes doesn't hide real changes.  The results can
+be written to a JSON file with --output and a later run can be compared against them
+with --baseline, which makes it easy to check a change for regressions:
+
+  python benchmarks.py -o before.json
+  (make changes and rebuild)
+  python benchmarks.py -b before.json
+
+The benchmarks create and drop tables whose names start with bench_, so point them at a
+scratch database.  If no connection string is passed, the [benchmarks] section of the
+setup.cfg file in the tmp directory is used, then the [sqlitetests] section, then
+sqlite.db in the tests2 directory:
+
+  [benchmarks]
+  connection-string=Driver=SQLite3 ODBC Driver;Database=/tmp/bench.db
+
+These run using the version from the 'build' directory, not the version installed into
+the Python directories.  You must run python setup.py build before running them.
+"""
+
+import sys, os, platform, json
+from decimal import Decimal
+from datetime import datetime, date, timedelta
+from os.path import join, dirname, abspath
+from timeit import default_timer
+from testutils import *
+
+# The number of rows in the narrow and wide tables at --scale 1.
+NARROW_ROWS = 10000
+WIDE_ROWS   = 2000
+LOB_ROWS    = 20
+LOB_SIZE    = 256 * 1024
+
+WIDE_COLUMNS = 20
+
+
+class Benchmarks:
+    """
+    The benchmarks, each a method named bench_xxx that runs the operation being measured once and returns the number
+    of operations (usually rows) it performed so results can be reported per operation.
+
+    The tables are filled once by setup() and shared by all benchmarks.  Nothing outside the bench_ methods is timed.
+    """
+
+    def __init__(self, connection_string, scale):
+        self.connection_string = connection_string
+        self.narrow_rows = int(NARROW_ROWS * scale)
+        self.wide_rows   = int(WIDE_ROWS * scale)
+        self.lob_rows    = max(1, int(LOB_ROWS * scale))
+
+        self.cnxn   = pyodbc.connect(connection_string)
+        self.cursor = self.cnxn.cursor()
+
+    def setup(self):
+        self.teardown()
+
+        cursor = self.cursor
+        start = datetime(2012, 1, 1)
+
+        cursor.execute("create table bench_narrow(id int, name varchar(20))")
+        cursor.executemany("insert into bench_narrow(id, name) values (?, ?)",
+                           [ (i, 'name %d' % i) for i in range(self.narrow_rows) ])
+
+        columns = ', '.join([ 'c%d varchar(20)' % i for i in range(WIDE_COLUMNS) ])
+        markers = ', '.join([ '?' ] * WIDE_COLUMNS)
+        cursor.execute("create table bench_wide(%s)" % columns)
+        cursor.executemany("insert into bench_wide values (%s)" % markers,
+                           [ [ 'r%dc%d' % (i, c) for c in range(WIDE_COLUMNS) ] for i in range(self.wide_rows) ])
+
+        cursor.execute("create table bench_types(d decimal(18,4), ts timestamp)")
+        cursor.executemany("insert into bench_types(d, ts) values (?, ?)",
+                           [ (Decimal('%d.%04d' % (i, i % 10000)), start + timedelta(seconds=i))
+                             for i in range(self.narrow_rows) ])
+
+        cursor.execute("create table bench_lob(t text, b blob)")
+        text  = ('0123456789-abcdefghijklmnopqrstuvwxyz-' * (LOB_SIZE // 38 + 1))[:LOB_SIZE]
+        value = bytes(text, 'ascii')
+        cursor.executemany("insert into bench_lob(t, b) values (?, ?)", [ (text, value) ] * self.lob_rows)
+
+        cursor.execute("create table bench_many(id int, name varchar(20))")
+        self.many_params = [ (i, 'name %d' % i) for i in range(1000) ]
+
+        self.cnxn.commit()
+
+    def teardown(self):
+        for name in ('narrow', 'wide', 'types', 'lob', 'many'):
+            try:
+                self.cursor.execute("drop table bench_%s" % name)
+            except:
+                pass
+        self.cnxn.commit()
+
+    def close(self):
+        self.teardown()
+        self.cursor.close()
+        self.cnxn.close()
+
+    def bench_connect(self):
+        for i in range(20):
+            pyodbc.connect(self.connection_string).close()
+        return 20
+
+    def bench_execute(self):
+        for i in range(1000):
+            self.cursor.execute("select 1")
+        return 1000
+
+    def bench_execute_params(self):
+        for i in range(1000):
+            self.cursor.execute("select id, name from bench_narrow where id = ?", i)
+        return 1000
+
+    def bench_executemany(self):
+        self.cursor.executemany("insert into bench_many(id, name) values (?, ?)", self.many_params)
+        self.cursor.execute("delete from bench_many")
+        self.cnxn.commit()
+        return len(self.many_params)
+
+    def bench_fetchone_narrow(self):
+        self.cursor.execute("select id, name from bench_narrow")
+        count = 0
+        while self.cursor.fetchone():
+            count += 1
+        return count
+
+    def bench_fetchmany_narrow(self):
+        self.cursor.execute("select id, name from bench_narrow")
+        count = 0
+        while True:
+            rows = self.cursor.fetchmany(100)
+            if not rows:
+                break
+            count += len(rows)
+        return count
+
+    def bench_fetchall_narrow(self):
+        return len(self.cursor.execute("select id, name from bench_narrow").fetchall())
+
+    def bench_fetchone_wide(self):
+        self.cursor.execute("select * from bench_wide")
+        count = 0
+        while self.cursor.fetchone():
+            count += 1
+        return count
+
+    def bench_fetchmany_wide(self):
+        self.cursor.execute("select * from bench_wide")
+        count = 0
+        while True:
+            rows = self.cursor.fetchmany(100)
+            if not rows:
+                break
+            count += len(rows)
+        return count
+
+    def bench_fetchall_wide(self):
+        return len(self.cursor.execute("select * from bench_wide").fetchall())
+
+    def bench_lob_text(self):
+        return len(self.cursor.execute("select t from bench_lob").fetchall())
+
+    def bench_lob_binary(self):
+        return len(self.cursor.execute("select b from bench_lob").fetchall())
+
+    def bench_decimal(self):
+        return len(self.cursor.execute("select d from bench_types").fetchall())
+
+    def bench_datetime(self):
+        return len(self.cursor.execute("select ts from bench_types").fetchall())
+
+
+def get_names(names):
+    all_names = [ name[6:] for name in dir(Benchmarks) if name.startswith('bench_') ]
+    if not names:
+        return all_names
+    for name in names:
+        if name not in all_names:
+            raise SystemExit('There is no benchmark named %r.  Choose from: %s' % (name, ', '.join(all_names)))
+    return names
+
+
+def run(benchmarks, name, repeat):
+    """
+    Runs a benchmark `repeat` times (after an untimed warm-up run) and returns a dictionary describing the result.
+    """
+    method = getattr(benchmarks, 'bench_' + name)
+
+    ops = method()
+
+    times = []
+    for i in range(repeat):
+        t = default_timer()
+        method()
+        times.append(default_timer() - t)
+    times.sort()
+
+    best = times[0]
+    return { 'name'    : name,
+             'ops'     : ops,
+             'repeat'  : repeat,
+             'best'    : best,
+             'median'  : times[len(times) // 2],
+             'usec_op' : best * 1000000.0 / max(ops, 1) }
+
+
+def get_info(cnxn, options):
+    return { 'python'   : sys.version.split()[0],
+             'pyodbc'   : pyodbc.version,
+             'driver'   : '%s %s' % (cnxn.getinfo(pyodbc.SQL_DRIVER_NAME), cnxn.getinfo(pyodbc.SQL_DRIVER_VER)),
+             'dbms'     : '%s %s' % (cnxn.getinfo(pyodbc.SQL_DBMS_NAME), cnxn.getinfo(pyodbc.SQL_DBMS_VER)),
+             'os'       : platform.platform(),
+             'machine'  : platform.machine(),
+             'scale'    : options.scale,
+             'time'     : datetime.now().strftime('%Y-%m-%d %H:%M:%S') }
+
+
+def print_results(results, baseline):
+    previous = {}
+    if baseline:
+        for result in baseline['results']:
+            previous[result['name']] = result
+
+    print('%-20s %8s %12s %12s %12s %s' % ('benchmark', 'ops', 'best (s)', 'median (s)', 'usec/op', baseline and 'change' or ''))
+
+    for result in results:
+        change = ''
+        old = previous.get(result['name'])
+        if old and old['usec_op']:
+            change = '%+.1f%%' % ((result['usec_op'] - old['usec_op']) * 100.0 / old['usec_op'])
+        print('%-20s %8d %12.4f %12.4f %12.2f %s' % (result['name'], result['ops'], result['best'], result['median'],
+                                                     result['usec_op'], change))
+
+
+def main():
+    from optparse import OptionParser
+    parser = OptionParser(usage=usage)
+    parser.add_option("-t", "--test", action="append", help="Run only the named benchmark (can be used multiple times)")
+    parser.add_option("-r", "--repeat", type="int", default=5, help="Number of timed runs of each benchmark (default 5)")
+    parser.add_option("-s", "--scale", type="float", default=1.0, help="Multiplies the number of rows in each table")
+    parser.add_option("-o", "--output", help="Write the results to this file as JSON")
+    parser.add_option("-b", "--baseline", help="Compare with results previously written with --output")
+    parser.add_option("-l", "--list", action="store_true", default=False, help="List the benchmarks and exit")
+
+    (options, args) = parser.parse_args()
+
+    if options.list:
+        print('\n'.join(get_names(None)))
+        return
+
+    if len(args) > 1:
+        parser.error('Only one argument is allowed.  Do you need quotes around the connection string?')
+
+    if args:
+        connection_string = args[0]
+    else:
+        connection_string = (load_setup_connection_string('benchmarks') or
+                             load_setup_connection_string('sqlitetests') or
+                             'Driver=SQLite3 ODBC Driver;Database=%s' % join(dirname(dirname(abspath(__file__))), 'tests2', 'sqlite.db'))
+
+    names = get_names(options.test)
+
+    baseline = None
+    if options.baseline:
+        f = open(options.baseline)
+        try:
+            baseline = json.load(f)
+        finally:
+            f.close()
+
+    benchmarks = Benchmarks(connection_string, options.scale)
+    info = get_info(benchmarks.cnxn, options)
+
+    print('connection_string: %s' % connection_string)
+    print_library_info(benchmarks.cnxn)
+    print('')
+
+    try:
+        benchmarks.setup()
+        results = [ run(benchmarks, name, options.repeat) for name in names ]
+    finally:
+        benchmarks.close()
+
+    print_results(results, baseline)
+
+    if options.output:
+        f = open(options.output, 'w')
+        try:
+            json.dump({ 'info' : info, 'results' : results }, f, indent=2, sort_keys=True)
+        finally:
+            f.close()
+
+
+if __name__ == '__main__':
+
+    # Add the build directory to the path so we're testing the latest build, not the installed version.
+
+    add_to_path()
+
+    import pyodbc
+    main()
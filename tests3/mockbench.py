@@ -0,0 +1,277 @@
+#!/usr/bin/python
+# -*- coding: latin-1 -*-
+
+usage = """\
+usage: %prog [options] [connection_string]
+
+Microbenchmarks using the mock ODBC driver in utils/mockodbc, which serves results
+from memory so the timings are pyodbc's own overhead.  Build the driver first with:
+
+  python setup.py build mockodbc
+
+Each benchmark is timed with two sizes so the cost can be split into a fixed part and a
+part per item:
+
+  fetch_xxx        usec per row (Cursor_fetch and Row_New) and per cell (reading and
+                   converting one value of type xxx)
+  fetchone_xxx     the same, using fetchone instead of fetchall
+  lob_xxx          usec per cell and per KB of a long value read with SQLGetData
+  execute_xxx      usec per execute and per parameter (PrepareAndBind)
+  executemany_xxx  usec per row and per cell of an executemany parameter array
+
+The results can be written to a JSON file with --output and a later run can be compared
+against them with --baseline.
+
+If no connection string is passed, the [mockbench] section of the setup.cfg file in the
+tmp directory is used, then the driver built into the build directory.
+
+These run using the version from the 'build' directory, not the version installed into
+the Python directories.  You must run python setup.py build before running them.
+"""
+
+import sys, os, platform, json
+from decimal import Decimal
+from datetime import datetime
+from os.path import join, dirname, abspath, exists
+from timeit import default_timer
+from testutils import *
+
+# The number of columns or parameters in the larger of the two sizes each benchmark is timed with.
+WIDE = 10
+
+# (name, mock column type) for the fetch benchmarks.
+FETCH_TYPES = [
+    ('int',       'int'),
+    ('bigint',    'bigint'),
+    ('bit',       'bit'),
+    ('double',    'double'),
+    ('decimal',   'decimal(18,4)'),
+    ('varchar',   'varchar(20)'),
+    ('wvarchar',  'wvarchar(20)'),
+    ('varbinary', 'varbinary(16)'),
+    ('date',      'date'),
+    ('timestamp', 'timestamp'),
+    ('getdata',   'longvarchar(100)'),
+    ('wgetdata',  'wlongvarchar(100)'),
+]
+
+# (name, mock column type with a %d for the length) for the LOB benchmarks.
+LOB_TYPES = [
+    ('binary', 'longvarbinary(%d)'),
+    ('text',   'longvarchar(%d)'),
+    ('wtext',  'wlongvarchar(%d)'),
+]
+
+# (name, parameter value) for the execute and executemany benchmarks.
+PARAM_TYPES = [
+    ('none',     None),
+    ('int',      12345),
+    ('float',    1.5),
+    ('str',      'abcdefghij'),
+    ('bytes',    bytes(b'abcdefghij')),
+    ('decimal',  Decimal('12345.6789')),
+    ('datetime', datetime(2012, 1, 2, 3, 4, 5, 678000)),
+]
+
+
+class Result:
+    """
+    The result of a benchmark timed at two sizes.  The time per item is the slope between them, and the fixed time
+    is what is left over at the smaller size.
+    """
+    def __init__(self, name, fixed_unit, item_unit, ops, small, large, t_small, t_large):
+        self.name       = name
+        self.fixed_unit = fixed_unit
+        self.item_unit  = item_unit
+        self.item_usec  = (t_large - t_small) * 1000000.0 / (ops * (large - small))
+        self.fixed_usec = t_small * 1000000.0 / ops - self.item_usec * small
+
+    def to_dict(self):
+        return self.__dict__
+
+
+class MockBenchmarks:
+
+    def __init__(self, connection_string, rows, repeat, arraysize):
+        self.rows   = rows
+        self.repeat = repeat
+
+        self.cnxn   = pyodbc.connect(connection_string)
+        self.cursor = self.cnxn.cursor()
+        if arraysize:
+            self.cursor.arraysize = arraysize
+
+    def close(self):
+        self.cursor.close()
+        self.cnxn.close()
+
+    def time(self, func, *args):
+        """
+        Returns the fastest of `repeat` runs of func(*args), after an untimed warm-up run.
+        """
+        func(*args)
+        best = None
+        for i in range(self.repeat):
+            t = default_timer()
+            func(*args)
+            t = default_timer() - t
+            if best is None or t < best:
+                best = t
+        return best
+
+    def fit(self, name, fixed_unit, item_unit, ops, small, large, func):
+        """
+        Times func(small) and func(large), each of which must perform `ops` operations of `small` or `large` items.
+        """
+        return Result(name, fixed_unit, item_unit, ops, small, large, self.time(func, small), self.time(func, large))
+
+    def _fetchall(self, sql):
+        self.cursor.execute(sql).fetchall()
+
+    def _fetchone(self, sql):
+        cursor = self.cursor.execute(sql)
+        while cursor.fetchone():
+            pass
+
+    def fetch(self, name, coltype, method):
+        def func(count):
+            method("mock rows=%d cols=%s" % (self.rows, ','.join([ coltype ] * count)))
+        return self.fit(name, 'row', 'cell', self.rows, 1, WIDE, func)
+
+    def lob(self, name, coltype):
+        # Fits the time per KB between 1KB and 1MB values.
+        rows = max(1, self.rows // 1000)
+        def func(kb):
+            self._fetchall("mock rows=%d cols=%s" % (rows, coltype % (kb * 1024)))
+        return self.fit(name, 'cell', 'KB', rows, 1, 1024, func)
+
+    def execute(self, name, value):
+        def func(count):
+            sql = "bind " + ','.join([ '?' ] * count)
+            params = [ value ] * count
+            execute = self.cursor.execute
+            for i in range(self.rows // 10):
+                execute(sql, params)
+        return self.fit(name, 'execute', 'param', self.rows // 10, 1, WIDE, func)
+
+    def executemany(self, name, value):
+        def func(count):
+            sql = "bind " + ','.join([ '?' ] * count)
+            self.cursor.executemany(sql, [ [ value ] * count ] * self.rows)
+        return self.fit(name, 'row', 'cell', self.rows, 1, WIDE, func)
+
+    def get_benchmarks(self):
+        """
+        Returns a list of (name, function) pairs where each function runs a benchmark and returns its Result.
+        """
+        benchmarks = []
+        def add(name, method, *args):
+            benchmarks.append((name, lambda: method(name, *args)))
+
+        for name, coltype in FETCH_TYPES:
+            add('fetch_' + name, self.fetch, coltype, self._fetchall)
+        add('fetchone_int', self.fetch, 'int', self._fetchone)
+        add('fetchone_varchar', self.fetch, 'varchar(20)', self._fetchone)
+        for name, coltype in LOB_TYPES:
+            add('lob_' + name, self.lob, coltype)
+        for name, value in PARAM_TYPES:
+            add('execute_' + name, self.execute, value)
+        for name, value in PARAM_TYPES:
+            add('executemany_' + name, self.executemany, value)
+        return benchmarks
+
+
+def print_results(results, baseline):
+    previous = {}
+    if baseline:
+        for result in baseline['results']:
+            previous[result['name']] = result
+
+    def change(new, old):
+        if not old:
+            return ''
+        return '%+.1f%%' % ((new - old) * 100.0 / old)
+
+    print('%-22s %32s %32s' % ('benchmark', 'fixed', 'per item'))
+
+    for result in results:
+        fixed = '%.3f usec/%s' % (result.fixed_usec, result.fixed_unit)
+        item  = '%.3f usec/%s' % (result.item_usec, result.item_unit)
+        old   = previous.get(result.name)
+        if old:
+            fixed = '%s %7s' % (fixed, change(result.fixed_usec, old['fixed_usec']))
+            item  = '%s %7s' % (item, change(result.item_usec, old['item_usec']))
+        print('%-22s %32s %32s' % (result.name, fixed, item))
+
+
+def main():
+    from optparse import OptionParser
+    parser = OptionParser(usage=usage)
+    parser.add_option("-t", "--test", action="append", help="Run only benchmarks starting with this (can be used multiple times)")
+    parser.add_option("-r", "--repeat", type="int", default=5, help="Number of timed runs of each size (default 5)")
+    parser.add_option("-n", "--rows", type="int", default=10000, help="Number of rows fetched or parameter sets (default 10000)")
+    parser.add_option("-a", "--arraysize", type="int", default=0, help="Sets Cursor.arraysize")
+    parser.add_option("-o", "--output", help="Write the results to this file as JSON")
+    parser.add_option("-b", "--baseline", help="Compare with results previously written with --output")
+
+    (options, args) = parser.parse_args()
+
+    if len(args) > 1:
+        parser.error('Only one argument is allowed.  Do you need quotes around the connection string?')
+
+    if args:
+        connection_string = args[0]
+    else:
+        connection_string = load_setup_connection_string('mockbench')
+        if not connection_string:
+            driver = join(dirname(dirname(abspath(__file__))), 'build', 'mockodbc', 'libmockodbc.so')
+            if not exists(driver):
+                parser.error('%s does not exist.  Build it with "python setup.py mockodbc"' % driver)
+            connection_string = 'DRIVER=%s' % driver
+
+    baseline = None
+    if options.baseline:
+        f = open(options.baseline)
+        try:
+            baseline = json.load(f)
+        finally:
+            f.close()
+
+    benchmarks = MockBenchmarks(connection_string, options.rows, options.repeat, options.arraysize)
+    try:
+        print('connection_string: %s' % connection_string)
+        print_library_info(benchmarks.cnxn)
+        print('')
+
+        selected = [ (name, func) for (name, func) in benchmarks.get_benchmarks()
+                     if not options.test or [ prefix for prefix in options.test if name.startswith(prefix) ] ]
+        results = [ func() for (name, func) in selected ]
+    finally:
+        benchmarks.close()
+
+    print_results(results, baseline)
+
+    if options.output:
+        info = { 'python'    : sys.version.split()[0],
+                 'pyodbc'    : pyodbc.version,
+                 'os'        : platform.platform(),
+                 'machine'   : platform.machine(),
+                 'rows'      : options.rows,
+                 'arraysize' : options.arraysize,
+                 'time'      : datetime.now().strftime('%Y-%m-%d %H:%M:%S') }
+        f = open(options.output, 'w')
+        try:
+            json.dump({ 'info' : info, 'results' : [ result.to_dict() for result in results ] }, f, indent=2,
+                      sort_keys=True)
+        finally:
+            f.close()
+
+
+if __name__ == '__main__':
+
+    # Add the build directory to the path so we're testing the latest build, not the installed version.
+
+    add_to_path()
+
+    import pyodbc
+    main()
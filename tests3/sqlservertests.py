@@ -422,6 +422,27 @@ class SqlServerTestCase(unittest.TestCase):
         result = self.cursor.execute("select * from t1").fetchone()[0]
         self.assertEqual(result, value)
 
+    def test_decimal_negative_e(self):
+        """Ensure decimals printed with a negative exponent are properly handled"""
+        value = Decimal('-1.5E-7')
+        self.cursor.execute("create table t1(d decimal(20, 10))")
+        self.cursor.execute("insert into t1 values (?)", value)
+        result = self.cursor.execute("select * from t1").fetchone()[0]
+        self.assertEqual(result, value)
+
+    def test_decimal_nan(self):
+        """Ensure NaN and infinite decimals raise ValueError"""
+        self.cursor.execute("create table t1(d decimal(10, 2))")
+        self.assertRaises(ValueError, self.cursor.execute, "insert into t1 values (?)", Decimal('NaN'))
+        self.assertRaises(ValueError, self.cursor.execute, "insert into t1 values (?)", Decimal('-Infinity'))
+
+    def test_prepared_result_types(self):
+        """Ensure results cached for a prepared statement are not reused when the parameter types change"""
+        sql = "select ?"
+        self.assertEqual(self.cursor.execute(sql, 1).fetchone()[0], 1)
+        self.assertEqual(self.cursor.execute(sql, 'abc').fetchone()[0], 'abc')
+        self.assertEqual(self.cursor.execute(sql, 2).fetchone()[0], 2)
+
     def test_subquery_params(self):
         """Ensure parameter markers work in a subquery"""
         self.cursor.execute("create table t1(id integer, s varchar(20))")
@@ -590,6 +611,16 @@ class SqlServerTestCase(unittest.TestCase):
         result = self.cursor.execute("select d from t1").fetchone()[0]
         self.assertEqual(result, input)
 
+    def test_tinyint(self):
+        # SQL Server reports tinyint columns as unsigned, so they are read with the unsigned readers, both with
+        # SQLGetData and when block fetching.
+        self.cursor.execute("create table t1(n tinyint)")
+        self.cursor.execute("insert into t1 values (?)", 255)
+        self.cursor.execute("insert into t1 values (?)", 0)
+        self.assertEqual([ row[0] for row in self.cursor.execute("select n from t1 order by n").fetchall() ], [0, 255])
+        self.cursor.arraysize = 10
+        self.assertEqual([ row[0] for row in self.cursor.execute("select n from t1 order by n").fetchall() ], [0, 255])
+
     def test_float(self):
         value = 1234.567
         self.cursor.execute("create table t1(n float)")
@@ -914,6 +945,40 @@ class SqlServerTestCase(unittest.TestCase):
         self.failUnlessRaises(pyodbc.Error, self.cursor.executemany, "insert into t1(a, b) value (?, ?)", params)
 
         
+    def test_fast_executemany(self):
+        self.cursor.fast_executemany = True
+        self.cursor.execute("create table t1(a int, b varchar(10), c decimal(10,3), d datetime)")
+
+        params = [ (i, (i % 3) and str(i) or None, Decimal(i) / (10 ** (i % 4)), datetime(2011, 1, 1, 0, 0, i % 60))
+                   for i in range(1, 2501) ]
+
+        self.cursor.executemany("insert into t1(a, b, c, d) values (?,?,?,?)", params)
+
+        self.cursor.execute("select a, b, c, d from t1 order by a")
+        rows = [ tuple(row) for row in self.cursor.fetchall() ]
+        self.assertEqual(rows, params)
+
+    def test_fast_executemany_mixed(self):
+        "Ensure rows with different parameter types fall back to executing each row."
+        self.cursor.fast_executemany = True
+        self.cursor.execute("create table t1(a int, b varchar(10))")
+
+        params = [ (1, 'one'), (2, 2), (3, None) ]
+
+        self.cursor.executemany("insert into t1(a, b) values (?,?)", params)
+
+        self.cursor.execute("select a, b from t1 order by a")
+        rows = [ tuple(row) for row in self.cursor.fetchall() ]
+        self.assertEqual(rows, [ (1, 'one'), (2, '2'), (3, None) ])
+
+    def test_fast_executemany_failure(self):
+        self.cursor.fast_executemany = True
+        self.cursor.execute("create table t1(a int primary key)")
+
+        params = [ (1,), (2,), (1,) ]
+
+        self.failUnlessRaises(pyodbc.IntegrityError, self.cursor.executemany, "insert into t1(a) values (?)", params)
+
     def test_row_slicing(self):
         self.cursor.execute("create table t1(a int, b int, c int, d int)");
         self.cursor.execute("insert into t1 values(1,2,3,4)")
@@ -1034,6 +1099,306 @@ class SqlServerTestCase(unittest.TestCase):
         self.cursor.skip(2)
         self.assertEqual(self.cursor.fetchone()[0], 4)
 
+    def test_block_fetch(self):
+        "Ensure fetching in blocks (arraysize > 1) returns the same rows as fetching one at a time"
+        self.cursor.execute("create table t1(n int, s varchar(20), u nvarchar(20), d decimal(10,2), f float, dt datetime, b varbinary(10))")
+        for i in range(25):
+            self.cursor.execute("insert into t1 values (?, ?, ?, ?, ?, ?, ?)",
+                                i, str(i), u'u%s' % i, Decimal('%s.25' % i), i + 0.5, datetime(2011, 1, 1, 0, 0, i), bytearray([i]))
+        self.cursor.execute("insert into t1 values (null, null, null, null, null, null, null)")
+
+        self.cursor.execute("select * from t1 order by n")
+        expected = [ tuple(row) for row in self.cursor.fetchall() ]
+
+        self.cursor.arraysize = 10
+        self.cursor.execute("select * from t1 order by n")
+        self.assertEqual([ tuple(row) for row in self.cursor.fetchall() ], expected)
+
+        self.cursor.execute("select * from t1 order by n")
+        self.assertEqual(tuple(self.cursor.fetchone()), expected[0])
+        self.cursor.skip(12)
+        self.assertEqual(tuple(self.cursor.fetchone()), expected[13])
+        self.assertEqual([ tuple(row) for row in self.cursor.fetchmany(3) ], expected[14:17])
+
+        # The results of a prepared statement are only described the first time it is executed, so a longer value
+        # doesn't fit in the buffer sized for the first one and is read again with SQLGetData.
+        sql = "select ?"
+        self.assertEqual(self.cursor.execute(sql, 'abc').fetchall()[0][0], 'abc')
+        value = 'x' * 50
+        self.assertEqual(self.cursor.execute(sql, value).fetchall()[0][0], value)
+
+        # Skipping into a later rowset reads its long values too.
+        sql = "select n, ? + s from t1 where n is not null order by n"
+        self.cursor.execute(sql, 'a').fetchall()
+        self.cursor.execute(sql, value)
+        self.assertEqual(tuple(self.cursor.fetchone()), (0, value + '0'))
+        self.cursor.skip(12)
+        self.assertEqual(tuple(self.cursor.fetchone()), (13, value + '13'))
+        self.assertEqual([ tuple(row) for row in self.cursor.fetchall() ], [ (i, value + str(i)) for i in range(14, 25) ])
+
+    def test_block_fetch_lob(self):
+        "Ensure LOB columns are still read when fetching in blocks"
+        self.cursor.execute("create table t1(n int, s varchar(max), m int)")
+        value = 'x' * 10000
+        for i in range(5):
+            self.cursor.execute("insert into t1 values (?, ?, ?)", i, value, i * 2)
+        self.cursor.arraysize = 3
+        rows = self.cursor.execute("select n, s, m from t1 order by n").fetchall()
+        self.assertEqual([ (row.n, row.s, row.m) for row in rows ], [ (i, value, i * 2) for i in range(5) ])
+
+    def test_prefetch(self):
+        "Ensure prefetching blocks in the background returns the same rows"
+        self.cursor.execute("create table t1(n int, s varchar(20))")
+        for i in range(100):
+            self.cursor.execute("insert into t1 values (?, ?)", i, str(i))
+        expected = [ (i, str(i)) for i in range(100) ]
+
+        self.assertEqual(self.cursor.prefetch, 0) # defaults to zero (off)
+        self.cursor.arraysize = 7
+        self.cursor.prefetch = 3
+        self.cursor.execute("select n, s from t1 order by n")
+        self.assertEqual([ tuple(row) for row in self.cursor.fetchall() ], expected)
+
+        # Abandoning the results stops the prefetch thread.
+        self.cursor.execute("select n, s from t1 order by n")
+        self.assertEqual(tuple(self.cursor.fetchone()), expected[0])
+        self.cursor.skip(10)
+        self.assertEqual(tuple(self.cursor.fetchone()), expected[11])
+        self.assertEqual(self.cursor.execute("select count(*) from t1").fetchone()[0], 100)
+
+        self.assertRaises(ValueError, setattr, self.cursor, 'prefetch', -1)
+        self.assertRaises(ValueError, setattr, self.cursor, 'prefetch', 65)
+        self.assertRaises(TypeError, delattr, self.cursor, 'prefetch')
+        self.assertEqual(self.cursor.prefetch, 3)
+
+    def test_stats(self):
+        "Ensure a Stats object counts calls and rows once assigned"
+        self.cursor.execute("create table t1(n int, s varchar(20))")
+        self.cursor.execute("insert into t1 values (1, 'one')")
+        self.cursor.execute("insert into t1 values (2, 'two')")
+
+        self.assertEqual(self.cnxn.stats, None) # defaults to None (off)
+        stats = pyodbc.Stats()
+        self.cnxn.stats = stats
+        self.assertEqual(self.cursor.execute("select n, s from t1").fetchall(), [ (1, 'one'), (2, 'two') ])
+        self.assertEqual(stats.execute_calls, 1)
+        self.assertTrue(stats.fetch_calls >= 1)
+        self.assertEqual(stats.rows, 2)
+
+        # Assigning the same object to the cursor does not count twice.
+        self.cursor.stats = stats
+        self.cursor.execute("select n from t1 where n=?", 1).fetchall()
+        self.assertEqual(stats.prepare_calls, 1)
+        self.assertEqual(stats.rows, 3)
+
+        stats.reset()
+        self.assertEqual(stats.execute_calls, 0)
+        self.assertEqual(stats.rows, 0)
+
+        self.cnxn.stats = self.cursor.stats = None
+        self.cursor.execute("select n from t1").fetchall()
+        self.assertEqual(stats.execute_calls, 0)
+        self.assertRaises(TypeError, setattr, self.cnxn, 'stats', 1)
+
+    def test_trace(self):
+        "Ensure enabletrace records an event for each call and draintrace removes them"
+        self.cursor.execute("create table t1(n int)")
+        self.cursor.execute("insert into t1 values (1)")
+
+        pyodbc.draintrace()
+        pyodbc.enabletrace()
+        try:
+            self.assertEqual(self.cursor.execute("select n from t1").fetchall(), [ (1,) ])
+        finally:
+            pyodbc.disabletrace()
+
+        events, dropped = pyodbc.draintrace()
+        self.assertEqual(dropped, 0)
+        functions = [ event[3] for event in events ]
+        self.assertTrue('SQLExecDirect' in functions)
+        self.assertTrue('SQLFetch' in functions)
+        self.assertEqual(sum([ event[6] for event in events if event[3] == 'SQLFetch' ]), 1)
+        self.assertEqual(pyodbc.draintrace(), ([], 0))
+
+    def test_allocations(self):
+        "Ensure the memory used by rows is counted and released"
+        self.cursor.execute("create table t1(n int, s varchar(20))")
+        for i in range(10):
+            self.cursor.execute("insert into t1 values (?, ?)", i, str(i))
+
+        before = pyodbc.allocations()
+        self.assertTrue('params' in before)
+        rows = self.cursor.execute("select n, s from t1").fetchall()
+        self.assertEqual(pyodbc.allocations()['rows'][1], before['rows'][1] + 10)
+        del rows
+        self.assertEqual(pyodbc.allocations()['rows'], before['rows'])
+
+    def test_arena(self):
+        "Ensure executing the same statement repeatedly reuses the cursor's memory"
+        self.cursor.execute("create table t1(n int, d decimal(10,3), s nvarchar(20))")
+        for i in range(5):
+            self.cursor.execute("insert into t1 values (?, ?, ?)", i, Decimal('1.25'), 'abc')
+            self.cursor.execute("select n, d, s from t1 where n = ?", i).fetchall()
+        before = pyodbc.allocations()['arena']
+        for i in range(50):
+            self.cursor.execute("insert into t1 values (?, ?, ?)", i, Decimal('1.25'), 'abc')
+            self.cursor.execute("select n, d, s from t1 where n = ?", i).fetchall()
+        self.assertEqual(pyodbc.allocations()['arena'], before)
+
+    def test_row_reuse(self):
+        "Ensure rows released to the free list are reset when they are reused"
+        self.cursor.execute("create table t1(n int, s varchar(20))")
+        for i in range(10):
+            self.cursor.execute("insert into t1 values (?, ?)", i, str(i))
+        rows = self.cursor.execute("select n, s from t1 order by n").fetchall()
+        del rows
+        rows = self.cursor.execute("select n, s from t1 order by n desc").fetchall()
+        self.assertEqual([ tuple(row) for row in rows ], [ (i, str(i)) for i in range(9, -1, -1) ])
+        self.assertEqual(rows[0].s, '9')
+
+    def test_lazyrows(self):
+        "Ensure lazy rows return the same values, even after the cursor has moved on"
+        self.cursor.execute("create table t1(n int, s varchar(20), d decimal(10,2))")
+        for i in range(100):
+            self.cursor.execute("insert into t1 values (?, ?, ?)", i, str(i), Decimal(i) / 4)
+        self.cursor.arraysize = 30
+        expected = [ tuple(row) for row in self.cursor.execute("select n, s, d from t1 order by n").fetchall() ]
+
+        self.cursor.lazyrows = True
+        self.assertEqual(self.cursor.lazyrows, True)
+        rows = self.cursor.execute("select n, s, d from t1 order by n").fetchall()
+        self.cursor.execute("select 1")
+        self.assertEqual(rows[50].s, '50')
+        self.assertEqual([ row[0] for row in rows ], list(range(100)))
+        self.assertEqual([ tuple(row) for row in rows ], expected)
+
+        # A prefetching cursor copies the rowsets the rows use instead of giving them its fetch buffer.
+        self.cursor.prefetch = 2
+        rows = self.cursor.execute("select n, s, d from t1 order by n").fetchall()
+        self.cursor.execute("select 1")
+        self.assertEqual([ tuple(row) for row in rows ], expected)
+
+    def test_row_getattr(self):
+        "Ensure columns are found by name whether or not the attribute name is interned"
+        self.cursor.execute("create table t1(a int, b varchar(20), c int)")
+        self.cursor.execute("insert into t1 values (1, 'two', 3)")
+        row = self.cursor.execute("select a, b, c, a as d from t1").fetchone()
+        self.assertEqual((row.a, row.b, row.c, row.d), (1, 'two', 3, 1))
+        self.assertEqual(getattr(row, ''.join(['b'])), 'two')
+        setattr(row, ''.join(['c']), 4)
+        self.assertEqual(row[2], 4)
+        self.assertRaises(AttributeError, getattr, row, 'e')
+
+    def test_unicode_widths(self):
+        "Ensure ASCII, Latin-1, BMP, and surrogate pair text is decoded correctly"
+        row = self.cursor.execute("select N'abc', N'caf' + nchar(233), nchar(8364) + N'1', "
+                                  "N'x' + nchar(55357) + nchar(56832) + N'y'").fetchone()
+        self.assertEqual(list(row), ['abc', 'caf\xe9', '\u20ac1', 'x\U0001f600y'])
+        self.assertEqual(len(row[3]), 3)
+
+    def test_long_max_values(self):
+        "Ensure multi-megabyte varchar(max) and nvarchar(max) values are read completely"
+        for i in range(2):
+            row = self.cursor.execute("select replicate(cast('ab' as varchar(max)), 1500000), "
+                                      "replicate(cast(N'cd' as nvarchar(max)), 1500000)").fetchone()
+            self.assertEqual(row[0], 'ab' * 1500000)
+            self.assertEqual(row[1], 'cd' * 1500000)
+
+    def test_streamlobs(self):
+        "Ensure a varbinary(max) column at the end of the results can be read with a LobReader"
+        value = bytearray(range(256)) * 1000
+        self.cursor.execute("create table t1(n int, b varbinary(max))")
+        self.cursor.execute("insert into t1 values (1, ?)", value)
+        self.cursor.execute("insert into t1 values (2, null)")
+
+        self.cursor.streamlobs = True
+        self.cursor.execute("select n, b from t1 order by n")
+        row = self.cursor.fetchone()
+        self.assertTrue(isinstance(row.b, pyodbc.LobReader))
+        buf = bytearray(1000)
+        result = bytearray()
+        while True:
+            count = row.b.readinto(buf)
+            if not count:
+                break
+            result += buf[:count]
+        self.assertEqual(result, value)
+        self.assertEqual(self.cursor.fetchone().b, None)
+        self.assertRaises(pyodbc.ProgrammingError, row.b.read)
+
+    def test_stream_params(self):
+        "Ensure file-like objects, iterators, and memoryviews can be inserted into a varbinary(max) column"
+        from io import BytesIO
+        value = bytearray(range(256)) * 1000
+        self.cursor.paramchunksize = 4000
+        self.cursor.execute("create table t1(n int, b varbinary(max))")
+        self.cursor.execute("insert into t1 values (1, ?)", BytesIO(bytes(value)))
+        self.cursor.execute("insert into t1 values (2, ?)", (bytes(value[i:i+1000]) for i in range(0, len(value), 1000)))
+        self.cursor.execute("insert into t1 values (3, ?)", memoryview(value))
+        self.cursor.execute("insert into t1 values (4, ?)", iter([]))
+
+        rows = self.cursor.execute("select n, b from t1 order by n").fetchall()
+        self.assertEqual([row.n for row in rows], [1, 2, 3, 4])
+        for row in rows[:3]:
+            self.assertEqual(bytearray(row.b), value)
+        self.assertEqual(len(rows[3].b), 0)
+
+        self.assertRaises(ValueError, setattr, self.cursor, 'paramchunksize', 0)
+
+    def test_buffer_params(self):
+        "Ensure objects that export the buffer protocol are inserted as binary"
+        import array
+        value = bytearray(range(256)) * 100
+        numbers = array.array('i', range(1000))
+        self.cursor.execute("create table t1(n int, b varbinary(max))")
+        self.cursor.execute("insert into t1 values (1, ?)", memoryview(value[:100]))
+        self.cursor.execute("insert into t1 values (2, ?)", memoryview(value))
+        self.cursor.execute("insert into t1 values (3, ?)", numbers)
+        rows = self.cursor.execute("select b from t1 order by n").fetchall()
+        self.assertEqual(bytearray(rows[0].b), value[:100])
+        self.assertEqual(bytearray(rows[1].b), value)
+        self.assertEqual(bytes(rows[2].b), numbers.tobytes())
+        self.assertRaises(BufferError, self.cursor.execute, "insert into t1 values (4, ?)", memoryview(value)[::2])
+
+    def test_fetchnumpy(self):
+        try:
+            import numpy
+        except ImportError:
+            return
+        self.cursor.execute("create table t1(n int, f float, s varchar(10))")
+        self.cursor.execute("insert into t1 values (1, 1.5, 'a')")
+        self.cursor.execute("insert into t1 values (2, null, 'b')")
+        self.cursor.execute("insert into t1 values (3, 3.5, null)")
+        self.cursor.execute("select n, f, s from t1 order by n")
+        result = self.cursor.fetchnumpy()
+        self.assertEqual(result['n'].tolist(), [1, 2, 3])
+        self.assertEqual(result['n'].dtype, numpy.int32)
+        self.assertEqual(result['f'].mask.tolist(), [False, True, False])
+        self.assertEqual(result['s'].tolist(), ['a', 'b', None])
+        self.assertEqual(len(self.cursor.fetchnumpy()['n']), 0)
+
+    def test_fetcharrow(self):
+        try:
+            import pyarrow
+            from pyarrow.cffi import ffi
+        except ImportError:
+            return
+        self.cursor.execute("create table t1(n int, d decimal(10,2), s nvarchar(10))")
+        self.cursor.execute("insert into t1 values (1, 1.25, 'a')")
+        self.cursor.execute("insert into t1 values (2, null, 'b')")
+        self.cursor.execute("insert into t1 values (3, -3.5, null)")
+        self.cursor.execute("select n, d, s from t1 order by n")
+
+        c_array  = ffi.new("struct ArrowArray*")
+        c_schema = ffi.new("struct ArrowSchema*")
+        pa = int(ffi.cast("uintptr_t", c_array))
+        ps = int(ffi.cast("uintptr_t", c_schema))
+        self.assertEqual(self.cursor.fetcharrow(pa, ps), 3)
+        batch = pyarrow.RecordBatch._import_from_c(pa, ps)
+        self.assertEqual(batch.column(0).to_pylist(), [1, 2, 3])
+        self.assertEqual(batch.column(1).to_pylist(), [Decimal('1.25'), None, Decimal('-3.50')])
+        self.assertEqual(batch.column(2).to_pylist(), [u'a', u'b', None])
+
     def test_timeout(self):
         self.assertEqual(self.cnxn.timeout, 0) # defaults to zero (off)
 
@@ -1043,6 +1408,72 @@ class SqlServerTestCase(unittest.TestCase):
         self.cnxn.timeout = 0
         self.assertEqual(self.cnxn.timeout, 0)
 
+    def test_statement_cache(self):
+        self.assertEqual(self.cnxn.statement_cache_size, 0) # defaults to zero (off)
+
+        self.cursor.execute("create table t1(a int, b varchar(10))")
+        self.cursor.execute("insert into t1 values (1, 'one')")
+
+        self.cnxn.statement_cache_size = 2
+        for i in range(3):
+            self.assertEqual(self.cursor.execute("select a from t1 where a=?", 1).fetchone()[0], 1)
+            self.assertEqual(self.cursor.execute("select b from t1 where a=?", 1).fetchone()[0], 'one')
+            self.assertEqual(self.cnxn.execute("select b from t1 where a=?", 1).fetchone()[0], 'one')
+        self.failUnless(self.cnxn.statement_cache_hits >= 6)
+
+        self.cnxn.statement_cache_size = 0
+        self.assertEqual(self.cursor.execute("select a from t1 where a=?", 1).fetchone()[0], 1)
+
+    def test_statement_cache_timeout(self):
+        # A statement taken from the cache uses the connection's current timeout, not the one it was allocated with.
+        self.cnxn.statement_cache_size = 2
+        self.cursor.execute("waitfor delay ?", '00:00:00')
+        self.cursor.execute("select ?", 1)
+
+        self.cnxn.timeout = 1
+        other = self.cnxn.cursor()
+        self.assertRaises(pyodbc.OperationalError, other.execute, "waitfor delay ?", '00:00:05')
+
+    def test_statement_cache_noscan(self):
+        # The noscan setting belongs to the cursor, not to the statements it moves into the cache.
+        self.cnxn.statement_cache_size = 2
+        self.cursor.noscan = True
+        self.cursor.execute("select ?", 1)
+        self.cursor.execute("select ? + 1", 1)
+
+        other = self.cnxn.cursor()
+        other.execute("select ?", 1)
+        self.assertEqual(other.noscan, False)
+
+        self.cursor.execute("select ?", 1)
+        self.assertEqual(self.cursor.noscan, True)
+
+    def test_pool(self):
+        pool = pyodbc.Pool(self.connection_string, minsize=1, maxsize=2)
+        self.assertEqual(pool.idle, 1)
+
+        cnxn = pool.connect()
+        self.assertEqual(pool.active, 1)
+        self.assertEqual(cnxn.execute("select 1").fetchone()[0], 1)
+        cnxn.autocommit = True
+        cnxn.close()
+        self.assertEqual(pool.idle, 1)
+        self.assertEqual(pool.connects, 1)
+
+        # The connection's state was reset when it was returned.
+        cnxn = pool.connect()
+        self.assertEqual(cnxn.autocommit, False)
+
+        other = pool.connect()
+        self.failUnlessRaises(pyodbc.OperationalError, pool.connect)
+        other.close()
+        cnxn.close()
+        self.assertEqual(pool.checkouts, 3)
+
+        pool.close()
+        self.assertEqual(pool.idle, 0)
+        self.failUnlessRaises(pyodbc.ProgrammingError, pool.connect)
+
     def test_sets_execute(self):
         # Only lists and tuples are allowed.
         def f():
@@ -0,0 +1,1946 @@
+
+// A tiny in-process ODBC driver used to exercise and benchmark pyodbc without a database server.  It serves synthetic
+// results from memory, so timings measure pyodbc instead of a network or database engine.  See tests2/mockbench.py.
+//
+// Build it with `python setup.py mockodbc`, which writes build/mockodbc/libmockodbc.so, or by hand:
+//
+//   g++ -O2 -fPIC -shared mockodbc.cpp -o libmockodbc.so -lpthread
+//
+// unixODBC loads it from a path in the connection string, so it does not need to be registered in odbcinst.ini:
+//
+//   DRIVER=/path/to/build/mockodbc/libmockodbc.so
+//
+// pyodbc can also be linked directly against it (renamed libodbc.so) to take the driver manager out of the timings.
+//
+// The driver does not parse SQL.  The first word of each statement selects the behavior:
+//
+//   mock rows=N cols=TYPE,TYPE,... [nulls=K] [sets=M] [text=ascii|latin1|bmp|astral] [nototal] [overflow=K]
+//       Produces N generated rows.  TYPE is one of int, smallint, tinyint, bigint, uint, ubigint, bit, real, double,
+//       decimal(p,s), char(n), varchar(n), wchar(n), wvarchar(n), longvarchar(n), wlongvarchar(n),
+//       binary(n), varbinary(n), longvarbinary(n), date, time, timestamp, guid.  For the long types,
+//       `n` is the length of the generated value and the column reports a size of 0, as "max" columns do.
+//       Every Kth cell is NULL.  `nototal` makes SQLGetData report SQL_NO_TOTAL for partial reads.  `overflow`
+//       makes the char, binary, and decimal values of every Kth row longer than the column size reported for them,
+//       as drivers that misreport sizes do.
+//
+//   insert NAME (?, ?, ...)    Appends each parameter set to the in-memory table NAME.
+//   select NAME                Returns the rows of table NAME, typed like the parameters that filled it.
+//   delete NAME                Empties table NAME.
+//   echo ?, ?, ...             Returns the parameters, one row per parameter set.
+//   fail [SQLSTATE] [row=K]    Fails with the given SQLSTATE, or only parameter set K when row= is used.
+//   sleep MS                   Sleeps for MS milliseconds, or the first parameter's value when MS is ?.  SQLCancel
+//                              or the query timeout ends it early.
+//
+// Anything else succeeds, produces no results, and reports the number of parameter sets as its row count.  Its
+// parameters are bound but never read, so executing it measures only the cost of binding them.
+//
+// Call counters are exported as MockGetCounter so tests can verify how often pyodbc calls the driver.
+
+#include <sql.h>
+#include <sqlext.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <unistd.h>
+#include <pthread.h>
+
+#ifndef SQL_SS_TIME2
+#define SQL_SS_TIME2 (-154)
+#endif
+
+#define EXPORT extern "C" __attribute__((visibility("default")))
+
+enum
+{
+    CALL_PREPARE,
+    CALL_EXECUTE,
+    CALL_EXECDIRECT,
+    CALL_DESCRIBECOL,
+    CALL_COLATTRIBUTE,
+    CALL_NUMRESULTCOLS,
+    CALL_FETCH,
+    CALL_GETDATA,
+    CALL_BINDCOL,
+    CALL_BINDPARAMETER,
+    CALL_PUTDATA,
+    CALL_ALLOCSTMT,
+    CALL_CONNECT,
+    CALL_DISCONNECT,
+    CALL_ENDTRAN,
+    CALL_SETPOS,
+    CALL_COUNT
+};
+
+static const char* const CALL_NAMES[CALL_COUNT] =
+{
+    "prepare", "execute", "execdirect", "describecol", "colattribute", "numresultcols", "fetch", "getdata",
+    "bindcol", "bindparameter", "putdata", "allocstmt", "connect", "disconnect", "endtran", "setpos"
+};
+
+static long counters[CALL_COUNT];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void Count(int call)
+{
+    __sync_fetch_and_add(&counters[call], 1);
+}
+
+EXPORT long MockGetCounter(const char* name)
+{
+    for (int i = 0; i < CALL_COUNT; i++)
+        if (strcmp(name, CALL_NAMES[i]) == 0)
+            return counters[i];
+    return -1;
+}
+
+// When set, SQL_ATTR_CONNECTION_DEAD reports every connection as dead.
+static bool connections_dead = false;
+
+EXPORT void MockSetConnectionsDead(int dead)
+{
+    connections_dead = (dead != 0);
+}
+
+EXPORT void MockResetCounters()
+{
+    for (int i = 0; i < CALL_COUNT; i++)
+        counters[i] = 0;
+}
+
+//
+// Values
+//
+
+enum ValueKind { KIND_NULL, KIND_INT, KIND_DOUBLE, KIND_TEXT, KIND_BINARY, KIND_TIMESTAMP };
+
+struct Value
+{
+    ValueKind kind;
+    long long i;
+    double d;
+    std::string s;              // UTF-8 text, decimal text, or raw bytes
+    SQL_TIMESTAMP_STRUCT ts;
+
+    Value() : kind(KIND_NULL), i(0), d(0) { memset(&ts, 0, sizeof(ts)); }
+};
+
+struct Column
+{
+    std::string name;
+    SQLSMALLINT sql_type;
+    SQLULEN size;               // reported column size
+    SQLULEN length;             // generated value length
+    SQLSMALLINT digits;
+    bool is_unsigned;
+};
+
+struct Table
+{
+    std::vector<Column> columns;
+    std::vector<std::vector<Value> > rows;
+};
+
+static std::map<std::string, Table> tables;
+
+static void AppendUtf8(std::string& s, unsigned int ch)
+{
+    if (ch < 0x80)
+        s += (char)ch;
+    else if (ch < 0x800)
+    {
+        s += (char)(0xC0 | (ch >> 6));
+        s += (char)(0x80 | (ch & 0x3F));
+    }
+    else if (ch < 0x10000)
+    {
+        s += (char)(0xE0 | (ch >> 12));
+        s += (char)(0x80 | ((ch >> 6) & 0x3F));
+        s += (char)(0x80 | (ch & 0x3F));
+    }
+    else
+    {
+        s += (char)(0xF0 | (ch >> 18));
+        s += (char)(0x80 | ((ch >> 12) & 0x3F));
+        s += (char)(0x80 | ((ch >> 6) & 0x3F));
+        s += (char)(0x80 | (ch & 0x3F));
+    }
+}
+
+static std::vector<SQLWCHAR> Utf8ToUtf16(const std::string& s)
+{
+    std::vector<SQLWCHAR> w;
+    size_t i = 0;
+    while (i < s.size())
+    {
+        unsigned char c = (unsigned char)s[i];
+        unsigned int ch;
+        int extra;
+        if (c < 0x80)      { ch = c;        extra = 0; }
+        else if (c < 0xE0) { ch = c & 0x1F; extra = 1; }
+        else if (c < 0xF0) { ch = c & 0x0F; extra = 2; }
+        else               { ch = c & 0x07; extra = 3; }
+        i++;
+        for (int j = 0; j < extra && i < s.size(); j++, i++)
+            ch = (ch << 6) | ((unsigned char)s[i] & 0x3F);
+        if (ch >= 0x10000)
+        {
+            ch -= 0x10000;
+            w.push_back((SQLWCHAR)(0xD800 + (ch >> 10)));
+            w.push_back((SQLWCHAR)(0xDC00 + (ch & 0x3FF)));
+        }
+        else
+            w.push_back((SQLWCHAR)ch);
+    }
+    return w;
+}
+
+static std::string Utf16ToUtf8(const SQLWCHAR* p, size_t cch)
+{
+    std::string s;
+    for (size_t i = 0; i < cch; i++)
+    {
+        unsigned int ch = p[i];
+        if (ch >= 0xD800 && ch < 0xDC00 && i + 1 < cch)
+        {
+            ch = 0x10000 + ((ch - 0xD800) << 10) + (p[i+1] - 0xDC00);
+            i++;
+        }
+        AppendUtf8(s, ch);
+    }
+    return s;
+}
+
+static std::string FormatValue(const Value& v)
+{
+    char sz[64];
+    switch (v.kind)
+    {
+    case KIND_INT:
+        sprintf(sz, "%lld", v.i);
+        return sz;
+    case KIND_DOUBLE:
+        sprintf(sz, "%.17g", v.d);
+        return sz;
+    case KIND_TIMESTAMP:
+        sprintf(sz, "%04d-%02d-%02d %02d:%02d:%02d.%03d", v.ts.year, v.ts.month, v.ts.day, v.ts.hour, v.ts.minute,
+                v.ts.second, (int)(v.ts.fraction / 1000000));
+        return sz;
+    default:
+        return v.s;
+    }
+}
+
+static long long IntValue(const Value& v)
+{
+    if (v.kind == KIND_INT)
+        return v.i;
+    if (v.kind == KIND_DOUBLE)
+        return (long long)v.d;
+    return atoll(v.s.c_str());
+}
+
+static double DoubleValue(const Value& v)
+{
+    if (v.kind == KIND_INT)
+        return (double)v.i;
+    if (v.kind == KIND_DOUBLE)
+        return v.d;
+    return atof(v.s.c_str());
+}
+
+//
+// Handles
+//
+
+struct Diag
+{
+    char state[6];
+    std::string message;
+    bool set;
+    Diag() : set(false) { state[0] = 0; }
+};
+
+struct Env
+{
+    Diag diag;
+};
+
+struct Dbc
+{
+    Diag diag;
+    bool connected;
+    SQLULEN autocommit;
+};
+
+struct BoundCol
+{
+    SQLSMALLINT ctype;
+    SQLPOINTER ptr;
+    SQLLEN buflen;
+    SQLLEN* ind;
+};
+
+struct BoundParam
+{
+    SQLSMALLINT ctype;
+    SQLSMALLINT sql_type;
+    SQLULEN size;
+    SQLSMALLINT digits;
+    SQLPOINTER ptr;
+    SQLLEN buflen;
+    SQLLEN* ind;
+};
+
+struct Generator
+{
+    long rows;
+    long nulls;
+    int sets;
+    unsigned int pad;           // code point used to pad text
+    bool nototal;
+    long overflow;
+};
+
+struct Stmt
+{
+    Diag diag;
+    Dbc* dbc;
+    std::string sql;
+    bool prepared;
+    volatile bool cancelled;
+
+    // result set
+    bool has_results;
+    std::vector<Column> columns;
+    Generator gen;
+    const std::vector<std::vector<Value> >* rows; // set for table / echo results, otherwise generated
+    std::vector<std::vector<Value> > echo_rows;
+    long row_count;             // rows in the result set
+    long position;              // index of the current row, -1 before the first fetch
+    long rowset_size;           // rows in the current rowset
+    long setpos_row;            // the row in the rowset selected by SQLSetPos, or -1
+    int sets_left;
+    SQLLEN affected;
+
+    // SQLGetData state
+    int getdata_col;
+    size_t getdata_offset;
+
+    // block cursors
+    std::vector<BoundCol> bound;
+    SQLULEN row_array_size;
+    SQLULEN row_bind_type;
+    SQLULEN* rows_fetched;
+    SQLUSMALLINT* row_status;
+    SQLLEN* bind_offset;        // SQL_ATTR_ROW_BIND_OFFSET_PTR
+
+    // parameters
+    std::vector<BoundParam> params;
+    SQLULEN paramset_size;
+    SQLULEN param_bind_type;
+    SQLUSMALLINT* param_status;
+    SQLULEN* params_processed;
+
+    // data-at-execution state: (paramset, param) pairs still needing data, and the data collected so far
+    std::vector<std::pair<SQLULEN, int> > need_data;
+    size_t need_index;
+    std::map<std::pair<SQLULEN, int>, std::string> dae;
+
+    SQLULEN query_timeout;
+    SQLULEN noscan;
+};
+
+static void SetDiag(Diag& d, const char* state, const char* msg)
+{
+    strncpy(d.state, state, 5);
+    d.state[5] = 0;
+    d.message = msg;
+    d.set = true;
+}
+
+static SQLRETURN Fail(Stmt* s, const char* state, const char* msg)
+{
+    SetDiag(s->diag, state, msg);
+    return SQL_ERROR;
+}
+
+//
+// Statement "parsing"
+//
+
+static std::string Lower(const std::string& s)
+{
+    std::string r(s);
+    for (size_t i = 0; i < r.size(); i++)
+        r[i] = (char)tolower((unsigned char)r[i]);
+    return r;
+}
+
+static std::vector<std::string> Words(const std::string& sql)
+{
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < sql.size())
+    {
+        while (i < sql.size() && isspace((unsigned char)sql[i]))
+            i++;
+        size_t start = i;
+        int depth = 0;
+        while (i < sql.size() && (depth > 0 || !isspace((unsigned char)sql[i])))
+        {
+            if (sql[i] == '(') depth++;
+            if (sql[i] == ')') depth--;
+            i++;
+        }
+        if (i > start)
+            words.push_back(sql.substr(start, i - start));
+    }
+    return words;
+}
+
+static std::string Option(const std::vector<std::string>& words, const char* name, const char* def)
+{
+    size_t len = strlen(name);
+    for (size_t i = 1; i < words.size(); i++)
+        if (words[i].size() > len && words[i].compare(0, len, name) == 0 && words[i][len] == '=')
+            return words[i].substr(len + 1);
+    return def;
+}
+
+static bool Flag(const std::vector<std::string>& words, const char* name)
+{
+    for (size_t i = 1; i < words.size(); i++)
+        if (words[i] == name)
+            return true;
+    return false;
+}
+
+static bool ParseColumn(const std::string& spec, int index, Column& col)
+{
+    std::string name(spec);
+    long a = 0, b = 0;
+    size_t paren = spec.find('(');
+    if (paren != std::string::npos)
+    {
+        name = spec.substr(0, paren);
+        a = atol(spec.c_str() + paren + 1);
+        size_t comma = spec.find(',', paren);
+        if (comma != std::string::npos)
+            b = atol(spec.c_str() + comma + 1);
+    }
+
+    char sz[20];
+    sprintf(sz, "c%d", index + 1);
+    col.name        = sz;
+    col.size        = (SQLULEN)a;
+    col.length      = (SQLULEN)a;
+    col.digits      = 0;
+    col.is_unsigned = false;
+
+    struct { const char* name; SQLSMALLINT type; SQLULEN size; } fixed[] =
+    {
+        { "int",       SQL_INTEGER,        10 },
+        { "smallint",  SQL_SMALLINT,        5 },
+        { "tinyint",   SQL_TINYINT,         3 },
+        { "bigint",    SQL_BIGINT,         19 },
+        { "uint",      SQL_INTEGER,        10 },
+        { "ubigint",   SQL_BIGINT,         20 },
+        { "bit",       SQL_BIT,             1 },
+        { "real",      SQL_REAL,            7 },
+        { "double",    SQL_DOUBLE,         15 },
+        { "float",     SQL_FLOAT,          15 },
+        { "date",      SQL_TYPE_DATE,      10 },
+        { "time",      SQL_TYPE_TIME,       8 },
+        { "timestamp", SQL_TYPE_TIMESTAMP, 23 },
+        { "guid",      SQL_GUID,           36 },
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+    {
+        if (name == fixed[i].name)
+        {
+            col.sql_type = fixed[i].type;
+            col.size     = col.length = fixed[i].size;
+            col.digits   = (col.sql_type == SQL_TYPE_TIMESTAMP) ? 3 : 0;
+            col.is_unsigned = (col.sql_type == SQL_TINYINT || name[0] == 'u');
+            return true;
+        }
+    }
+
+    struct { const char* name; SQLSMALLINT type; bool max; } sized[] =
+    {
+        { "decimal",       SQL_DECIMAL,       false },
+        { "numeric",       SQL_NUMERIC,       false },
+        { "char",          SQL_CHAR,          false },
+        { "varchar",       SQL_VARCHAR,       false },
+        { "wchar",         SQL_WCHAR,         false },
+        { "wvarchar",      SQL_WVARCHAR,      false },
+        { "binary",        SQL_BINARY,        false },
+        { "varbinary",     SQL_VARBINARY,     false },
+        { "longvarchar",   SQL_LONGVARCHAR,   true  },
+        { "wlongvarchar",  SQL_WLONGVARCHAR,  true  },
+        { "longvarbinary", SQL_LONGVARBINARY, true  },
+    };
+    for (size_t i = 0; i < sizeof(sized) / sizeof(sized[0]); i++)
+    {
+        if (name == sized[i].name)
+        {
+            col.sql_type = sized[i].type;
+            if (sized[i].max)
+                col.size = 0;
+            if (col.sql_type == SQL_DECIMAL || col.sql_type == SQL_NUMERIC)
+                col.digits = (SQLSMALLINT)b;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void DaysToDate(long days, SQL_TIMESTAMP_STRUCT& ts)
+{
+    ts.year  = (SQLSMALLINT)(2020 + days / 336);
+    ts.month = (SQLUSMALLINT)(1 + (days / 28) % 12);
+    ts.day   = (SQLUSMALLINT)(1 + days % 28);
+}
+
+static void Generate(Stmt* s, long row, int icol, Value& v)
+{
+    const Column& col = s->columns[icol];
+
+    v.kind = KIND_NULL;
+    if (s->gen.nulls > 0 && (row + icol) % s->gen.nulls == s->gen.nulls - 1)
+        return;
+
+    // The length of the variable-length values, which is longer than the column size in the overflow rows.
+    bool overflow = s->gen.overflow > 0 && row % s->gen.overflow == s->gen.overflow - 1;
+    SQLULEN length = overflow ? col.length * 2 + 10 : col.length;
+
+    switch (col.sql_type)
+    {
+    case SQL_INTEGER:
+    case SQL_BIGINT:
+        // Unsigned values count down from the maximum, so they don't fit in the signed types.
+        v.kind = KIND_INT;
+        v.i = !col.is_unsigned ? row : (col.sql_type == SQL_INTEGER) ? 0xFFFFFFFFLL - row : -1 - (long long)row;
+        break;
+    case SQL_SMALLINT:
+        v.kind = KIND_INT;
+        v.i = row % 32768;
+        break;
+    case SQL_TINYINT:
+        v.kind = KIND_INT;
+        v.i = row % 256;
+        break;
+    case SQL_BIT:
+        v.kind = KIND_INT;
+        v.i = row % 2;
+        break;
+    case SQL_REAL:
+    case SQL_DOUBLE:
+    case SQL_FLOAT:
+        v.kind = KIND_DOUBLE;
+        v.d = row + 0.5;
+        break;
+    case SQL_DECIMAL:
+    case SQL_NUMERIC:
+    {
+        char sz[64];
+        if (col.digits > 0)
+            sprintf(sz, "%ld.%0*d", row, (int)col.digits, 25);
+        else
+            sprintf(sz, "%ld", row);
+        v.kind = KIND_TEXT;
+        v.s = sz;
+        if (overflow)
+            v.s.insert(0, 120, '9');
+        break;
+    }
+    case SQL_TYPE_DATE:
+    case SQL_TYPE_TIME:
+    case SQL_TYPE_TIMESTAMP:
+        v.kind = KIND_TIMESTAMP;
+        DaysToDate(row / 86400, v.ts);
+        v.ts.hour     = (SQLUSMALLINT)((row / 3600) % 24);
+        v.ts.minute   = (SQLUSMALLINT)((row / 60) % 60);
+        v.ts.second   = (SQLUSMALLINT)(row % 60);
+        v.ts.fraction = (col.sql_type == SQL_TYPE_TIMESTAMP) ? (SQLUINTEGER)((row % 1000) * 1000000) : 0;
+        break;
+    case SQL_GUID:
+    {
+        char sz[40];
+        sprintf(sz, "00000000-0000-0000-0000-%012ld", row);
+        v.kind = KIND_TEXT;
+        v.s = sz;
+        break;
+    }
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+    case SQL_LONGVARBINARY:
+        v.kind = KIND_BINARY;
+        v.s.resize(length);
+        for (SQLULEN i = 0; i < length; i++)
+            v.s[i] = (char)((row + i) & 0xFF);
+        break;
+    default:
+    {
+        char sz[40];
+        sprintf(sz, "r%ldc%d:", row, icol + 1);
+        v.kind = KIND_TEXT;
+        v.s = sz;
+        if (v.s.size() > length)
+            v.s.resize(length);
+        bool wide = (col.sql_type == SQL_WCHAR || col.sql_type == SQL_WVARCHAR || col.sql_type == SQL_WLONGVARCHAR);
+        unsigned int pad = wide ? s->gen.pad : 'x';
+        for (SQLULEN i = v.s.size(); i < length; i++)
+            AppendUtf8(v.s, pad);
+        break;
+    }
+    }
+}
+
+static void GetCell(Stmt* s, long row, int icol, Value& v)
+{
+    if (s->rows)
+        v = (*s->rows)[row][icol];
+    else
+        Generate(s, row, icol, v);
+}
+
+//
+// Writing values into application buffers
+//
+
+static SQLLEN FixedSize(SQLSMALLINT ctype)
+{
+    switch (ctype)
+    {
+    case SQL_C_BIT:
+    case SQL_C_TINYINT:
+    case SQL_C_STINYINT:
+    case SQL_C_UTINYINT:
+        return 1;
+    case SQL_C_SHORT:
+    case SQL_C_SSHORT:
+    case SQL_C_USHORT:
+        return 2;
+    case SQL_C_LONG:
+    case SQL_C_SLONG:
+    case SQL_C_ULONG:
+    case SQL_C_FLOAT:
+        return 4;
+    case SQL_C_SBIGINT:
+    case SQL_C_UBIGINT:
+    case SQL_C_DOUBLE:
+        return 8;
+    case SQL_C_TYPE_DATE:
+        return sizeof(SQL_DATE_STRUCT);
+    case SQL_C_TYPE_TIME:
+        return sizeof(SQL_TIME_STRUCT);
+    case SQL_C_TYPE_TIMESTAMP:
+        return sizeof(SQL_TIMESTAMP_STRUCT);
+    case SQL_C_NUMERIC:
+        return sizeof(SQL_NUMERIC_STRUCT);
+    }
+    return 0;
+}
+
+static SQLSMALLINT DefaultCType(SQLSMALLINT sql_type)
+{
+    switch (sql_type)
+    {
+    case SQL_INTEGER:   return SQL_C_SLONG;
+    case SQL_SMALLINT:  return SQL_C_SSHORT;
+    case SQL_TINYINT:   return SQL_C_UTINYINT;
+    case SQL_BIGINT:    return SQL_C_SBIGINT;
+    case SQL_BIT:       return SQL_C_BIT;
+    case SQL_REAL:      return SQL_C_FLOAT;
+    case SQL_DOUBLE:
+    case SQL_FLOAT:     return SQL_C_DOUBLE;
+    case SQL_TYPE_DATE: return SQL_C_TYPE_DATE;
+    case SQL_TYPE_TIME: return SQL_C_TYPE_TIME;
+    case SQL_TYPE_TIMESTAMP: return SQL_C_TYPE_TIMESTAMP;
+    case SQL_BINARY:
+    case SQL_VARBINARY:
+    case SQL_LONGVARBINARY: return SQL_C_BINARY;
+    case SQL_WCHAR:
+    case SQL_WVARCHAR:
+    case SQL_WLONGVARCHAR: return SQL_C_WCHAR;
+    }
+    return SQL_C_CHAR;
+}
+
+// Copies `v` into the buffer, starting `offset` bytes into the converted value for the variable-length types.  On
+// return, `offset` is advanced past the bytes written.
+
+static SQLRETURN WriteValue(Stmt* s, const Value& v, SQLSMALLINT ctype, SQLPOINTER ptr, SQLLEN buflen, SQLLEN* ind,
+                            size_t& offset, SQLSMALLINT sql_type)
+{
+    if (ctype == SQL_C_DEFAULT)
+        ctype = DefaultCType(sql_type);
+
+    if (v.kind == KIND_NULL)
+    {
+        if (!ind)
+            return Fail(s, "22002", "Indicator variable required but not supplied");
+        *ind = SQL_NULL_DATA;
+        return SQL_SUCCESS;
+    }
+
+    switch (ctype)
+    {
+    case SQL_C_CHAR:
+    case SQL_C_WCHAR:
+    case SQL_C_BINARY:
+    {
+        std::string bytes;
+        size_t unit = 1;
+        if (ctype == SQL_C_WCHAR)
+        {
+            std::vector<SQLWCHAR> w = Utf8ToUtf16(FormatValue(v));
+            bytes.assign((const char*)&w[0], w.size() * sizeof(SQLWCHAR));
+            unit = sizeof(SQLWCHAR);
+        }
+        else
+        {
+            bytes = FormatValue(v);
+        }
+
+        if (offset > 0 && offset >= bytes.size())
+            return SQL_NO_DATA;
+
+        size_t remaining = bytes.size() - offset;
+        size_t room = (size_t)buflen;
+        if (ctype != SQL_C_BINARY)
+            room = (room >= unit) ? (room - unit) / unit * unit : 0;
+
+        size_t n = (remaining < room) ? remaining : room;
+        if (ptr)
+        {
+            memcpy(ptr, bytes.data() + offset, n);
+            if (ctype != SQL_C_BINARY && buflen >= (SQLLEN)unit)
+                memset((char*)ptr + n, 0, unit);
+        }
+
+        if (ind)
+            *ind = (s->gen.nototal && n < remaining) ? SQL_NO_TOTAL : (SQLLEN)remaining;
+
+        offset += n;
+        if (n < remaining)
+        {
+            SetDiag(s->diag, "01004", "String data, right truncated");
+            return SQL_SUCCESS_WITH_INFO;
+        }
+        return SQL_SUCCESS;
+    }
+
+    case SQL_C_BIT:
+    case SQL_C_TINYINT:
+    case SQL_C_STINYINT:
+    case SQL_C_UTINYINT:
+        *(unsigned char*)ptr = (unsigned char)IntValue(v);
+        break;
+    case SQL_C_SHORT:
+    case SQL_C_SSHORT:
+    case SQL_C_USHORT:
+        *(short*)ptr = (short)IntValue(v);
+        break;
+    case SQL_C_LONG:
+    case SQL_C_SLONG:
+    case SQL_C_ULONG:
+        *(SQLINTEGER*)ptr = (SQLINTEGER)IntValue(v);
+        break;
+    case SQL_C_SBIGINT:
+    case SQL_C_UBIGINT:
+        *(SQLBIGINT*)ptr = (SQLBIGINT)IntValue(v);
+        break;
+    case SQL_C_FLOAT:
+        *(float*)ptr = (float)DoubleValue(v);
+        break;
+    case SQL_C_DOUBLE:
+        *(double*)ptr = DoubleValue(v);
+        break;
+    case SQL_C_TYPE_TIMESTAMP:
+        *(SQL_TIMESTAMP_STRUCT*)ptr = v.ts;
+        break;
+    case SQL_C_TYPE_DATE:
+    {
+        SQL_DATE_STRUCT* p = (SQL_DATE_STRUCT*)ptr;
+        p->year = v.ts.year; p->month = v.ts.month; p->day = v.ts.day;
+        break;
+    }
+    case SQL_C_TYPE_TIME:
+    {
+        SQL_TIME_STRUCT* p = (SQL_TIME_STRUCT*)ptr;
+        p->hour = v.ts.hour; p->minute = v.ts.minute; p->second = v.ts.second;
+        break;
+    }
+    default:
+        return Fail(s, "07006", "Restricted data type attribute violation");
+    }
+
+    if (ind)
+        *ind = FixedSize(ctype);
+    return SQL_SUCCESS;
+}
+
+//
+// Reading parameters
+//
+
+static char* ParamAddress(Stmt* s, const BoundParam& p, SQLULEN row)
+{
+    if (!p.ptr)
+        return 0;
+    SQLLEN size = (s->param_bind_type != SQL_PARAM_BIND_BY_COLUMN) ? (SQLLEN)s->param_bind_type
+                : (FixedSize(p.ctype) ? FixedSize(p.ctype) : p.buflen);
+    return (char*)p.ptr + row * size;
+}
+
+static SQLLEN* IndAddress(Stmt* s, const BoundParam& p, SQLULEN row)
+{
+    if (!p.ind)
+        return 0;
+    if (s->param_bind_type != SQL_PARAM_BIND_BY_COLUMN)
+        return (SQLLEN*)((char*)p.ind + row * s->param_bind_type);
+    return p.ind + row;
+}
+
+static bool IsDataAtExec(SQLLEN* ind)
+{
+    return ind && (*ind == SQL_DATA_AT_EXEC || *ind <= SQL_LEN_DATA_AT_EXEC(0));
+}
+
+static std::string NumericToString(const SQL_NUMERIC_STRUCT* p)
+{
+    // Convert the 128-bit little endian magnitude to decimal by repeated division.
+    unsigned char mag[SQL_MAX_NUMERIC_LEN];
+    memcpy(mag, p->val, sizeof(mag));
+    std::string digits;
+    for (;;)
+    {
+        bool zero = true;
+        unsigned int rem = 0;
+        for (int i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--)
+        {
+            unsigned int cur = (rem << 8) | mag[i];
+            mag[i] = (unsigned char)(cur / 10);
+            rem = cur % 10;
+            if (mag[i])
+                zero = false;
+        }
+        digits.insert(digits.begin(), (char)('0' + rem));
+        if (zero)
+            break;
+    }
+    int scale = p->scale;
+    if (scale > 0)
+    {
+        while ((int)digits.size() <= scale)
+            digits.insert(digits.begin(), '0');
+        digits.insert(digits.size() - scale, ".");
+    }
+    else if (scale < 0)
+        digits.append((size_t)-scale, '0');
+    if (p->sign == 0)
+        digits.insert(digits.begin(), '-');
+    return digits;
+}
+
+static bool ReadParam(Stmt* s, int iparam, SQLULEN row, Value& v)
+{
+    const BoundParam& p = s->params[iparam];
+    SQLLEN* ind = IndAddress(s, p, row);
+    const char* data = ParamAddress(s, p, row);
+
+    if (ind && *ind == SQL_NULL_DATA)
+    {
+        v.kind = KIND_NULL;
+        return true;
+    }
+
+    std::string dae;
+    bool is_dae = IsDataAtExec(ind);
+    if (is_dae)
+        dae = s->dae[std::make_pair(row, iparam)];
+
+    switch (p.ctype)
+    {
+    case SQL_C_CHAR:
+    case SQL_C_BINARY:
+        v.kind = (p.ctype == SQL_C_CHAR) ? KIND_TEXT : KIND_BINARY;
+        if (is_dae)
+            v.s = dae;
+        else if (!ind || *ind == SQL_NTS)
+            v.s = data;
+        else
+            v.s.assign(data, (size_t)*ind);
+        return true;
+
+    case SQL_C_WCHAR:
+        v.kind = KIND_TEXT;
+        if (is_dae)
+            v.s = Utf16ToUtf8((const SQLWCHAR*)dae.data(), dae.size() / sizeof(SQLWCHAR));
+        else if (!ind || *ind == SQL_NTS)
+        {
+            size_t cch = 0;
+            while (((const SQLWCHAR*)data)[cch])
+                cch++;
+            v.s = Utf16ToUtf8((const SQLWCHAR*)data, cch);
+        }
+        else
+            v.s = Utf16ToUtf8((const SQLWCHAR*)data, (size_t)*ind / sizeof(SQLWCHAR));
+        return true;
+
+    case SQL_C_BIT:
+    case SQL_C_UTINYINT:
+    case SQL_C_TINYINT:
+        v.kind = KIND_INT;
+        v.i = *(const unsigned char*)data;
+        return true;
+    case SQL_C_STINYINT:
+        v.kind = KIND_INT;
+        v.i = *(const signed char*)data;
+        return true;
+    case SQL_C_SHORT:
+    case SQL_C_SSHORT:
+        v.kind = KIND_INT;
+        v.i = *(const short*)data;
+        return true;
+    case SQL_C_LONG:
+    case SQL_C_SLONG:
+        v.kind = KIND_INT;
+        v.i = *(const SQLINTEGER*)data;
+        return true;
+    case SQL_C_ULONG:
+        v.kind = KIND_INT;
+        v.i = *(const SQLUINTEGER*)data;
+        return true;
+    case SQL_C_SBIGINT:
+    case SQL_C_UBIGINT:
+        v.kind = KIND_INT;
+        v.i = *(const SQLBIGINT*)data;
+        return true;
+    case SQL_C_FLOAT:
+        v.kind = KIND_DOUBLE;
+        v.d = *(const float*)data;
+        return true;
+    case SQL_C_DOUBLE:
+        v.kind = KIND_DOUBLE;
+        v.d = *(const double*)data;
+        return true;
+    case SQL_C_NUMERIC:
+        v.kind = KIND_TEXT;
+        v.s = NumericToString((const SQL_NUMERIC_STRUCT*)data);
+        return true;
+    case SQL_C_TIMESTAMP:
+    case SQL_C_TYPE_TIMESTAMP:
+        v.kind = KIND_TIMESTAMP;
+        v.ts = *(const SQL_TIMESTAMP_STRUCT*)data;
+        return true;
+    case SQL_C_TYPE_DATE:
+    {
+        const SQL_DATE_STRUCT* d = (const SQL_DATE_STRUCT*)data;
+        v.kind = KIND_TIMESTAMP;
+        v.ts.year = d->year; v.ts.month = d->month; v.ts.day = d->day;
+        return true;
+    }
+    case SQL_C_TYPE_TIME:
+    {
+        const SQL_TIME_STRUCT* t = (const SQL_TIME_STRUCT*)data;
+        v.kind = KIND_TIMESTAMP;
+        v.ts.year = 1900; v.ts.month = 1; v.ts.day = 1;
+        v.ts.hour = t->hour; v.ts.minute = t->minute; v.ts.second = t->second;
+        return true;
+    }
+    }
+    return false;
+}
+
+static Column ParamColumn(const BoundParam& p, int index)
+{
+    Column col;
+    char sz[20];
+    sprintf(sz, "p%d", index + 1);
+    col.name        = sz;
+    col.sql_type    = (p.sql_type == SQL_TIMESTAMP) ? SQL_TYPE_TIMESTAMP : p.sql_type;
+    col.size        = p.size;
+    col.length      = p.size;
+    col.digits      = p.digits;
+    col.is_unsigned = false;
+    if (col.sql_type == SQL_TYPE_TIMESTAMP)
+        col.size = 23;
+    return col;
+}
+
+//
+// Execution
+//
+
+static void CloseCursor(Stmt* s)
+{
+    s->has_results = false;
+    s->columns.clear();
+    s->rows = 0;
+    s->echo_rows.clear();
+    s->row_count = 0;
+    s->position = -1;
+    s->rowset_size = 0;
+    s->sets_left = 0;
+    s->getdata_col = -1;
+    s->getdata_offset = 0;
+    s->setpos_row = -1;
+}
+
+static SQLRETURN Run(Stmt* s)
+{
+    std::vector<std::string> words = Words(s->sql);
+    std::string verb = words.empty() ? std::string() : Lower(words[0]);
+
+    CloseCursor(s);
+    s->affected = -1;
+
+    SQLULEN nsets = (s->params.empty()) ? 1 : s->paramset_size;
+    if (s->params_processed)
+        *s->params_processed = nsets;
+    if (s->param_status)
+        for (SQLULEN i = 0; i < nsets; i++)
+            s->param_status[i] = SQL_PARAM_SUCCESS;
+
+    if (verb == "mock")
+    {
+        std::vector<std::string> specs;
+        std::string cols = Option(words, "cols", "int");
+        size_t start = 0;
+        int depth = 0;
+        for (size_t i = 0; i <= cols.size(); i++)
+        {
+            if (i < cols.size() && cols[i] == '(') depth++;
+            if (i < cols.size() && cols[i] == ')') depth--;
+            if (i == cols.size() || (cols[i] == ',' && depth == 0))
+            {
+                specs.push_back(cols.substr(start, i - start));
+                start = i + 1;
+            }
+        }
+        for (size_t i = 0; i < specs.size(); i++)
+        {
+            Column col;
+            if (!ParseColumn(Lower(specs[i]), (int)i, col))
+                return Fail(s, "42000", "Unknown column type");
+            s->columns.push_back(col);
+        }
+
+        std::string text = Option(words, "text", "ascii");
+        s->gen.rows    = atol(Option(words, "rows", "1").c_str());
+        s->gen.nulls   = atol(Option(words, "nulls", "0").c_str());
+        s->gen.sets    = atoi(Option(words, "sets", "1").c_str());
+        s->gen.nototal = Flag(words, "nototal");
+        s->gen.overflow = atol(Option(words, "overflow", "0").c_str());
+        s->gen.pad     = (text == "latin1") ? 0xE9 : (text == "bmp") ? 0x20AC : (text == "astral") ? 0x1F600 : 'x';
+        s->has_results = true;
+        s->row_count   = s->gen.rows;
+        s->sets_left   = s->gen.sets - 1;
+        return SQL_SUCCESS;
+    }
+
+    if (verb == "sleep")
+    {
+        long ms = (words.size() > 1) ? atol(words[1].c_str()) : 0;
+        if (words.size() > 1 && words[1] == "?" && !s->params.empty())
+        {
+            Value v;
+            if (!ReadParam(s, 0, 0, v))
+                return Fail(s, "HY003", "Invalid application buffer type");
+            ms = (long)v.i;
+        }
+        s->cancelled = false;
+        for (long i = 0; i < ms && !s->cancelled; i += 5)
+        {
+            if (s->query_timeout != 0 && i >= (long)s->query_timeout * 1000)
+                return Fail(s, "HYT00", "Query timeout expired");
+            usleep(5000);
+        }
+        if (s->cancelled)
+            return Fail(s, "HY008", "Operation canceled");
+        s->affected = 0;
+        return SQL_SUCCESS;
+    }
+
+    if (verb == "fail")
+    {
+        std::string state = (words.size() > 1 && words[1].find('=') == std::string::npos) ? words[1] : "42000";
+        std::string row = Option(words, "row", "");
+        if (row.empty())
+            return Fail(s, state.c_str(), "Failed as requested");
+
+        SQLULEN bad = (SQLULEN)atol(row.c_str());
+        if (s->param_status && bad < nsets)
+            s->param_status[bad] = SQL_PARAM_ERROR;
+        s->affected = (SQLLEN)((bad < nsets) ? nsets - 1 : nsets);
+        if (bad >= nsets)
+            return SQL_SUCCESS;
+        SetDiag(s->diag, state.c_str(), "Failed as requested");
+        return (nsets == 1) ? SQL_ERROR : SQL_SUCCESS_WITH_INFO;
+    }
+
+    if (verb != "echo" && verb != "insert" && verb != "select" && verb != "delete")
+    {
+        s->affected = (SQLLEN)(s->params.empty() ? 0 : nsets);
+        return SQL_SUCCESS;
+    }
+
+    std::vector<std::vector<Value> > paramrows;
+    for (SQLULEN row = 0; row < nsets && !s->params.empty(); row++)
+    {
+        std::vector<Value> values(s->params.size());
+        for (size_t i = 0; i < s->params.size(); i++)
+            if (!ReadParam(s, (int)i, row, values[i]))
+                return Fail(s, "HY003", "Invalid application buffer type");
+        paramrows.push_back(values);
+    }
+
+    std::string name = (words.size() > 1) ? Lower(words[1]) : std::string();
+    size_t paren = name.find('(');
+    if (paren != std::string::npos)
+        name.resize(paren);
+
+    if (verb == "echo" || verb == "select")
+    {
+        if (verb == "echo")
+        {
+            for (size_t i = 0; i < s->params.size(); i++)
+                s->columns.push_back(ParamColumn(s->params[i], (int)i));
+            s->echo_rows = paramrows;
+            s->rows = &s->echo_rows;
+        }
+        else
+        {
+            pthread_mutex_lock(&lock);
+            Table& t = tables[name];
+            s->columns = t.columns;
+            s->echo_rows = t.rows;
+            pthread_mutex_unlock(&lock);
+            s->rows = &s->echo_rows;
+        }
+        s->has_results = true;
+        s->row_count = (long)s->rows->size();
+        return SQL_SUCCESS;
+    }
+
+    if (verb == "insert")
+    {
+        pthread_mutex_lock(&lock);
+        Table& t = tables[name];
+        if (t.columns.empty())
+            for (size_t i = 0; i < s->params.size(); i++)
+                t.columns.push_back(ParamColumn(s->params[i], (int)i));
+        for (size_t i = 0; i < paramrows.size(); i++)
+            t.rows.push_back(paramrows[i]);
+        pthread_mutex_unlock(&lock);
+        s->affected = (SQLLEN)paramrows.size();
+        return SQL_SUCCESS;
+    }
+
+    if (verb == "delete")
+    {
+        pthread_mutex_lock(&lock);
+        tables.erase(name);
+        pthread_mutex_unlock(&lock);
+        s->affected = 0;
+        return SQL_SUCCESS;
+    }
+
+    return SQL_SUCCESS;
+}
+
+// Called after SQLExecute/SQLExecDirect to find data-at-execution parameters before running the statement.
+
+static SQLRETURN Execute(Stmt* s)
+{
+    s->need_data.clear();
+    s->need_index = 0;
+    s->dae.clear();
+
+    SQLULEN nsets = (s->params.empty()) ? 1 : s->paramset_size;
+    for (SQLULEN row = 0; row < nsets; row++)
+        for (size_t i = 0; i < s->params.size(); i++)
+            if (IsDataAtExec(IndAddress(s, s->params[i], row)))
+                s->need_data.push_back(std::make_pair(row, (int)i));
+
+    if (!s->need_data.empty())
+        return SQL_NEED_DATA;
+
+    return Run(s);
+}
+
+static SQLSMALLINT CountParams(const std::string& sql)
+{
+    SQLSMALLINT count = 0;
+    for (size_t i = 0; i < sql.size(); i++)
+        if (sql[i] == '?')
+            count++;
+    return count;
+}
+
+//
+// The ODBC API
+//
+
+extern "C" {
+
+SQLRETURN SQLAllocHandle(SQLSMALLINT type, SQLHANDLE input, SQLHANDLE* output)
+{
+    switch (type)
+    {
+    case SQL_HANDLE_ENV:
+        *output = new Env();
+        return SQL_SUCCESS;
+    case SQL_HANDLE_DBC:
+    {
+        Dbc* dbc = new Dbc();
+        dbc->connected = false;
+        dbc->autocommit = SQL_AUTOCOMMIT_ON;
+        *output = dbc;
+        return SQL_SUCCESS;
+    }
+    case SQL_HANDLE_STMT:
+    {
+        Count(CALL_ALLOCSTMT);
+        Stmt* s = new Stmt();
+        s->dbc = (Dbc*)input;
+        s->prepared = false;
+        s->cancelled = false;
+        s->rows = 0;
+        s->row_array_size = 1;
+        s->row_bind_type = SQL_BIND_BY_COLUMN;
+        s->rows_fetched = 0;
+        s->row_status = 0;
+        s->bind_offset = 0;
+        s->paramset_size = 1;
+        s->param_bind_type = SQL_PARAM_BIND_BY_COLUMN;
+        s->param_status = 0;
+        s->params_processed = 0;
+        s->need_index = 0;
+        s->query_timeout = 0;
+        s->noscan = SQL_NOSCAN_OFF;
+        s->affected = -1;
+        memset(&s->gen, 0, sizeof(s->gen));
+        CloseCursor(s);
+        *output = s;
+        return SQL_SUCCESS;
+    }
+    }
+    return SQL_ERROR;
+}
+
+SQLRETURN SQLFreeHandle(SQLSMALLINT type, SQLHANDLE h)
+{
+    switch (type)
+    {
+    case SQL_HANDLE_ENV:  delete (Env*)h;  break;
+    case SQL_HANDLE_DBC:  delete (Dbc*)h;  break;
+    case SQL_HANDLE_STMT: delete (Stmt*)h; break;
+    default:
+        return SQL_ERROR;
+    }
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLSetEnvAttr(SQLHENV, SQLINTEGER, SQLPOINTER, SQLINTEGER)
+{
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLDataSources(SQLHENV, SQLUSMALLINT, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*)
+{
+    return SQL_NO_DATA;
+}
+
+static SQLRETURN Connect(Dbc* dbc, const std::string& cs)
+{
+    Count(CALL_CONNECT);
+    if (Lower(cs).find("fail=1") != std::string::npos)
+    {
+        SetDiag(dbc->diag, "08001", "Unable to connect");
+        return SQL_ERROR;
+    }
+    dbc->connected = true;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLDriverConnect(SQLHDBC hdbc, SQLHWND, SQLCHAR* in, SQLSMALLINT cchIn, SQLCHAR*, SQLSMALLINT, SQLSMALLINT*,
+                           SQLUSMALLINT)
+{
+    std::string cs = (cchIn == SQL_NTS) ? std::string((const char*)in) : std::string((const char*)in, (size_t)cchIn);
+    return Connect((Dbc*)hdbc, cs);
+}
+
+SQLRETURN SQLDriverConnectW(SQLHDBC hdbc, SQLHWND, SQLWCHAR* in, SQLSMALLINT cchIn, SQLWCHAR*, SQLSMALLINT,
+                            SQLSMALLINT*, SQLUSMALLINT)
+{
+    size_t cch = (size_t)cchIn;
+    if (cchIn == SQL_NTS)
+        for (cch = 0; in[cch]; cch++)
+            ;
+    return Connect((Dbc*)hdbc, Utf16ToUtf8(in, cch));
+}
+
+SQLRETURN SQLDisconnect(SQLHDBC hdbc)
+{
+    Count(CALL_DISCONNECT);
+    ((Dbc*)hdbc)->connected = false;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLEndTran(SQLSMALLINT, SQLHANDLE, SQLSMALLINT)
+{
+    Count(CALL_ENDTRAN);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLSetConnectAttr(SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER)
+{
+    if (attr == SQL_ATTR_AUTOCOMMIT)
+        ((Dbc*)hdbc)->autocommit = (SQLULEN)value;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetConnectAttr(SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER, SQLINTEGER*)
+{
+    if (attr == SQL_ATTR_AUTOCOMMIT)
+    {
+        *(SQLUINTEGER*)value = (SQLUINTEGER)((Dbc*)hdbc)->autocommit;
+        return SQL_SUCCESS;
+    }
+    if (attr == SQL_ATTR_CONNECTION_DEAD)
+    {
+        *(SQLUINTEGER*)value = connections_dead ? 1 : 0;
+        return SQL_SUCCESS;
+    }
+    return SQL_ERROR;
+}
+
+SQLRETURN SQLGetInfo(SQLHDBC hdbc, SQLUSMALLINT type, SQLPOINTER value, SQLSMALLINT cbValue, SQLSMALLINT* pcb)
+{
+    const char* sz = 0;
+    switch (type)
+    {
+    case SQL_DRIVER_ODBC_VER:       sz = "03.52";   break;
+    case SQL_ODBC_VER:              sz = "03.52";   break;
+    case SQL_DRIVER_VER:            sz = "01.00.0000"; break;
+    case SQL_DESCRIBE_PARAMETER:    sz = "Y";       break;
+    case SQL_SEARCH_PATTERN_ESCAPE: sz = "\\";      break;
+    case SQL_DRIVER_NAME:           sz = "libmockodbc.so"; break;
+    case SQL_DBMS_NAME:             sz = "mock";    break;
+    case SQL_DBMS_VER:              sz = "01.00.0000"; break;
+    default:
+        SetDiag(((Dbc*)hdbc)->diag, "HY096", "Information type out of range");
+        return SQL_ERROR;
+    }
+    size_t len = strlen(sz);
+    if (value && cbValue > 0)
+    {
+        size_t n = (len < (size_t)cbValue - 1) ? len : (size_t)cbValue - 1;
+        memcpy(value, sz, n);
+        ((char*)value)[n] = 0;
+    }
+    if (pcb)
+        *pcb = (SQLSMALLINT)len;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetTypeInfo(SQLHSTMT hstmt, SQLSMALLINT type)
+{
+    Stmt* s = (Stmt*)hstmt;
+    CloseCursor(s);
+
+    static const char* const names[] = { "TYPE_NAME", "DATA_TYPE", "COLUMN_SIZE" };
+    static const SQLSMALLINT types[] = { SQL_VARCHAR, SQL_SMALLINT, SQL_INTEGER };
+    for (int i = 0; i < 3; i++)
+    {
+        Column col;
+        col.name = names[i];
+        col.sql_type = types[i];
+        col.size = col.length = (i == 0) ? 128 : 10;
+        col.digits = 0;
+        col.is_unsigned = false;
+        s->columns.push_back(col);
+    }
+
+    SQLINTEGER size = 0;
+    switch (type)
+    {
+    case SQL_TYPE_TIMESTAMP: size = 23;   break;
+    case SQL_VARCHAR:        size = 8000; break;
+    case SQL_WVARCHAR:       size = 4000; break;
+    case SQL_BINARY:         size = 8000; break;
+    }
+
+    std::vector<Value> row(3);
+    row[0].kind = KIND_TEXT;
+    row[0].s = "mocktype";
+    row[1].kind = KIND_INT;
+    row[1].i = type;
+    row[2].kind = KIND_INT;
+    row[2].i = size;
+    if (size)
+        s->echo_rows.push_back(row);
+
+    s->rows = &s->echo_rows;
+    s->row_count = (long)s->echo_rows.size();
+    s->has_results = true;
+    return SQL_SUCCESS;
+}
+
+static SQLRETURN EmptyResult(SQLHSTMT hstmt, int ncols)
+{
+    Stmt* s = (Stmt*)hstmt;
+    CloseCursor(s);
+    for (int i = 0; i < ncols; i++)
+    {
+        Column col;
+        ParseColumn("varchar(128)", i, col);
+        s->columns.push_back(col);
+    }
+    s->rows = &s->echo_rows;
+    s->has_results = true;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLTables(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT)
+{
+    return EmptyResult(h, 5);
+}
+
+SQLRETURN SQLColumns(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT)
+{
+    return EmptyResult(h, 18);
+}
+
+SQLRETURN SQLStatistics(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLUSMALLINT,
+                        SQLUSMALLINT)
+{
+    return EmptyResult(h, 13);
+}
+
+SQLRETURN SQLSpecialColumns(SQLHSTMT h, SQLUSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT,
+                            SQLUSMALLINT, SQLUSMALLINT)
+{
+    return EmptyResult(h, 8);
+}
+
+SQLRETURN SQLPrimaryKeys(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT)
+{
+    return EmptyResult(h, 6);
+}
+
+SQLRETURN SQLForeignKeys(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*,
+                         SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT)
+{
+    return EmptyResult(h, 14);
+}
+
+SQLRETURN SQLProcedures(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT)
+{
+    return EmptyResult(h, 8);
+}
+
+SQLRETURN SQLProcedureColumns(SQLHSTMT h, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*, SQLSMALLINT, SQLCHAR*,
+                              SQLSMALLINT)
+{
+    return EmptyResult(h, 19);
+}
+
+SQLRETURN SQLSetStmtAttr(SQLHSTMT hstmt, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER)
+{
+    Stmt* s = (Stmt*)hstmt;
+    switch (attr)
+    {
+    case SQL_ATTR_ROW_ARRAY_SIZE:      s->row_array_size   = (SQLULEN)value; break;
+    case SQL_ATTR_ROW_BIND_TYPE:       s->row_bind_type    = (SQLULEN)value; break;
+    case SQL_ATTR_ROWS_FETCHED_PTR:    s->rows_fetched     = (SQLULEN*)value; break;
+    case SQL_ATTR_ROW_STATUS_PTR:      s->row_status       = (SQLUSMALLINT*)value; break;
+    case SQL_ATTR_ROW_BIND_OFFSET_PTR: s->bind_offset      = (SQLLEN*)value; break;
+    case SQL_ATTR_PARAMSET_SIZE:       s->paramset_size    = (SQLULEN)value; break;
+    case SQL_ATTR_PARAM_BIND_TYPE:     s->param_bind_type  = (SQLULEN)value; break;
+    case SQL_ATTR_PARAM_STATUS_PTR:    s->param_status     = (SQLUSMALLINT*)value; break;
+    case SQL_ATTR_PARAMS_PROCESSED_PTR: s->params_processed = (SQLULEN*)value; break;
+    case SQL_ATTR_QUERY_TIMEOUT:       s->query_timeout    = (SQLULEN)value; break;
+    case SQL_ATTR_NOSCAN:              s->noscan           = (SQLULEN)value; break;
+    }
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetStmtAttr(SQLHSTMT hstmt, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER, SQLINTEGER*)
+{
+    Stmt* s = (Stmt*)hstmt;
+    switch (attr)
+    {
+    case SQL_ATTR_ROW_ARRAY_SIZE: *(SQLULEN*)value = s->row_array_size; break;
+    case SQL_ATTR_PARAMSET_SIZE:  *(SQLULEN*)value = s->paramset_size;  break;
+    case SQL_ATTR_QUERY_TIMEOUT:  *(SQLULEN*)value = s->query_timeout;  break;
+    case SQL_ATTR_NOSCAN:         *(SQLUINTEGER*)value = (SQLUINTEGER)s->noscan; break;
+    default:
+        return Fail(s, "HY092", "Invalid attribute identifier");
+    }
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLPrepare(SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER cch)
+{
+    Count(CALL_PREPARE);
+    Stmt* s = (Stmt*)hstmt;
+    s->sql = (cch == SQL_NTS) ? std::string((const char*)sql) : std::string((const char*)sql, (size_t)cch);
+    s->prepared = true;
+    CloseCursor(s);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLPrepareW(SQLHSTMT hstmt, SQLWCHAR* sql, SQLINTEGER cch)
+{
+    Count(CALL_PREPARE);
+    Stmt* s = (Stmt*)hstmt;
+    size_t n = (size_t)cch;
+    if (cch == SQL_NTS)
+        for (n = 0; sql[n]; n++)
+            ;
+    s->sql = Utf16ToUtf8(sql, n);
+    s->prepared = true;
+    CloseCursor(s);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLExecute(SQLHSTMT hstmt)
+{
+    Count(CALL_EXECUTE);
+    Stmt* s = (Stmt*)hstmt;
+    if (!s->prepared)
+        return Fail(s, "HY010", "Function sequence error");
+    return Execute(s);
+}
+
+SQLRETURN SQLExecDirect(SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER cch)
+{
+    Count(CALL_EXECDIRECT);
+    Stmt* s = (Stmt*)hstmt;
+    s->sql = (cch == SQL_NTS) ? std::string((const char*)sql) : std::string((const char*)sql, (size_t)cch);
+    s->prepared = false;
+    return Execute(s);
+}
+
+SQLRETURN SQLExecDirectW(SQLHSTMT hstmt, SQLWCHAR* sql, SQLINTEGER cch)
+{
+    Count(CALL_EXECDIRECT);
+    Stmt* s = (Stmt*)hstmt;
+    size_t n = (size_t)cch;
+    if (cch == SQL_NTS)
+        for (n = 0; sql[n]; n++)
+            ;
+    s->sql = Utf16ToUtf8(sql, n);
+    s->prepared = false;
+    return Execute(s);
+}
+
+SQLRETURN SQLParamData(SQLHSTMT hstmt, SQLPOINTER* value)
+{
+    Stmt* s = (Stmt*)hstmt;
+    if (s->need_index < s->need_data.size())
+    {
+        std::pair<SQLULEN, int> next = s->need_data[s->need_index++];
+        *value = ParamAddress(s, s->params[next.second], next.first);
+        return SQL_NEED_DATA;
+    }
+    if (s->need_data.empty())
+        return Fail(s, "HY010", "Function sequence error");
+    s->need_data.clear();
+    return Run(s);
+}
+
+SQLRETURN SQLPutData(SQLHSTMT hstmt, SQLPOINTER data, SQLLEN cb)
+{
+    Count(CALL_PUTDATA);
+    Stmt* s = (Stmt*)hstmt;
+    if (s->need_index == 0)
+        return Fail(s, "HY010", "Function sequence error");
+    std::pair<SQLULEN, int> cur = s->need_data[s->need_index - 1];
+    if (cb == SQL_NULL_DATA)
+        return SQL_SUCCESS;
+    if (cb == SQL_NTS)
+        cb = (SQLLEN)strlen((const char*)data);
+    s->dae[cur].append((const char*)data, (size_t)cb);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLNumParams(SQLHSTMT hstmt, SQLSMALLINT* count)
+{
+    *count = CountParams(((Stmt*)hstmt)->sql);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLDescribeParam(SQLHSTMT, SQLUSMALLINT, SQLSMALLINT* type, SQLULEN* size, SQLSMALLINT* digits,
+                           SQLSMALLINT* nullable)
+{
+    if (type)     *type = SQL_VARCHAR;
+    if (size)     *size = 255;
+    if (digits)   *digits = 0;
+    if (nullable) *nullable = SQL_NULLABLE;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLBindParameter(SQLHSTMT hstmt, SQLUSMALLINT ipar, SQLSMALLINT io, SQLSMALLINT ctype, SQLSMALLINT sql_type,
+                           SQLULEN size, SQLSMALLINT digits, SQLPOINTER ptr, SQLLEN buflen, SQLLEN* ind)
+{
+    Count(CALL_BINDPARAMETER);
+    Stmt* s = (Stmt*)hstmt;
+    if (ipar == 0 || io != SQL_PARAM_INPUT)
+        return Fail(s, "HY105", "Invalid parameter type");
+    if (s->params.size() < ipar)
+        s->params.resize(ipar);
+    BoundParam& p = s->params[ipar - 1];
+    p.ctype    = ctype;
+    p.sql_type = sql_type;
+    p.size     = size;
+    p.digits   = digits;
+    p.ptr      = ptr;
+    p.buflen   = buflen;
+    p.ind      = ind;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLNumResultCols(SQLHSTMT hstmt, SQLSMALLINT* count)
+{
+    Count(CALL_NUMRESULTCOLS);
+    Stmt* s = (Stmt*)hstmt;
+    if (s->prepared && !s->has_results && s->affected == -1)
+    {
+        // Prepared but not yet executed.  Real drivers can describe the statement here; we run it to find out.
+        std::vector<std::string> words = Words(s->sql);
+        if (!words.empty() && Lower(words[0]) == "mock")
+        {
+            SQLRETURN ret = Run(s);
+            if (!SQL_SUCCEEDED(ret))
+                return ret;
+            s->affected = 0;
+        }
+    }
+    *count = (SQLSMALLINT)s->columns.size();
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLRowCount(SQLHSTMT hstmt, SQLLEN* count)
+{
+    *count = ((Stmt*)hstmt)->affected;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLDescribeCol(SQLHSTMT hstmt, SQLUSMALLINT icol, SQLCHAR* name, SQLSMALLINT cbName, SQLSMALLINT* pcbName,
+                         SQLSMALLINT* type, SQLULEN* size, SQLSMALLINT* digits, SQLSMALLINT* nullable)
+{
+    Count(CALL_DESCRIBECOL);
+    Stmt* s = (Stmt*)hstmt;
+    if (icol == 0 || icol > s->columns.size())
+        return Fail(s, "07009", "Invalid descriptor index");
+    const Column& col = s->columns[icol - 1];
+    if (name && cbName > 0)
+    {
+        size_t n = col.name.size() < (size_t)cbName - 1 ? col.name.size() : (size_t)cbName - 1;
+        memcpy(name, col.name.data(), n);
+        name[n] = 0;
+    }
+    if (pcbName)  *pcbName = (SQLSMALLINT)col.name.size();
+    if (type)     *type = col.sql_type;
+    if (size)     *size = col.size;
+    if (digits)   *digits = col.digits;
+    if (nullable) *nullable = SQL_NULLABLE;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLColAttribute(SQLHSTMT hstmt, SQLUSMALLINT icol, SQLUSMALLINT field, SQLPOINTER, SQLSMALLINT, SQLSMALLINT*,
+                          SQLLEN* numeric)
+{
+    Count(CALL_COLATTRIBUTE);
+    Stmt* s = (Stmt*)hstmt;
+    if (icol == 0 || icol > s->columns.size())
+        return Fail(s, "07009", "Invalid descriptor index");
+    const Column& col = s->columns[icol - 1];
+    switch (field)
+    {
+    case SQL_DESC_UNSIGNED:
+        *numeric = col.is_unsigned ? SQL_TRUE : SQL_FALSE;
+        return SQL_SUCCESS;
+    case SQL_DESC_DISPLAY_SIZE:
+    case SQL_DESC_LENGTH:
+    case SQL_DESC_OCTET_LENGTH:
+        *numeric = (SQLLEN)col.size;
+        return SQL_SUCCESS;
+    }
+    return Fail(s, "HY091", "Invalid descriptor field identifier");
+}
+
+SQLRETURN SQLColAttributeW(SQLHSTMT hstmt, SQLUSMALLINT icol, SQLUSMALLINT field, SQLPOINTER p, SQLSMALLINT cb,
+                           SQLSMALLINT* pcb, SQLLEN* numeric)
+{
+    return SQLColAttribute(hstmt, icol, field, p, cb, pcb, numeric);
+}
+
+SQLRETURN SQLBindCol(SQLHSTMT hstmt, SQLUSMALLINT icol, SQLSMALLINT ctype, SQLPOINTER ptr, SQLLEN buflen, SQLLEN* ind)
+{
+    Count(CALL_BINDCOL);
+    Stmt* s = (Stmt*)hstmt;
+    if (icol == 0)
+        return Fail(s, "07009", "Bookmarks are not supported");
+    if (s->bound.size() < icol)
+        s->bound.resize(icol);
+    BoundCol& b = s->bound[icol - 1];
+    b.ctype  = ctype;
+    b.ptr    = ptr;
+    b.buflen = buflen;
+    b.ind    = ind;
+    return SQL_SUCCESS;
+}
+
+static SQLRETURN Fetch(Stmt* s)
+{
+    Count(CALL_FETCH);
+    if (!s->has_results)
+        return Fail(s, "24000", "Invalid cursor state");
+
+    s->getdata_col = -1;
+    s->getdata_offset = 0;
+    s->setpos_row = -1;
+
+    long start = (s->position < 0) ? 0 : s->position + s->rowset_size;
+    if (start >= s->row_count)
+    {
+        s->position = s->row_count;
+        s->rowset_size = 0;
+        if (s->rows_fetched)
+            *s->rows_fetched = 0;
+        return SQL_NO_DATA;
+    }
+
+    long count = s->row_count - start;
+    if ((SQLULEN)count > s->row_array_size)
+        count = (long)s->row_array_size;
+
+    s->position = start;
+    s->rowset_size = count;
+
+    SQLRETURN ret = SQL_SUCCESS;
+    for (long r = 0; r < count; r++)
+    {
+        for (size_t icol = 0; icol < s->bound.size() && icol < s->columns.size(); icol++)
+        {
+            BoundCol b = s->bound[icol];
+            if (!b.ptr && !b.ind)
+                continue;
+            if (s->bind_offset)
+            {
+                if (b.ptr)
+                    b.ptr = (char*)b.ptr + *s->bind_offset;
+                if (b.ind)
+                    b.ind = (SQLLEN*)((char*)b.ind + *s->bind_offset);
+            }
+
+            SQLLEN stride = (s->row_bind_type != SQL_BIND_BY_COLUMN) ? (SQLLEN)s->row_bind_type
+                          : (FixedSize(b.ctype) ? FixedSize(b.ctype) : b.buflen);
+            SQLLEN* ind = !b.ind ? 0 : (s->row_bind_type != SQL_BIND_BY_COLUMN)
+                        ? (SQLLEN*)((char*)b.ind + r * s->row_bind_type) : b.ind + r;
+
+            Value v;
+            GetCell(s, start + r, (int)icol, v);
+            size_t offset = 0;
+            SQLRETURN r2 = WriteValue(s, v, b.ctype, b.ptr ? (char*)b.ptr + r * stride : 0, b.buflen, ind, offset,
+                                      s->columns[icol].sql_type);
+            if (r2 == SQL_ERROR)
+                return r2;
+            if (r2 == SQL_SUCCESS_WITH_INFO)
+                ret = r2;
+        }
+        if (s->row_status)
+            s->row_status[r] = SQL_ROW_SUCCESS;
+    }
+
+    for (SQLULEN r = (SQLULEN)count; s->row_status && r < s->row_array_size; r++)
+        s->row_status[r] = SQL_ROW_NOROW;
+
+    if (s->rows_fetched)
+        *s->rows_fetched = (SQLULEN)count;
+
+    return ret;
+}
+
+SQLRETURN SQLFetch(SQLHSTMT hstmt)
+{
+    return Fetch((Stmt*)hstmt);
+}
+
+SQLRETURN SQLFetchScroll(SQLHSTMT hstmt, SQLSMALLINT orientation, SQLLEN)
+{
+    Stmt* s = (Stmt*)hstmt;
+    if (orientation != SQL_FETCH_NEXT)
+        return Fail(s, "HY106", "Fetch type out of range");
+    return Fetch(s);
+}
+
+SQLRETURN SQLGetData(SQLHSTMT hstmt, SQLUSMALLINT icol, SQLSMALLINT ctype, SQLPOINTER ptr, SQLLEN buflen, SQLLEN* ind)
+{
+    Count(CALL_GETDATA);
+    Stmt* s = (Stmt*)hstmt;
+    if (s->position < 0 || s->position >= s->row_count)
+        return Fail(s, "24000", "Invalid cursor state");
+    if (s->row_array_size != 1 && s->setpos_row < 0)
+        return Fail(s, "HY109", "SQLSetPos must select a row before SQLGetData is used with block cursors");
+    if (icol == 0 || icol > s->columns.size())
+        return Fail(s, "07009", "Invalid descriptor index");
+
+    if (s->getdata_col != icol - 1)
+    {
+        s->getdata_col = icol - 1;
+        s->getdata_offset = 0;
+    }
+
+    // The ODBC spec requires the SQL type codes for integers (as cnxninfo passes) to be interpreted as C types.
+    if (ctype == SQL_INTEGER)
+        ctype = SQL_C_LONG;
+
+    Value v;
+    GetCell(s, s->position + (s->setpos_row < 0 ? 0 : s->setpos_row), icol - 1, v);
+    if (v.kind == KIND_NULL && s->getdata_offset > 0)
+        return SQL_NO_DATA;
+    if (v.kind == KIND_NULL)
+        s->getdata_offset = 1;
+    return WriteValue(s, v, ctype, ptr, buflen, ind, s->getdata_offset, s->columns[icol - 1].sql_type);
+}
+
+SQLRETURN SQLSetPos(SQLHSTMT hstmt, SQLSETPOSIROW irow, SQLUSMALLINT op, SQLUSMALLINT)
+{
+    Count(CALL_SETPOS);
+    Stmt* s = (Stmt*)hstmt;
+    if (op != SQL_POSITION)
+        return Fail(s, "HYC00", "Only SQL_POSITION is supported");
+    if (s->position < 0 || s->position >= s->row_count)
+        return Fail(s, "24000", "Invalid cursor state");
+    if (irow < 1 || (long)irow > s->rowset_size)
+        return Fail(s, "HY107", "Row value out of range");
+
+    s->setpos_row = (long)irow - 1;
+    s->getdata_col = -1;
+    s->getdata_offset = 0;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLMoreResults(SQLHSTMT hstmt)
+{
+    Stmt* s = (Stmt*)hstmt;
+    if (!s->has_results || s->sets_left <= 0)
+    {
+        CloseCursor(s);
+        return SQL_NO_DATA;
+    }
+    s->sets_left--;
+    s->position = -1;
+    s->rowset_size = 0;
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLFreeStmt(SQLHSTMT hstmt, SQLUSMALLINT option)
+{
+    Stmt* s = (Stmt*)hstmt;
+    switch (option)
+    {
+    case SQL_CLOSE:
+        CloseCursor(s);
+        break;
+    case SQL_UNBIND:
+        s->bound.clear();
+        break;
+    case SQL_RESET_PARAMS:
+        s->params.clear();
+        break;
+    case SQL_DROP:
+        delete s;
+        break;
+    }
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLCloseCursor(SQLHSTMT hstmt)
+{
+    CloseCursor((Stmt*)hstmt);
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLCancel(SQLHSTMT hstmt)
+{
+    Stmt* s = (Stmt*)hstmt;
+    s->cancelled = true;
+
+    // Cancelling while data-at-execution parameters are being sent returns the statement to its prepared state.
+    s->need_data.clear();
+    s->need_index = 0;
+    s->dae.clear();
+    return SQL_SUCCESS;
+}
+
+static Diag* GetDiag(SQLSMALLINT type, SQLHANDLE h)
+{
+    switch (type)
+    {
+    case SQL_HANDLE_ENV:  return &((Env*)h)->diag;
+    case SQL_HANDLE_DBC:  return &((Dbc*)h)->diag;
+    case SQL_HANDLE_STMT: return &((Stmt*)h)->diag;
+    }
+    return 0;
+}
+
+SQLRETURN SQLGetDiagRec(SQLSMALLINT type, SQLHANDLE h, SQLSMALLINT rec, SQLCHAR* state, SQLINTEGER* native,
+                        SQLCHAR* msg, SQLSMALLINT cbMsg, SQLSMALLINT* pcbMsg)
+{
+    Diag* d = GetDiag(type, h);
+    if (!d || !d->set || rec != 1)
+        return SQL_NO_DATA;
+    if (state)
+        memcpy(state, d->state, 6);
+    if (native)
+        *native = 0;
+    std::string text = "[mock] " + d->message;
+    if (msg && cbMsg > 0)
+    {
+        size_t n = text.size() < (size_t)cbMsg - 1 ? text.size() : (size_t)cbMsg - 1;
+        memcpy(msg, text.data(), n);
+        msg[n] = 0;
+    }
+    if (pcbMsg)
+        *pcbMsg = (SQLSMALLINT)text.size();
+    return SQL_SUCCESS;
+}
+
+SQLRETURN SQLGetDiagRecW(SQLSMALLINT type, SQLHANDLE h, SQLSMALLINT rec, SQLWCHAR* state, SQLINTEGER* native,
+                         SQLWCHAR* msg, SQLSMALLINT cchMsg, SQLSMALLINT* pcchMsg)
+{
+    SQLCHAR szState[6];
+    SQLCHAR szMsg[1024];
+    SQLSMALLINT cch = 0;
+    SQLRETURN ret = SQLGetDiagRec(type, h, rec, szState, native, szMsg, sizeof(szMsg), &cch);
+    if (!SQL_SUCCEEDED(ret))
+        return ret;
+    if (state)
+        for (int i = 0; i < 6; i++)
+            state[i] = szState[i];
+    if (msg && cchMsg > 0)
+    {
+        int n = (cch < cchMsg - 1) ? cch : cchMsg - 1;
+        for (int i = 0; i < n; i++)
+            msg[i] = szMsg[i];
+        msg[n] = 0;
+    }
+    if (pcchMsg)
+        *pcchMsg = cch;
+    return SQL_SUCCESS;
+}
+
+}